@@ -0,0 +1,102 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file bench_common.hpp
+*
+* @brief Parameter sweeps and cached DLR bases shared by benchmarks
+*/
+
+#pragma once
+#include <benchmark/benchmark.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+
+#include <cmath>
+#include <map>
+#include <utility>
+
+namespace cppdlr::bench {
+
+  /**
+  * @brief DLR basis for given parameters
+  */
+  struct basis {
+    double lambda;              ///< DLR cutoff
+    double eps;                 ///< DLR tolerance
+    nda::vector<double> dlr_rf; ///< DLR frequencies
+    imtime_ops itops;           ///< DLR imaginary time object
+    imfreq_ops ifops;           ///< DLR imaginary frequency object (fermionic)
+  };
+
+  /**
+  * @brief Get DLR basis for lambda = 10^state.range(0) and eps =
+  * 10^(-state.range(1)), building it on first use
+  *
+  * Bases are cached across benchmarks, so that construction cost is not
+  * included in the timings of operations.
+  */
+  inline basis const &get_basis(benchmark::State const &state) {
+
+    static std::map<std::pair<long, long>, basis> cache;
+
+    auto key = std::pair{state.range(0), state.range(1)};
+    auto it  = cache.find(key);
+    if (it == cache.end()) {
+      double lambda = std::pow(10.0, key.first);
+      double eps    = std::pow(10.0, -key.second);
+      auto dlr_rf   = build_dlr_rf(lambda, eps);
+      it            = cache.emplace(key, basis{lambda, eps, dlr_rf, imtime_ops(lambda, dlr_rf), imfreq_ops(lambda, dlr_rf, Fermion)}).first;
+    }
+
+    return it->second;
+  }
+
+  /**
+  * @brief Random matrix-valued Green's function of shape (r, norb, norb)
+  */
+  template <nda::Scalar S> nda::array<S, 3> random_gf(int r, int norb) {
+    auto shape = std::array<long, 3>{r, norb, norb};
+    if constexpr (nda::is_complex_v<S>) {
+      return nda::rand<double>(shape) + 1i * nda::rand<double>(shape);
+    } else {
+      return nda::rand<double>(shape);
+    }
+  }
+
+  /**
+  * @brief Record DLR rank and problem size in benchmark output
+  */
+  inline void set_counters(benchmark::State &state, int r, int norb = 1) {
+    state.counters["rank"] = r;
+    state.counters["norb"] = norb;
+  }
+
+  /**
+  * @brief Sweep over log10(lambda) and -log10(eps)
+  */
+  inline void sweep_lambda_eps(benchmark::internal::Benchmark *b) {
+    b->ArgsProduct({{1, 2, 3, 4, 5, 6}, {6, 10, 14}})->ArgNames({"log10_lambda", "neg_log10_eps"});
+  }
+
+  /**
+  * @brief Sweep over log10(lambda), -log10(eps) and number of orbitals
+  */
+  inline void sweep_lambda_eps_norb(benchmark::internal::Benchmark *b) {
+    b->ArgsProduct({{1, 2, 3, 4, 5, 6}, {6, 10, 14}, {1, 4, 16}})->ArgNames({"log10_lambda", "neg_log10_eps", "norb"});
+  }
+
+} // namespace cppdlr::bench
@@ -0,0 +1,74 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_build.cpp
+*
+* @brief Benchmarks for construction of DLR frequencies and DLR grids
+*/
+
+#include "bench_common.hpp"
+
+using namespace cppdlr;
+using namespace cppdlr::bench;
+
+/**
+* @brief Selection of DLR frequencies
+*/
+static void BM_build_dlr_rf(benchmark::State &state) {
+
+  double lambda = std::pow(10.0, state.range(0));
+  double eps    = std::pow(10.0, -state.range(1));
+
+  int r = 0;
+  for (auto _ : state) {
+    auto dlr_rf = build_dlr_rf(lambda, eps);
+    r           = dlr_rf.size();
+    benchmark::DoNotOptimize(dlr_rf.data());
+  }
+  set_counters(state, r);
+}
+BENCHMARK(BM_build_dlr_rf)->Apply(sweep_lambda_eps)->Unit(benchmark::kMillisecond);
+
+/**
+* @brief Construction of DLR imaginary time object
+*/
+static void BM_imtime_ops(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+
+  for (auto _ : state) {
+    auto itops = imtime_ops(b.lambda, b.dlr_rf);
+    benchmark::DoNotOptimize(itops.get_itnodes().data());
+  }
+  set_counters(state, b.itops.rank());
+}
+BENCHMARK(BM_imtime_ops)->Apply(sweep_lambda_eps)->Unit(benchmark::kMillisecond);
+
+/**
+* @brief Construction of DLR imaginary frequency object
+*/
+static void BM_imfreq_ops(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+
+  for (auto _ : state) {
+    auto ifops = imfreq_ops(b.lambda, b.dlr_rf, Fermion);
+    benchmark::DoNotOptimize(ifops.get_ifnodes().data());
+  }
+  set_counters(state, b.itops.rank());
+}
+BENCHMARK(BM_imfreq_ops)->Apply(sweep_lambda_eps)->Unit(benchmark::kMillisecond);
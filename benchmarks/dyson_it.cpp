@@ -0,0 +1,78 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dyson_it.cpp
+*
+* @brief Benchmarks for imaginary time Dyson equation solvers
+*/
+
+#include "bench_common.hpp"
+
+using namespace cppdlr;
+using namespace cppdlr::bench;
+
+static constexpr double beta = 1000; // Inverse temperature
+
+/**
+* @brief Random symmetric norb x norb Hamiltonian w/ entries in [-1,1]
+*/
+static nda::matrix<double> random_ham(int norb) {
+  auto a = nda::matrix<double>(-1 + 2 * nda::rand<double>(std::array<long, 2>{norb, norb}));
+  return (a + transpose(a)) / 2;
+}
+
+/**
+* @brief Direct solution of Dyson equation by dense LU factorization
+*/
+template <typename S> static void BM_dyson_solve(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto dys      = dyson_it(beta, b.itops, random_ham(norb));
+  auto sig      = nda::array<S, 3>(0.1 * random_gf<S>(r, norb));
+
+  for (auto _ : state) { benchmark::DoNotOptimize(dys.solve(sig).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_dyson_solve, double)->Apply(sweep_lambda_eps_norb)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_dyson_solve, dcomplex)->Apply(sweep_lambda_eps_norb)->Unit(benchmark::kMillisecond);
+
+/**
+* @brief Iterative solution of Dyson equation by GMRES, with free Green's
+* function as initial guess and no preconditioner
+*/
+template <typename S> static void BM_dyson_solve_iterative(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto dys      = dyson_it(beta, b.itops, random_ham(norb));
+  auto sig      = nda::array<S, 3>(0.1 * random_gf<S>(r, norb));
+  b.itops.precompute();
+
+  int niter = 0;
+  for (auto _ : state) {
+    auto [g, n, resid] = dys.solve_iterative(sig, b.eps);
+    niter              = n;
+    benchmark::DoNotOptimize(g.data());
+  }
+  set_counters(state, r, norb);
+  state.counters["niter"] = niter;
+}
+BENCHMARK_TEMPLATE(BM_dyson_solve_iterative, double)->Apply(sweep_lambda_eps_norb)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_dyson_solve_iterative, dcomplex)->Apply(sweep_lambda_eps_norb)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,151 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file imtime_ops.cpp
+*
+* @brief Benchmarks for imtime_ops methods, for real and complex
+* matrix-valued Green's functions
+*/
+
+#include "bench_common.hpp"
+
+using namespace cppdlr;
+using namespace cppdlr::bench;
+
+static constexpr double beta = 1000; // Inverse temperature
+
+/**
+* @brief Transformation from values at DLR imaginary time nodes to DLR
+* coefficients
+*/
+template <typename S> static void BM_vals2coefs(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto g        = random_gf<S>(r, norb);
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.vals2coefs(g).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_vals2coefs, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_vals2coefs, dcomplex)->Apply(sweep_lambda_eps_norb);
+
+/**
+* @brief Transformation from DLR coefficients to values at DLR imaginary time
+* nodes
+*/
+template <typename S> static void BM_coefs2vals(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto gc       = random_gf<S>(r, norb);
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.coefs2vals(gc).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_coefs2vals, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_coefs2vals, dcomplex)->Apply(sweep_lambda_eps_norb);
+
+/**
+* @brief Evaluation of DLR expansion at a single imaginary time point
+*/
+template <typename S> static void BM_coefs2eval(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto gc       = random_gf<S>(r, norb);
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.coefs2eval(gc, 0.3).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_coefs2eval, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_coefs2eval, dcomplex)->Apply(sweep_lambda_eps_norb);
+
+/**
+* @brief Convolution by O(r^2) algorithm of imtime_ops::convolve
+*/
+template <typename S> static void BM_convolve(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto fc       = random_gf<S>(r, norb);
+  auto gc       = random_gf<S>(r, norb);
+  b.itops.precompute();
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.convolve(beta, Fermion, fc, gc).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_convolve, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_convolve, dcomplex)->Apply(sweep_lambda_eps_norb);
+
+/**
+* @brief Convolution by forming matrix of convolution and applying it
+*/
+template <typename S> static void BM_convmat_apply(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto fc       = random_gf<S>(r, norb);
+  auto g        = random_gf<S>(r, norb);
+  b.itops.precompute();
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.convolve(b.itops.convmat(beta, Fermion, fc), g).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_convmat_apply, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_convmat_apply, dcomplex)->Apply(sweep_lambda_eps_norb);
+
+/**
+* @brief Imaginary time inner product
+*/
+template <typename S> static void BM_innerprod(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto fc       = random_gf<S>(r, norb);
+  auto gc       = random_gf<S>(r, norb);
+  b.itops.precompute();
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.innerprod(fc, gc)); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_innerprod, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_innerprod, dcomplex)->Apply(sweep_lambda_eps_norb);
+
+/**
+* @brief Least squares fit of DLR coefficients to values on an equispaced grid
+* of 4*r points
+*/
+template <typename S> static void BM_fitvals2coefs(benchmark::State &state) {
+
+  auto const &b = get_basis(state);
+  int r         = b.itops.rank();
+  int norb      = state.range(2);
+  auto t        = eqptsrel(4 * r);
+  auto g        = random_gf<S>(4 * r, norb);
+
+  for (auto _ : state) { benchmark::DoNotOptimize(b.itops.fitvals2coefs(t, g).data()); }
+  set_counters(state, r, norb);
+}
+BENCHMARK_TEMPLATE(BM_fitvals2coefs, double)->Apply(sweep_lambda_eps_norb);
+BENCHMARK_TEMPLATE(BM_fitvals2coefs, dcomplex)->Apply(sweep_lambda_eps_norb);
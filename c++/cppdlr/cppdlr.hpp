@@ -20,4 +20,14 @@
 #include "dlr_imtime.hpp"
 #include "dlr_kernels.hpp"
 #include "dlr_dyson.hpp"
+#include "dlr_fitter.hpp"
+#include "dlr_accumulator.hpp"
+#include "dlr_transform.hpp"
+#include "dlr_gf.hpp"
+#include "dlr_device.hpp"
+#include "dlr_mpi.hpp"
+#include "dlr_static.hpp"
+#include "dlr_pipeline.hpp"
+#include "dlr_basis_cache.hpp"
+#include "instrument.hpp"
 #include "utils.hpp"
\ No newline at end of file
@@ -0,0 +1,251 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "cppdlr/dlr_build.hpp"
+#include "cppdlr/dlr_fitter.hpp"
+#include "cppdlr/dlr_imtime.hpp"
+#include "cppdlr/dlr_kernels.hpp"
+#include "cppdlr/instrument.hpp"
+#include "cppdlr/utils.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace cppdlr {
+
+  /**
+  * @class imtime_accumulator
+  * @brief Streaming accumulation of Monte Carlo samples of an imaginary time
+  * Green's function directly into its DLR expansion
+  *
+  * A Monte Carlo estimator of a Green's function G typically takes the form of
+  * a sum of weighted delta functions,
+  *
+  * G(tau) = sum_i w_i delta(tau - tau_i),
+  *
+  * with tau_i in [0, beta]. Rather than binning the samples on a fine grid and
+  * fitting, this class accumulates the projections
+  *
+  * b_l = int_0^beta dtau phi_l(tau) G(tau) = sum_i w_i phi_l(tau_i)
+  *
+  * onto the DLR basis functions phi_l(tau) = K(tau/beta, om_l), which requires
+  * O(r) memory and O(r) work per sample. The DLR coefficients of the
+  * L^2-projection of G onto the span of the DLR basis are then obtained on
+  * demand by solving M gc = b, with M the Gram matrix of the DLR basis (see
+  * imtime_ops::get_ipmat).
+  *
+  * The Gram matrix is not formed and factorized directly, since its condition
+  * number is the square of that of the DLR basis. Instead, the DLR basis
+  * functions are sampled on a fine composite Gauss-Legendre grid, with
+  * square root quadrature weights, and the R factor of the QR factorization
+  * of this sampling matrix A is computed (see dlr_fitter). Then M = beta R^T
+  * R, and gc is obtained from b by two triangular solves with R, whose
+  * condition number is that of the DLR basis. R is computed once, on the
+  * first call of coefs.
+  *
+  * Since the projections are linear in the samples, accumulators filled
+  * independently (e.g. on different threads or MPI ranks) can be combined by
+  * summing them, using operator+= or a reduction over data().
+  *
+  * @tparam S Scalar type of sample weights
+  * @tparam R Rank of DLR coefficient array: 1 for scalar-valued G, 3 for
+  * matrix-valued G
+  *
+  * \note The accumulator holds a pointer to the imtime_ops object given at
+  * construction, which must outlive it.
+  */
+  template <nda::Scalar S = double, int R = 1> class imtime_accumulator {
+
+    public:
+    /**
+    * @brief Constructor for imtime_accumulator
+    *
+    * @param[in] itops DLR imaginary time object
+    * @param[in] shape Shape of the value of G at a single time point (e.g.
+    * {norb, norb} for a matrix-valued G); empty for scalar-valued G
+    */
+    imtime_accumulator(imtime_ops const &itops, std::array<long, R - 1> shape = {}) : itops_ptr(&itops) {
+      auto bshape = std::array<long, R>{};
+      bshape[0]   = itops.rank();
+      std::copy(shape.begin(), shape.end(), bshape.begin() + 1);
+      b = nda::zeros<S>(bshape);
+    }
+
+    /**
+    * @brief Add a single sample of a scalar-valued Green's function
+    *
+    * @param[in] t Imaginary time of sample, scaled to [0, 1] and given in
+    * relative format
+    * @param[in] w Weight of sample
+    */
+    void accumulate(double t, S w)
+      requires(R == 1)
+    {
+      auto dlr_rf = itops_ptr->get_rfnodes();
+      for (int l = 0; l < dlr_rf.size(); ++l) { b(l) += w * k_it(t, dlr_rf(l)); }
+      ++nsamp;
+    }
+
+    /**
+    * @brief Add a single sample of a matrix-valued Green's function
+    *
+    * @param[in] t Imaginary time of sample, scaled to [0, 1] and given in
+    * relative format
+    * @param[in] w Weight of sample, with shape given at construction
+    */
+    template <nda::MemoryArray T>
+      requires(R > 1 && nda::get_rank<T> == R - 1)
+    void accumulate(double t, T const &w) {
+      auto dlr_rf = itops_ptr->get_rfnodes();
+      for (int l = 0; l < dlr_rf.size(); ++l) { b(l, nda::ellipsis()) += k_it(t, dlr_rf(l)) * w; }
+      ++nsamp;
+    }
+
+    /**
+    * @brief Add a batch of samples
+    *
+    * @param[in] t Imaginary times of samples, scaled to [0, 1] and given in
+    * relative format
+    * @param[in] w Weights of samples; first dimension is the number of
+    * samples, and remaining dimensions are given by the shape given at
+    * construction
+    *
+    * \note Kernel rows are evaluated for blocks of samples using the batched
+    * kernel k_it, and applied to the weights by a matrix-matrix product, so
+    * this method is considerably faster than adding samples one at a time.
+    */
+    template <nda::MemoryArray T>
+      requires(nda::get_rank<T> == R)
+    void accumulate(nda::vector_const_view<double> t, T const &w) {
+
+      int r   = itops_ptr->rank();
+      long ns = t.size();
+      long m  = b.size() / r;
+      CPPDLR_PROBE("imtime_accumulator::accumulate", ns * (m * sizeof(S) + sizeof(double)), instrument::fma_flops<S> * ns * r * m);
+
+      if (w.shape(0) != ns) throw std::runtime_error("First dim of w must be equal to number of samples.");
+      if (w.size() != ns * m) throw std::runtime_error("Shape of samples does not match shape of accumulator.");
+
+      constexpr long nblk = 64; // # samples per block
+
+      auto dlr_rf = nda::vector<double>(itops_ptr->get_rfnodes());
+      auto tblk   = nda::vector<double>(nblk);
+      auto kmat   = nda::matrix<double>(nblk, r);
+      auto b_rs   = nda::reshape(b, r, m);
+
+      for (long i0 = 0; i0 < ns; i0 += nblk) {
+        long nb = std::min(nblk, ns - i0);
+
+        // Kernel matrix for block of samples
+        tblk(nda::range(nb)) = t(nda::range(i0, i0 + nb));
+        k_it({tblk.data(), size_t(nb)}, {dlr_rf.data(), size_t(r)}, {kmat.data(), size_t(nb * r)});
+
+        // b += K^T w
+        auto wblk = nda::array<S, R>(w(nda::range(i0, i0 + nb), nda::ellipsis()));
+        realgemm(1.0, transpose(kmat(nda::range(nb), _)), nda::reshape(wblk, nb, m), 1.0, b_rs);
+      }
+
+      nsamp += ns;
+    }
+
+    /**
+    * @brief Add samples accumulated by another accumulator
+    *
+    * @param[in] other Accumulator with same DLR basis and shape
+    */
+    imtime_accumulator &operator+=(imtime_accumulator const &other) {
+      if (other.b.shape() != b.shape()) throw std::runtime_error("Accumulators must have the same shape.");
+      b += other.b;
+      nsamp += other.nsamp;
+      return *this;
+    }
+
+    /**
+    * @brief Obtain DLR coefficients of accumulated Green's function
+    *
+    * @param[in] beta Inverse temperature
+    *
+    * @return DLR coefficients of L^2-projection of G onto DLR basis
+    *
+    * \note Samples are not normalized; to obtain a Monte Carlo average,
+    * the weights should include a factor 1/N, or the result should be
+    * divided by nsamples().
+    */
+    nda::array<S, R> coefs(double beta) const {
+
+      int r = itops_ptr->rank();
+      CPPDLR_PROBE("imtime_accumulator::coefs", 2 * b.size() * sizeof(S), instrument::fma_flops<S> * r * b.size());
+
+      // Factor R of Gram matrix of DLR basis on [0, 1], ipmat = R^T R, from QR
+      // factorization of DLR basis sampled on fine quadrature grid
+      rfac_once.call_once([this] {
+        auto fine   = fineparams(2 * itops_ptr->lambda()); // Resolves products of DLR basis functions
+        auto [t, w] = build_it_fine(fine);
+        rfac        = dlr_fitter<double>(*itops_ptr, t, w).get_rfactor();
+      });
+
+      // Solve beta R^T R gc = b with projections as right hand sides
+      auto gc = nda::array<S, R>(b / beta);
+      auto y  = nda::reshape(gc, r, b.size() / r);
+      for (int j = 0; j < r; ++j) { // Forward substitution with R^T
+        for (int k = 0; k < j; ++k) { y(j, _) -= rfac(k, j) * y(k, _); }
+        y(j, _) /= rfac(j, j);
+      }
+      for (int j = r - 1; j >= 0; --j) { // Back substitution with R
+        for (int k = j + 1; k < r; ++k) { y(j, _) -= rfac(j, k) * y(k, _); }
+        y(j, _) /= rfac(j, j);
+      }
+
+      return gc;
+    }
+
+    /**
+    * @brief Get accumulated projections onto DLR basis functions
+    *
+    * \note This can be used for a reduction across MPI ranks, e.g. by an
+    * in-place MPI_Allreduce over data().data().
+    */
+    nda::array_view<S, R> data() { return b; }
+
+    /**
+    * @copydoc data()
+    */
+    nda::array_const_view<S, R> data() const { return b; }
+
+    /**
+    * @brief Get number of samples accumulated
+    */
+    long nsamples() const { return nsamp; }
+
+    /**
+    * @brief Discard all accumulated samples
+    */
+    void reset() {
+      b     = 0;
+      nsamp = 0;
+    }
+
+    private:
+    imtime_ops const *itops_ptr;      ///< DLR imaginary time object
+    nda::array<S, R> b;               ///< Projections onto DLR basis functions
+    long nsamp = 0;                   ///< Number of samples accumulated
+    mutable nda::matrix<double> rfac; ///< Cholesky factor R of Gram matrix of DLR basis on [0, 1]
+    mutable init_flag rfac_once;      ///< Computation of rfac
+  };
+
+} // namespace cppdlr
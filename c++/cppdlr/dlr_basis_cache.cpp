@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#include "dlr_basis_cache.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace cppdlr {
+
+  dlr_basis_cache::dlr_basis_cache(std::string dir) : dir(std::move(dir)) { fs::create_directories(this->dir); }
+
+  std::string dlr_basis_cache::filename(double lambda, double eps, bool symmetrize, statistic_t statistic) const {
+
+    // Exact representation of floating point parameters, so that the key is
+    // unique
+    std::ostringstream key;
+    key << "dlr_lambda_" << std::hexfloat << lambda << "_eps_" << eps << "_" << (symmetrize ? "sym" : "nonsym") << "_"
+        << (statistic == Fermion ? "fermion" : "boson") << ".h5";
+
+    return (fs::path(dir) / key.str()).string();
+  }
+
+  bool dlr_basis_cache::contains(double lambda, double eps, bool symmetrize, statistic_t statistic) const {
+    return fs::exists(filename(lambda, eps, symmetrize, statistic));
+  }
+
+  dlr_basis_cache::entry dlr_basis_cache::get(double lambda, double eps, bool symmetrize, statistic_t statistic) const {
+
+    auto fname = filename(lambda, eps, symmetrize, statistic);
+
+    // Return cached basis if available
+    auto e = entry{};
+    if (read(fname, lambda, eps, symmetrize, statistic, e)) { return e; }
+
+    // Otherwise build basis...
+    e.dlr_rf = build_dlr_rf(lambda, eps, symmetrize);
+    e.itops  = imtime_ops(lambda, e.dlr_rf, symmetrize);
+    e.ifops  = imfreq_ops(lambda, e.dlr_rf, statistic, symmetrize);
+
+    // ...and store it
+    write(fname, lambda, eps, symmetrize, statistic, e);
+
+    return e;
+  }
+
+  bool dlr_basis_cache::read(std::string const &fname, double lambda, double eps, bool symmetrize, statistic_t statistic, entry &e) const {
+
+    if (!fs::exists(fname)) { return false; }
+
+    // Entries are written atomically, so an existing file is complete; a
+    // failure to read it (e.g. corrupted file, incompatible format) is treated
+    // as a cache miss
+    try {
+      h5::file file(fname, 'r');
+      h5::group gr = h5::group(file).open_group("dlr_basis");
+      assert_hdf5_format_as_string(gr, hdf5_format().c_str(), true);
+
+      // Check parameters to guard against stale or foreign files
+      if (h5::read<double>(gr, "lambda") != lambda || h5::read<double>(gr, "eps") != eps) { return false; }
+      if (h5::read<int>(gr, "symmetrize") != int(symmetrize) || h5::read<int>(gr, "statistic") != int(statistic)) { return false; }
+
+      h5::read(gr, "rf", e.dlr_rf);
+      h5::read(gr, "itops", e.itops);
+      h5::read(gr, "ifops", e.ifops);
+    } catch (std::exception const &) { return false; }
+
+    return true;
+  }
+
+  void dlr_basis_cache::write(std::string const &fname, double lambda, double eps, bool symmetrize, statistic_t statistic, entry const &e) const {
+
+    // Unique temporary file name in the cache directory, so that concurrent
+    // writers never write to the same file
+    auto seed = std::random_device{}() ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+    auto tmp  = fname + ".tmp." + std::to_string(std::mt19937_64(seed)());
+
+    {
+      h5::file file(tmp, 'w');
+      h5::group gr = h5::group(file).create_group("dlr_basis");
+      write_hdf5_format_as_string(gr, hdf5_format().c_str());
+
+      h5::write(gr, "lambda", lambda);
+      h5::write(gr, "eps", eps);
+      h5::write(gr, "symmetrize", int(symmetrize));
+      h5::write(gr, "statistic", int(statistic));
+      h5::write(gr, "rf", e.dlr_rf);
+      h5::write(gr, "itops", e.itops);
+      h5::write(gr, "ifops", e.ifops);
+    }
+
+    // Atomically move entry into place; if another process has written the
+    // same entry in the meantime, it is replaced by an identical one
+    std::error_code ec;
+    fs::rename(tmp, fname, ec);
+    if (ec) {
+      fs::remove(tmp, ec);
+      if (!fs::exists(fname)) { throw std::runtime_error("dlr_basis_cache: failed to write cache entry " + fname); }
+    }
+  }
+
+} // namespace cppdlr
@@ -0,0 +1,119 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "dlr_build.hpp"
+#include "dlr_imtime.hpp"
+#include "dlr_imfreq.hpp"
+
+#include <string>
+
+namespace cppdlr {
+
+  /**
+  * @class dlr_basis_cache
+  * @brief Persistent on-disk cache of DLR bases
+  *
+  * Building a DLR basis (DLR frequencies, and the imtime_ops and imfreq_ops
+  * objects on top of them) requires pivoted Gram-Schmidt on fine grid
+  * discretizations of the analytic continuation kernel, which can be costly
+  * for large lambda. This class stores fully constructed bases in a directory
+  * of HDF5 files, one file per set of parameters (lambda, eps, symmetrize,
+  * statistic), so that they only need to be built once.
+  *
+  * A cache entry is written to a uniquely named temporary file and then
+  * atomically renamed into place. Therefore readers never see a partially
+  * written entry, and many processes (e.g. MPI ranks) may safely call get
+  * concurrently for the same parameters: at worst, several of them build the
+  * basis and the last rename wins, with identical contents.
+  */
+  class dlr_basis_cache {
+
+    public:
+    /**
+    * @brief Fully constructed DLR basis stored in a cache entry
+    */
+    struct entry {
+      nda::vector<double> dlr_rf; ///< DLR frequencies
+      imtime_ops itops;           ///< DLR imaginary time object
+      imfreq_ops ifops;           ///< DLR imaginary frequency object
+    };
+
+    /**
+    * @brief Constructor for dlr_basis_cache
+    *
+    * @param[in] dir Cache directory (created if it does not exist)
+    */
+    dlr_basis_cache(std::string dir);
+
+    /**
+    * @brief Get DLR basis from cache, building and storing it if necessary
+    *
+    * @param[in] lambda DLR cutoff parameter
+    * @param[in] eps Accuracy of DLR basis
+    * @param[in] symmetrize NONSYM or false for non-symmetrized DLR frequencies,
+    * SYM or true for symmetrized
+    * @param[in] statistic Particle statistic used for imfreq_ops: Fermion or Boson
+    *
+    * @return DLR frequencies, imtime_ops and imfreq_ops objects
+    */
+    entry get(double lambda, double eps, bool symmetrize, statistic_t statistic) const;
+
+    /**
+    * @brief Get path of cache file for given parameters
+    *
+    * The file name is built from the exact (hexadecimal floating point)
+    * representations of lambda and eps, so that distinct parameters never map
+    * to the same entry.
+    *
+    * @param[in] lambda DLR cutoff parameter
+    * @param[in] eps Accuracy of DLR basis
+    * @param[in] symmetrize Symmetrization flag
+    * @param[in] statistic Particle statistic
+    *
+    * @return Path of cache file
+    */
+    std::string filename(double lambda, double eps, bool symmetrize, statistic_t statistic) const;
+
+    /**
+    * @brief Check whether cache contains an entry for given parameters
+    */
+    bool contains(double lambda, double eps, bool symmetrize, statistic_t statistic) const;
+
+    /**
+    * @brief Get cache directory
+    */
+    std::string const &directory() const { return dir; }
+
+    static std::string hdf5_format() { return "cppdlr::dlr_basis_cache"; }
+
+    private:
+    std::string dir; ///< Cache directory
+
+    /**
+    * @brief Try to read cache entry; return false if the file does not exist
+    * or does not match the given parameters
+    */
+    bool read(std::string const &fname, double lambda, double eps, bool symmetrize, statistic_t statistic, entry &e) const;
+
+    /**
+    * @brief Write cache entry atomically
+    */
+    void write(std::string const &fname, double lambda, double eps, bool symmetrize, statistic_t statistic, entry const &e) const;
+  };
+
+} // namespace cppdlr
@@ -17,8 +17,14 @@
 #include "dlr_build.hpp"
 #include "utils.hpp"
 #include "dlr_kernels.hpp"
+#include "instrument.hpp"
+#include <atomic>
 #include <numbers>
 
+#ifdef CPPDLR_USE_OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace nda;
 
@@ -26,6 +32,42 @@ using std::numbers::pi;
 
 namespace cppdlr {
 
+  namespace {
+
+    std::atomic<int> build_threads = 0; // Thread count for kernel matrix builders, 0 = OpenMP default
+
+    constexpr long buildblk = 64; // # rows (or entries) of kernel matrices built per task
+
+    [[maybe_unused]] constexpr long parallel_min_work = 1L << 18; // Minimum # kernel evaluations for which an OpenMP team is forked
+
+    // Call f(i) for i = 0, ..., n-1, distributing iterations over
+    // get_build_threads() OpenMP threads if the total work (e.g. # of kernel
+    // evaluations) is at least parallel_min_work, so that the many small
+    // kernel matrices built outside of basis construction stay serial
+    template <typename F> void parallel_for(long n, [[maybe_unused]] long work, F &&f) {
+#ifdef CPPDLR_USE_OPENMP
+      int nthr = get_build_threads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthr) if (nthr > 1 && n > 1 && work >= parallel_min_work)
+#endif
+      for (long i = 0; i < n; ++i) { f(i); }
+    }
+
+  } // namespace
+
+  void set_build_threads(int nthreads) {
+    if (nthreads < 0) throw std::runtime_error("Choose nthreads >= 0.");
+    build_threads = nthreads;
+  }
+
+  int get_build_threads() {
+#ifdef CPPDLR_USE_OPENMP
+    int n = build_threads;
+    return (n > 0 ? n : omp_get_max_threads());
+#else
+    return 1;
+#endif
+  }
+
   fineparams::fineparams(double lambda, int p)
      : // TODO: make alt constructor in which iommax is a parameter
 
@@ -105,58 +147,60 @@ namespace cppdlr {
 
   nda::matrix<double> build_k_it(nda::vector_const_view<double> t, nda::vector_const_view<double> om) {
 
-    int nt  = t.size();
-    int nom = om.size();
+    // Contiguous copies of inputs for batched kernel evaluation
+    auto tt  = nda::vector<double>(t);
+    auto omm = nda::vector<double>(om);
 
-    auto kmat = nda::matrix<double>(nt, nom);
+    long m = t.size(), n = om.size();
 
-    for (int i = 0; i < nt; ++i) {
-      for (int j = 0; j < nom; ++j) { kmat(i, j) = k_it(t(i), om(j)); }
-    }
+    // Rows are built in independent blocks of buildblk time points
+    auto kmat = nda::matrix<double>(m, n);
+    parallel_for((m + buildblk - 1) / buildblk, m * n, [&](long b) {
+      long i0 = b * buildblk, mb = std::min(buildblk, m - i0);
+      k_it({tt.data() + i0, size_t(mb)}, {omm.data(), size_t(n)}, {kmat.data() + i0 * n, size_t(mb * n)});
+    });
 
     return kmat;
   }
 
   nda::matrix<double> build_k_it(nda::vector_const_view<double> t, nda::vector_const_view<double> w, nda::vector_const_view<double> om) {
 
-    int nt  = t.size();
-    int nom = om.size();
-
-    auto kmat = nda::matrix<double>(nt, nom);
+    auto _ = range::all;
 
-    for (int i = 0; i < nt; ++i) {
-      for (int j = 0; j < nom; ++j) { kmat(i, j) = w(i) * k_it(t(i), om(j)); }
-    }
+    auto kmat = build_k_it(t, om);
+    for (int i = 0; i < t.size(); ++i) { kmat(i, _) *= w(i); }
 
     return kmat;
   }
 
   nda::vector<double> build_k_it(double t, nda::vector_const_view<double> om) {
 
-    int nom = om.size();
+    auto omm = nda::vector<double>(om);
+
+    long n = om.size();
 
-    auto kvec = nda::vector<double>(nom);
-    for (int j = 0; j < nom; ++j) { kvec(j) = k_it(t, om(j)); }
+    auto kvec = nda::vector<double>(n);
+    k_it({&t, 1}, {omm.data(), size_t(n)}, {kvec.data(), size_t(n)});
 
     return kvec;
   }
 
   nda::vector<double> build_k_it(nda::vector_const_view<double> t, double om) {
 
-    int nt = t.size();
+    auto tt = nda::vector<double>(t);
+
+    long m = t.size();
 
-    auto kvec = nda::vector<double>(nt);
-    for (int i = 0; i < nt; ++i) { kvec(i) = k_it(t(i), om); }
+    auto kvec = nda::vector<double>(m);
+    k_it({tt.data(), size_t(m)}, {&om, 1}, {kvec.data(), size_t(m)});
 
     return kvec;
   }
 
   nda::vector<double> build_k_it(nda::vector_const_view<double> t, nda::vector_const_view<double> w, double om) {
 
-    int nt = t.size();
-
-    auto kvec = nda::vector<double>(nt);
-    for (int i = 0; i < nt; ++i) { kvec(i) = w(i) * k_it(t(i), om); }
+    auto kvec = build_k_it(t, om);
+    for (int i = 0; i < t.size(); ++i) { kvec(i) *= w(i); }
 
     return kvec;
   }
@@ -190,13 +234,14 @@ namespace cppdlr {
     auto xc = bc2.getnodes(); // Dense grid of Chebyshev nodes on [-1,1]
     auto xl = bl2.getnodes(); // Dense grid of Legendre nodes on [-1,1]
 
-    double ktru = 0, ktst = 0, errtmp = 0;
+    // Errors for each column (row) of kmat are computed independently, and the
+    // maximum is taken afterwards
 
     // First test time discretization for each fixed frequency.
 
-    double errt = 0;
-    for (int j = 0; j < nom; ++j) {
-      errtmp = 0;
+    auto errtj = nda::vector<double>(nom);
+    parallel_for(nom, long(nom) * npt * p2, [&](long j) {
+      double ktru = 0, ktst = 0, errtmp = 0;
       for (int i = 0; i < npt; ++i) { // Only need to test first half of matrix
         for (int k = 0; k < p2; ++k) {
 
@@ -206,14 +251,15 @@ namespace cppdlr {
           errtmp = max(errtmp, abs(ktru - ktst));
         }
       }
-      errt = max(errt, errtmp / max_element(abs(kmat(_, j))));
-    }
+      errtj(j) = errtmp / max_element(abs(kmat(_, j)));
+    });
+    double errt = max_element(errtj);
 
     // Next test frequency discretization for each fixed time.
 
-    double errom = 0;
-    for (int i = 0; i < nt / 2; ++i) {
-      errtmp = 0;
+    auto erromi = nda::vector<double>(nt / 2);
+    parallel_for(nt / 2, long(nt / 2) * 2 * npom * p2, [&](long i) {
+      double ktru = 0, ktst = 0, errtmp = 0;
       for (int j = 0; j < 2 * npom; ++j) {
         for (int k = 0; k < p2; ++k) {
 
@@ -223,35 +269,34 @@ namespace cppdlr {
           errtmp = max(errtmp, abs(ktru - ktst));
         }
       }
-      errom = max(errom, errtmp / max_element(abs(kmat(i, _))));
-    }
+      erromi(i) = errtmp / max_element(abs(kmat(i, _)));
+    });
+    double errom = max_element(erromi);
 
     return {errt, errom};
   }
 
   nda::matrix<dcomplex> build_k_if(int nmax, nda::vector_const_view<double> om, statistic_t statistic) {
 
-    int nom = om.size();
+    // Fermionic case: 2*n+1 should go from -2*nmax+1 to 2*nmax-1, so n goes
+    // from -nmax to nmax-1. Bosonic case: 2*n should go from -2*nmax to
+    // 2*nmax, so n goes from -nmax to nmax.
+    int nn = (statistic == Fermion ? 2 * nmax : 2 * nmax + 1);
 
-    if (statistic == Fermion) {
+    auto n = nda::vector<int>(nn);
+    for (int i = 0; i < nn; ++i) { n(i) = i - nmax; }
+    auto omm = nda::vector<double>(om);
 
-      // 2*n+1 should go from -2*nmax+1 to 2*nmax-1, so n goes from -nmax to nmax-1
-      auto kmat = nda::matrix<dcomplex>(2 * nmax, nom);
+    long nom = om.size();
 
-      for (int n = -nmax; n < nmax; ++n) {
-        for (int j = 0; j < nom; ++j) { kmat(nmax + n, j) = k_if(n, om(j), statistic); }
-      }
-      return kmat;
-    } else {
-
-      // 2*n+1 should go from -2*nmax to 2*nmax, so n goes from -nmax to nmax
-      auto kmat = nda::matrix<dcomplex>(2 * nmax + 1, nom);
+    // Rows are built in independent blocks of buildblk frequencies
+    auto kmat = nda::matrix<dcomplex>(nn, nom);
+    parallel_for((nn + buildblk - 1) / buildblk, nn * nom, [&](long b) {
+      long i0 = b * buildblk, mb = std::min(buildblk, nn - i0);
+      k_if({n.data() + i0, size_t(mb)}, {omm.data(), size_t(nom)}, statistic, {kmat.data() + i0 * nom, size_t(mb * nom)});
+    });
 
-      for (int n = -nmax; n <= nmax; ++n) {
-        for (int j = 0; j < nom; ++j) { kmat(nmax + n, j) = k_if(n, om(j), statistic); }
-      }
-      return kmat;
-    }
+    return kmat;
   }
 
   nda::vector<double> build_dlr_rf(double lambda, double eps, bool symmetrize) {
@@ -263,6 +308,8 @@ namespace cppdlr {
     // Get fine grid parameters
     auto fine = fineparams(lambda);
 
+    CPPDLR_PROBE("build_dlr_rf", 2.0 * fine.nt * fine.nom * sizeof(double), 0);
+
     // Get fine grids in frequency and imaginary time
     auto [t, w] = build_it_fine(fine);
     auto om     = build_rf_fine(fine);
@@ -275,7 +322,7 @@ namespace cppdlr {
     auto kmat = build_k_it(t, w, om);
 
     // Pivoted Gram-Schmidt on columns of K matrix to obtain DLR frequencies
-    auto [q, norms, piv] = (symmetrize ? pivrgs_sym(transpose(kmat), eps) : pivrgs(transpose(kmat), eps));
+    auto [q, norms, piv] = (symmetrize ? pivrgs_sym_blocked(transpose(kmat), eps) : pivrgs_blocked(transpose(kmat), eps));
     long r               = norms.size();
     std::sort(piv.begin(), piv.end()); // Sort pivots in ascending order
 
@@ -287,4 +334,42 @@ namespace cppdlr {
 
   nda::vector<double> build_dlr_rf(double lambda, double eps) { return build_dlr_rf(lambda, eps, NONSYM); }
 
+  nda::vector<double> build_dlr_rf_extend(double lambda, double eps, nda::vector_const_view<double> dlr_rf_old) {
+
+    long r0 = dlr_rf_old.size();
+    for (long i = 0; i < r0; ++i) {
+      if (std::abs(dlr_rf_old(i)) > lambda) throw std::runtime_error("Previous DLR frequencies must lie in [-lambda, lambda].");
+    }
+
+    // Get fine grid parameters
+    auto fine = fineparams(lambda);
+
+    CPPDLR_PROBE("build_dlr_rf_extend", 2.0 * fine.nt * (fine.nom + r0) * sizeof(double), 0);
+
+    // Get fine grids in frequency and imaginary time
+    auto [t, w] = build_it_fine(fine);
+    auto om     = build_rf_fine(fine);
+
+    // Candidate frequencies: previous DLR frequencies, followed by fine grid
+    long nom                      = om.size();
+    auto omc                      = nda::vector<double>(r0 + nom);
+    omc(nda::range(r0))           = dlr_rf_old;
+    omc(nda::range(r0, r0 + nom)) = om;
+
+    // Weighted K matrix on fine imaginary time grid and candidate frequencies,
+    // as in build_dlr_rf
+    auto kmat = build_k_it(t, w, omc);
+
+    // Pivoted Gram-Schmidt on columns of K matrix, with previous DLR
+    // frequencies selected first
+    auto [q, norms, piv] = pivrgs_blocked_seeded(transpose(kmat), eps, r0);
+    long r               = norms.size();
+    std::sort(piv.begin() + r0, piv.end()); // Sort new pivots in ascending order
+
+    auto omega = nda::vector<double>(r);
+    for (int i = 0; i < r; ++i) { omega(i) = omc(piv(i)); }
+
+    return omega;
+  }
+
 } // namespace cppdlr
@@ -47,6 +47,29 @@ namespace cppdlr {
     const int nt;        ///< Total # fine imaginary time grid points
   };
 
+  /**
+  * @brief Set the number of threads used to build fine grid kernel matrices
+  *
+  * @param[in] nthreads Number of threads; 0 selects the OpenMP default
+  * (omp_get_max_threads), 1 runs serially
+  *
+  * \note Affects build_k_it, build_k_if and geterr_k_it, and therefore the
+  * construction of DLR frequencies in build_dlr_rf. Only kernel matrices with
+  * at least ~2.6e5 entries are built in parallel; smaller matrices, such as
+  * those built by imtime_ops and imfreq_ops, and the single time or frequency
+  * overloads of build_k_it, are always built serially. Set to 1 when calling from
+  * code which is already parallelized, e.g. one call per MPI rank. Has no
+  * effect unless cppdlr is compiled with -DUse_OpenMP=ON.
+  */
+  void set_build_threads(int nthreads);
+
+  /**
+  * @brief Get the number of threads used to build fine grid kernel matrices
+  *
+  * @return Number of threads, or 1 if cppdlr is compiled without OpenMP
+  */
+  int get_build_threads();
+
   /**
   * @brief Build fine composite Chebyshev grid in real frequency 
   *
@@ -169,4 +192,51 @@ namespace cppdlr {
   */
   nda::vector<double> build_dlr_rf(double lambda, double eps);
 
+  /**
+  * @brief Extend DLR basis to larger cutoff or smaller tolerance
+  *
+  * The DLR frequencies for cutoff @p lambda and accuracy @p eps are obtained
+  * by pivoted Gram-Schmidt, as in build_dlr_rf, but with the previous DLR
+  * frequencies @p dlr_rf_old selected first, so that only the new frequencies
+  * are chosen by pivoting. The previous DLR frequencies are kept, in their
+  * original order, as the first DLR frequencies of the extended basis, so that
+  * DLR coefficients in the previous basis are mapped to the extended basis by
+  * padding with zeros (see extend_coefs).
+  *
+  * @param[in] lambda DLR cutoff parameter
+  * @param[in] eps Accuracy of DLR basis
+  * @param[in] dlr_rf_old Previous DLR frequencies, which must lie in [-lambda,
+  * lambda]
+  *
+  * @return DLR frequencies: @p dlr_rf_old, followed by the new DLR frequencies in
+  * ascending order
+  *
+  * \note Only unsymmetrized DLR frequencies are supported. The extended
+  * basis may have slightly more frequencies than one built from scratch by
+  * build_dlr_rf.
+  */
+  nda::vector<double> build_dlr_rf_extend(double lambda, double eps, nda::vector_const_view<double> dlr_rf_old);
+
+  /**
+  * @brief Map DLR coefficients to a basis extended by build_dlr_rf_extend
+  *
+  * @param[in] gc DLR coefficients in previous basis
+  * @param[in] r DLR rank of extended basis
+  *
+  * @return DLR coefficients in extended basis
+  */
+  template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> nda::array<S, nda::get_rank<T>> extend_coefs(T const &gc, int r) {
+
+    if (r < gc.shape(0)) throw std::runtime_error("DLR rank of extended basis must be at least that of previous basis.");
+
+    auto shape = gc.shape();
+    shape[0]   = r;
+    auto gce   = nda::array<S, nda::get_rank<T>>(shape);
+    gce        = 0;
+
+    gce(nda::range(gc.shape(0)), nda::ellipsis{}) = gc;
+
+    return gce;
+  }
+
 } // namespace cppdlr
@@ -0,0 +1,442 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+
+// Device (GPU) support is only available if nda is compiled with CUDA
+#ifdef NDA_HAVE_CUDA
+
+#include <nda/nda.hpp>
+#include "dlr_imtime.hpp"
+#include "dlr_imfreq.hpp"
+#include "instrument.hpp"
+
+namespace cppdlr {
+
+  /**
+  * @class imtime_ops_device
+  * @brief Device-resident imaginary time DLR operations
+  *
+  * Keeps copies of the DLR transformation matrices of an imtime_ops object in
+  * device memory, and provides the operations which reduce to dense linear
+  * algebra on Green's functions stored in nda device arrays, so that these
+  * can stay on the device: transformation between DLR grid values and DLR
+  * coefficients, and convolution by a precomputed convolution matrix. All
+  * products are performed by nda::blas::gemm, which dispatches to cuBLAS for
+  * device arrays.
+  *
+  * \note The values -> coefficients transformation is applied as a product
+  * with the explicit r x r matrix it2cf, obtained once on the host from the LU
+  * factorization of cf2it, rather than by a triangular solve.
+  *
+  * \note The Hilbert transform matrices used by the coefficient-space
+  * imtime_ops::convolve are not kept on the device, since that method needs
+  * elementwise operations for which nda has no device kernels; convolutions
+  * on the device use the convolution matrix returned by convmat.
+  *
+  * \note First dimension of all Green's function arrays must be the DLR rank
+  * r, and arrays must be contiguous.
+  */
+  class imtime_ops_device {
+
+    public:
+    /**
+    * @brief Constructor for imtime_ops_device
+    *
+    * @param[in] itops DLR imaginary time object
+    */
+    explicit imtime_ops_device(imtime_ops const &itops) : itops_(itops) {
+
+      auto cf2it = itops.get_cf2it();
+      auto it2cf = itops.vals2coefs(nda::matrix<double>(nda::eye<double>(itops.rank())));
+
+      cf2it_r = nda::to_device(cf2it);
+      it2cf_r = nda::to_device(it2cf);
+      cf2it_z = nda::to_device(nda::matrix<dcomplex>(cf2it * dcomplex(1)));
+      it2cf_z = nda::to_device(nda::matrix<dcomplex>(it2cf * dcomplex(1)));
+    }
+
+    /**
+    * @brief Get host imtime_ops object
+    */
+    imtime_ops const &host() const { return itops_; }
+
+    /**
+    * @brief Get DLR rank
+    */
+    int rank() const { return itops_.rank(); }
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary time grid
+    * to DLR coefficients, on the device
+    *
+    * @param[in] g Values of G on DLR imaginary time grid, in device memory
+    *
+    * @return DLR coefficients of G, in device memory
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+      requires(nda::mem::on_device<T>)
+    typename T::regular_type vals2coefs(T const &g) const {
+      CPPDLR_PROBE("imtime_ops_device::vals2coefs", 2 * g.size() * sizeof(S), instrument::fma_flops<S> * g.size() * rank());
+      return apply(it2cf<S>(), g);
+    }
+
+    /**
+    * @brief Transform DLR coefficients of Green's function G to values on DLR
+    * imaginary time grid, on the device
+    *
+    * @param[in] gc DLR coefficients of G, in device memory
+    *
+    * @return Values of G on DLR imaginary time grid, in device memory
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+      requires(nda::mem::on_device<T>)
+    typename T::regular_type coefs2vals(T const &gc) const {
+      CPPDLR_PROBE("imtime_ops_device::coefs2vals", 2 * gc.size() * sizeof(S), instrument::fma_flops<S> * gc.size() * rank());
+      return apply(cf2it<S>(), gc);
+    }
+
+    /**
+    * @brief Compute matrix of convolution by an imaginary time Green's function
+    * and copy it to the device
+    *
+    * Same as imtime_ops::convmat, which is used to build the matrix on the
+    * host.
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc DLR coefficients of f, in host memory
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return Matrix of convolution by f, in device memory
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::cumatrix<S> convmat(double beta, statistic_t statistic, T const &fc, bool time_order = false) const {
+      return nda::to_device(itops_.convmat(beta, statistic, fc, time_order));
+    }
+
+    /**
+    * @brief Compute convolution of two imaginary time Green's functions, given
+    * matrix of convolution by one of them, on the device
+    *
+    * Same as imtime_ops::convolve(Tf const &, Tg const &).
+    *
+    * @param[in] fconv Matrix of convolution by f, in device memory
+    * @param[in] g Values of g on the DLR imaginary time grid, in device memory
+    *
+    * @return Values of h = f * g on DLR imaginary time grid, in device memory
+    */
+    template <nda::MemoryMatrix Tf, nda::MemoryArray Tg, nda::Scalar S = nda::get_value_t<Tg>>
+      requires(nda::mem::on_device<Tf> && nda::mem::on_device<Tg>)
+    typename Tg::regular_type convolve(Tf const &fconv, Tg const &g) const {
+
+      static_assert(Tg::rank == 1 || Tg::rank == 3,
+                    "Input array must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+      if (rank() != g.shape(0)) throw std::runtime_error("First dim of input g must be equal to DLR rank r.");
+
+      long m = (Tg::rank == 1 ? 1 : g.shape(Tg::rank - 1)); // # columns of g as r*norb x norb matrix
+      long n = g.size() / m;
+      if (fconv.shape(0) != n || fconv.shape(1) != n) throw std::runtime_error("Input array dimensions incompatible.");
+
+      auto h = typename Tg::regular_type(g.shape());
+      nda::blas::gemm(S(1), fconv, nda::reshape(g, n, m), S(0), nda::reshape(h, n, m));
+
+      return h;
+    }
+
+    /**
+    * @brief Get device copy of cf2it with given scalar type
+    */
+    template <nda::Scalar S> nda::cumatrix<S> const &cf2it() const {
+      if constexpr (nda::is_complex_v<S>) {
+        return cf2it_z;
+      } else {
+        return cf2it_r;
+      }
+    }
+
+    /**
+    * @brief Get device copy of it2cf with given scalar type
+    */
+    template <nda::Scalar S> nda::cumatrix<S> const &it2cf() const {
+      if constexpr (nda::is_complex_v<S>) {
+        return it2cf_z;
+      } else {
+        return it2cf_r;
+      }
+    }
+
+    private:
+    /**
+    * @brief Apply r x r matrix to first dimension of contiguous device array
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    typename T::regular_type apply(nda::cumatrix<S> const &a, T const &g) const {
+
+      int r = rank();
+      if (r != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+
+      long m = g.size() / r;
+      auto h = typename T::regular_type(g.shape());
+      nda::blas::gemm(S(1), a, nda::reshape(g, r, m), S(0), nda::reshape(h, r, m));
+
+      return h;
+    }
+
+    imtime_ops itops_;               ///< Host DLR imaginary time object
+    nda::cumatrix<double> cf2it_r;   ///< Transformation from DLR coefficients to grid values
+    nda::cumatrix<double> it2cf_r;   ///< Transformation from DLR grid values to coefficients
+    nda::cumatrix<dcomplex> cf2it_z; ///< Complex copy of cf2it_r
+    nda::cumatrix<dcomplex> it2cf_z; ///< Complex copy of it2cf_r
+  };
+
+  /**
+  * @class imfreq_ops_device
+  * @brief Device-resident imaginary frequency DLR operations
+  *
+  * Device counterpart of the transformations of imfreq_ops between values on
+  * the DLR imaginary frequency grid and DLR coefficients, for Green's
+  * functions stored in nda device arrays. Both are products with matrices
+  * kept in device memory, performed by nda::blas::gemm (cuBLAS).
+  *
+  * \note As in imtime_ops_device, the values -> coefficients transformation
+  * is applied as a product with the explicit r x niom matrix if2cf, obtained
+  * once on the host from the LU factorization of cf2if (or, in the
+  * symmetrized bosonic case with niom = r + 1, from the least squares
+  * solution), rather than by a triangular solve on the device.
+  *
+  * \note Green's function arrays must be complex (dcomplex) and contiguous,
+  * and their first dimension must be the number of DLR imaginary frequency
+  * nodes (values) or the DLR rank r (coefficients).
+  */
+  class imfreq_ops_device {
+
+    public:
+    /**
+    * @brief Constructor for imfreq_ops_device
+    *
+    * @param[in] ifops DLR imaginary frequency object
+    */
+    explicit imfreq_ops_device(imfreq_ops const &ifops) : ifops_(ifops) {
+
+      int niom = ifops.get_ifnodes().size();
+
+      cf2if_z = nda::to_device(ifops.get_cf2if());
+      if2cf_z = nda::to_device(ifops.vals2coefs(nda::matrix<dcomplex>(nda::eye<dcomplex>(niom))));
+    }
+
+    /**
+    * @brief Get host imfreq_ops object
+    */
+    imfreq_ops const &host() const { return ifops_; }
+
+    /**
+    * @brief Get DLR rank
+    */
+    int rank() const { return ifops_.rank(); }
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary frequency
+    * grid to DLR coefficients, on the device
+    *
+    * @param[in] g Values of G on DLR imaginary frequency grid, in device memory
+    *
+    * @return DLR coefficients of G, in device memory
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+      requires(nda::mem::on_device<T>)
+    nda::cuarray<dcomplex, T::rank> vals2coefs(T const &g) const {
+      CPPDLR_PROBE("imfreq_ops_device::vals2coefs", 2 * g.size() * sizeof(S), instrument::fma_flops<S> * g.size() * rank());
+      return apply(if2cf_z, g);
+    }
+
+    /**
+    * @brief Transform DLR coefficients of Green's function G to values on DLR
+    * imaginary frequency grid, on the device
+    *
+    * @param[in] gc DLR coefficients of G, in device memory
+    *
+    * @return Values of G on DLR imaginary frequency grid, in device memory
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+      requires(nda::mem::on_device<T>)
+    nda::cuarray<dcomplex, T::rank> coefs2vals(T const &gc) const {
+      CPPDLR_PROBE("imfreq_ops_device::coefs2vals", 2 * gc.size() * sizeof(S), instrument::fma_flops<S> * gc.size() * cf2if_z.extent(0));
+      return apply(cf2if_z, gc);
+    }
+
+    /**
+    * @brief Get device copy of cf2if
+    */
+    nda::cumatrix<dcomplex> const &cf2if() const { return cf2if_z; }
+
+    /**
+    * @brief Get device copy of if2cf
+    */
+    nda::cumatrix<dcomplex> const &if2cf() const { return if2cf_z; }
+
+    private:
+    /**
+    * @brief Apply matrix to first dimension of contiguous complex device array
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::cuarray<dcomplex, T::rank> apply(nda::cumatrix<dcomplex> const &a, T const &g) const {
+
+      static_assert(nda::is_complex_v<S>, "Device imaginary frequency Green's functions must be complex.");
+
+      long n = a.extent(1);
+      if (n != g.shape(0)) throw std::runtime_error("First dim of g incompatible with transformation matrix.");
+
+      auto shape = g.shape();
+      shape[0]   = a.extent(0);
+
+      long m = g.size() / n;
+      auto h = nda::cuarray<dcomplex, T::rank>(shape);
+      nda::blas::gemm(dcomplex(1), a, nda::reshape(g, n, m), dcomplex(0), nda::reshape(h, a.extent(0), m));
+
+      return h;
+    }
+
+    imfreq_ops ifops_;               ///< Host DLR imaginary frequency object
+    nda::cumatrix<dcomplex> cf2if_z; ///< Transformation from DLR coefficients to grid values
+    nda::cumatrix<dcomplex> if2cf_z; ///< Transformation from DLR grid values to coefficients
+  };
+
+  /**
+  * @class dyson_it_device
+  * @brief Solution of the Dyson equation in imaginary time on the device
+  *
+  * Device counterpart of dyson_it::solve: the system matrix I - G0 * Sig is
+  * formed with cuBLAS, and factorized and solved with cuSOLVER through
+  * nda::lapack::getrf and nda::lapack::getrs. The free Green's function, its
+  * convolution matrix and the right hand side are kept on the device, and
+  * solve performs no host <-> device transfers.
+  *
+  * @tparam S Scalar type of Green's functions (double or dcomplex)
+  *
+  * \note The matrix of convolution by a Green's function is linear in its DLR
+  * coefficients: its (k, a; m, b) entry is sum_l W(k, m, l) fc(l, a, b), where
+  * W(_, _, l) is the scalar convolution matrix of the l-th DLR basis function.
+  * The r x r x r tensor W is computed once on the host by the constructor and
+  * kept on the device, and solve builds the matrix of convolution by the
+  * self-energy from its DLR coefficients with r * norb products of r x r and
+  * r x norb matrices.
+  *
+  * \note The solver keeps a pointer to the imtime_ops_device object passed to
+  * the constructor, which must outlive the solver.
+  */
+  template <nda::Scalar S> class dyson_it_device {
+
+    public:
+    /**
+    * @brief Constructor for dyson_it_device
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] itops DLR imaginary time object on the device; must outlive
+    * the solver
+    * @param[in] g0 Free Green's function at DLR imaginary time nodes, in host
+    * memory, e.g. as computed by free_gf
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) Dyson equation
+    */
+    dyson_it_device(double beta, imtime_ops_device const &itops, nda::array<S, 3> const &g0, bool time_order = false)
+       : beta(beta), itops_ptr(&itops), time_order(time_order), norb(g0.shape(1)) {
+
+      int r = itops.rank();
+      if (g0.shape(0) != r || g0.shape(2) != norb) throw std::runtime_error("Free Green's function must have shape (r, norb, norb).");
+
+      g0mat = nda::to_device(itops.host().convmat(beta, Fermion, itops.host().vals2coefs(g0), time_order));
+
+      // Scalar convolution matrices of DLR basis functions, W(k, m, l)
+      auto w_h = nda::array<S, 3>(r, r, r);
+      auto e   = nda::vector<double>(r);
+      for (int l = 0; l < r; ++l) {
+        e            = 0;
+        e(l)         = 1;
+        w_h(_, _, l) = itops.host().convmat(beta, Fermion, e, time_order);
+      }
+      wconv = nda::to_device(w_h);
+
+      // Right hand side with indices transposed for compatibility with LAPACK,
+      // as in dyson_it
+      auto rhs_h = nda::array<S, 3>(norb, r, norb);
+      rhs_h      = nda::permuted_indices_view<nda::encode<3>({1, 2, 0})>(g0);
+      rhs        = nda::to_device(rhs_h);
+
+      eye_n    = nda::to_device(nda::matrix<S>(nda::eye<S>(r * norb)));
+      eye_norb = nda::to_device(nda::matrix<S>(nda::eye<S>(norb)));
+    }
+
+    /**
+    * @brief Solve Dyson equation for given self-energy on the device
+    *
+    * @param[in] sig Self-energy at DLR imaginary time nodes, in device memory,
+    * with shape (r, norb, norb)
+    *
+    * @return Green's function at DLR imaginary time nodes, in device memory
+    */
+    template <nda::MemoryArrayOfRank<3> Tsig>
+      requires(nda::mem::on_device<Tsig>)
+    nda::cuarray<S, 3> solve(Tsig const &sig) const {
+
+      int r  = itops_ptr->rank();
+      long n = r * norb; // Dimension of system matrix
+
+      CPPDLR_PROBE("dyson_it_device::solve", 2 * n * n * sizeof(S), instrument::fma_flops<S> * ((2.0 / 3 + 2) * n + r) * n * n);
+
+      // Matrix of convolution by self-energy, sigmat(k, a, m, b) = sum_l
+      // wconv(k, m, l) * sigc(l, a, b)
+      auto sigc   = itops_ptr->vals2coefs(sig);
+      auto sigmat = nda::cuarray<S, 4>(r, norb, r, norb);
+      for (int k = 0; k < r; ++k) {
+        for (int a = 0; a < norb; ++a) { nda::blas::gemm(S(1), wconv(k, _, _), sigc(_, a, _), S(0), sigmat(k, a, _, _)); }
+      }
+
+      // System matrix I - G0 * Sig, and its LU factorization
+      auto sysmat = nda::cumatrix<S>(eye_n);
+      nda::blas::gemm(S(-1), g0mat, nda::reshape(sigmat, n, n), S(1), sysmat);
+      auto ipiv = nda::cuvector<int>(n);
+      nda::lapack::getrf(sysmat, ipiv);
+
+      // Back solve, in the transposed layout of the right hand side
+      auto x    = nda::cuarray<S, 3>(rhs);
+      auto x_rs = nda::reshape(x, norb, n);
+      nda::lapack::getrs(sysmat, x_rs, ipiv);
+
+      // Undo transposition of indices with a product by the identity, which
+      // cuBLAS performs with a transposed operand
+      auto g = nda::cuarray<S, 3>(r, norb, norb);
+      nda::blas::gemm(S(1), nda::transpose(x_rs), eye_norb, S(0), nda::reshape(g, n, norb));
+
+      return g;
+    }
+
+    private:
+    double beta;                        ///< Inverse temperature
+    imtime_ops_device const *itops_ptr; ///< DLR imaginary time object on the device
+    bool time_order;                    ///< Flag for ordinary or time-ordered Dyson equation
+    long norb;                          ///< Number of orbital indices
+    nda::cumatrix<S> g0mat;             ///< Matrix of convolution by free Green's function
+    nda::cuarray<S, 3> wconv;           ///< Scalar convolution matrices of DLR basis functions
+    nda::cuarray<S, 3> rhs;             ///< Right hand side of Dyson equation, indices transposed
+    nda::cumatrix<S> eye_n;             ///< Identity of dimension r * norb
+    nda::cumatrix<S> eye_norb;          ///< Identity of dimension norb
+  };
+
+} // namespace cppdlr
+
+#endif // NDA_HAVE_CUDA
@@ -18,10 +18,16 @@
 #include "nda/layout_transforms.hpp"
 #include <nda/nda.hpp>
 #include <cppdlr/dlr_imtime.hpp>
+#include <cppdlr/dlr_imfreq.hpp>
 #include <cppdlr/dlr_kernels.hpp>
+#include <cppdlr/dlr_mpi.hpp>
+#include <cppdlr/instrument.hpp>
 
 #include <nda/linalg/eigenelements.hpp>
+#include <numbers>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace cppdlr {
 
@@ -49,20 +55,18 @@ namespace cppdlr {
     * \note Hamiltonian must either be a symmetric matrix, a Hermitian matrix,
     * or a real scalar.
     */
-    dyson_it(double beta, imtime_ops itops, Ht const &h, double mu = 0, bool time_order = false)
+    dyson_it(double beta, imtime_ops const &itops, Ht const &h, double mu = 0, bool time_order = false)
        : beta(beta), itops_ptr(std::make_shared<imtime_ops>(itops)), time_order(time_order) {
 
-      // dyson_it object contains a shared pointer to the imtime_ops object
-      // itops. This is done to avoid making a copy of itops, which is meant to
-      // handle all imaginary time operations on the given DLR imaginary time
-      // grid.
+      // dyson_it object contains a shared pointer to a copy of the imtime_ops
+      // object itops. Copies of imtime_ops share the underlying DLR basis data,
+      // so this does not duplicate the DLR nodes and transformation matrices,
+      // and many dyson_it objects (e.g. one per k-point or block) can be built
+      // from the same itops cheaply.
 
       int r    = itops_ptr->rank();                       // DLR rank
       auto g0  = free_gf(beta, itops, h, mu, time_order); // Free Green's function (right hand side of Dyson equation
-      auto g0c = itops_ptr->vals2coefs(g0);               // DLR coefficients of free Green's function
-
-      // Get matrix of convolution by free Green's function
-      g0mat = itops_ptr->convmat(beta, Fermion, g0c, time_order);
+      g0c      = itops_ptr->vals2coefs(g0);               // DLR coefficients of free Green's function
 
       // Get right hand side of Dyson equation
       if constexpr (std::floating_point<Ht>) { // If h is real scalar, rhs is a vector
@@ -86,7 +90,7 @@ namespace cppdlr {
     * \note Hamiltonian must either be a symmetric matrix, a Hermitian matrix,
     * or a real scalar.
     */
-    dyson_it(double beta, imtime_ops itops, Ht const &h, bool time_order) : dyson_it(beta, itops, h, 0, time_order){};
+    dyson_it(double beta, imtime_ops const &itops, Ht const &h, bool time_order) : dyson_it(beta, itops, h, 0, time_order){};
 
     /**
     * @brief Solve Dyson equation for given self-energy
@@ -105,17 +109,13 @@ namespace cppdlr {
     // (real if both are real, complex otherwise).
     template <nda::MemoryArray Tsig, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>> Tg solve(Tsig const &sig) const {
 
-      int r     = itops_ptr->rank();          // DLR rank
-      auto sigc = itops_ptr->vals2coefs(sig); // DLR coefficients of self-energy
+      CPPDLR_PROBE("dyson_it::solve", sig.size() * sizeof(nda::get_value_t<Tg>),
+                   instrument::fma_flops<nda::get_value_t<Tg>> * sig.size() * itops_ptr->rank() * norb);
 
-      // Obtain Dyson equation system matrix I - G0 * Sig, where G0 and Sig are the
-      // matrices of convolution by the free Green's function and self-energy,
-      // respectively.
-      auto sysmat = make_regular(nda::eye<double>(r * norb) - g0mat * itops_ptr->convmat(beta, Fermion, sigc, time_order));
+      int r = itops_ptr->rank(); // DLR rank
 
-      // Factorize system matrix
-      auto ipiv = nda::vector<int>(r * norb);
-      nda::lapack::getrf(sysmat, ipiv);
+      // Obtain and factorize Dyson equation system matrix
+      auto [sysmat, ipiv] = factorize(sig);
 
       // Solve Dyson equation
       auto g    = Tg(sig.shape());                                                    // Declare Green's function
@@ -129,7 +129,371 @@ namespace cppdlr {
       }
     }
 
+#ifdef CPPDLR_USE_MPI
+    /**
+    * @brief Solve Dyson equation for given self-energy, distributed over the
+    * ranks of an MPI communicator
+    *
+    * Same as solve(Tsig const &), but the system matrix I - G0 * Sig is
+    * distributed over a ScaLAPACK process grid of the ranks of @p comm (see
+    * blacs_grid), in 2D block-cyclic layout with blocks of size nb x nb, where
+    * nb is the multiple of norb closest to @p blksz. Each rank builds only its
+    * local blocks of the matrices of convolution by the free Green's function
+    * and the self-energy, from the block rows given by
+    * imtime_ops::convmat_rows; the system matrix is formed by a distributed
+    * matrix product (p?gemm), and the system is solved by p?gesv.
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] sig Self-energy at DLR imaginary time nodes; must be the same
+    * on all ranks
+    * @param[in] comm MPI communicator; all of its ranks must call this method
+    * @param[in] blksz Approximate block size of block-cyclic layout (default
+    * = 64)
+    *
+    * @return Green's function at DLR imaginary time nodes, on all ranks
+    *
+    * \note Each rank stores its local blocks of three distributed (r * norb) x
+    * (r * norb) matrices, i.e. O((r * norb)^2 / # ranks) entries, and one block
+    * row of a convolution matrix at a time. The full matrix of convolution by
+    * the free Green's function, used by the other solve methods, is built
+    * lazily, and so is never formed by this method. The ranks of a process row
+    * each build the same block rows of the convolution matrices, and keep their
+    * own columns.
+    */
+    template <nda::MemoryArray Tsig, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>>
+    Tg solve(Tsig const &sig, MPI_Comm comm, int blksz = 64) const {
+
+      using S = nda::get_value_t<Tg>;
+
+      int r  = itops_ptr->rank(); // DLR rank
+      long n = r * norb;          // Dimension of system matrix
+
+      CPPDLR_PROBE("dyson_it::solve_mpi", 3.0 * n * n * sizeof(S), instrument::fma_flops<S> * (2.0 / 3 + 1) * n * n * n);
+
+      // Process grid, with blocks consisting of whole block rows of norb rows
+      int nb = norb * std::max(1, int(std::lround(double(blksz) / norb)));
+      blacs_grid grid(comm, nb);
+      long nrl = grid.local_rows(n);
+      long ncl = grid.local_cols(n);
+
+      // Local blocks of matrices of convolution by free Green's function and
+      // self-energy, built one block row at a time
+      auto sigc   = itops_ptr->vals2coefs(sig);
+      auto g0loc  = nda::matrix<S, F_layout>(nrl, ncl);
+      auto sigloc = nda::matrix<S, F_layout>(nrl, ncl);
+      for (long i0 = 0; i0 < nrl; i0 += nb) {
+        long ig      = grid.global_row(i0);          // First global row of block, a multiple of norb
+        long nbi     = std::min<long>(nb, nrl - i0); // Number of rows of block
+        auto rows    = nda::range(ig / norb, (ig + nbi) / norb);
+        auto g0rows  = itops_ptr->convmat_rows(beta, Fermion, g0c, rows, time_order);
+        auto sigrows = itops_ptr->convmat_rows(beta, Fermion, sigc, rows, time_order);
+        for (long j = 0; j < ncl; ++j) {
+          long jg = grid.global_col(j);
+          for (long i = 0; i < nbi; ++i) {
+            g0loc(i0 + i, j)  = g0rows(i, jg);
+            sigloc(i0 + i, j) = sigrows(i, jg);
+          }
+        }
+      }
+
+      // Local blocks of system matrix I - G0 * Sig
+      auto a = nda::matrix<S, F_layout>(nrl, ncl);
+      for (long j = 0; j < ncl; ++j) {
+        for (long i = 0; i < nrl; ++i) { a(i, j) = (grid.global_row(i) == grid.global_col(j) ? 1 : 0); }
+      }
+      pgemm(grid, n, n, n, S(-1), g0loc, sigloc, S(1), a);
+
+      // Local blocks of right hand side, as r*norb x norb matrix with entries
+      // G0(k, a; b), overwritten by solution
+      long nrhsl = grid.local_cols(norb);
+      auto x     = nda::matrix<S, F_layout>(nrl, nrhsl);
+      for (long j = 0; j < nrhsl; ++j) {
+        for (long i = 0; i < nrl; ++i) {
+          long ig = grid.global_row(i);
+          if constexpr (std::floating_point<Ht>) {
+            x(i, j) = rhs(ig);
+          } else {
+            x(i, j) = rhs(grid.global_col(j), ig / norb, ig % norb);
+          }
+        }
+      }
+      pgesv(grid, n, norb, a, x);
+
+      // Assemble solution on all ranks
+      auto gm = nda::matrix<S>(n, norb);
+      gm      = 0;
+      for (long j = 0; j < nrhsl; ++j) {
+        for (long i = 0; i < nrl; ++i) { gm(grid.global_row(i), grid.global_col(j)) = x(i, j); }
+      }
+      MPI_Allreduce(MPI_IN_PLACE, gm.data(), int(gm.size() * (nda::is_complex_v<S> ? 2 : 1)), MPI_DOUBLE, MPI_SUM, comm);
+
+      auto g = Tg(sig.shape());
+      if constexpr (std::floating_point<Ht>) {
+        g = gm(_, 0);
+      } else {
+        g = nda::reshape(gm, r, norb, norb);
+      }
+
+      return g;
+    }
+#endif // CPPDLR_USE_MPI
+
+    /**
+    * @brief Solve Dyson equation for given self-energy by preconditioned GMRES
+    *
+    * The Dyson equation G - G0 * Sig * G = G0 is solved iteratively, with
+    * both convolutions applied by the O(r^2) algorithm of
+    * imtime_ops::convolve, so that the (r*norb) x (r*norb) system matrix is
+    * never formed or factorized. This is advantageous in self-consistent
+    * iterations, in which the solution from the previous iteration is a good
+    * initial guess, and for large numbers of orbitals.
+    *
+    * @tparam Tsig Type of self-energy
+    * @tparam Tginit Type of initial guess
+    * @param[in] sig Self-energy at DLR imaginary time nodes
+    * @param[in] g_init Initial guess for Green's function at DLR imaginary time
+    * nodes
+    * @param[in] tol Tolerance on relative residual of Dyson equation (default
+    * 1e-12)
+    * @param[in] maxiter Maximum number of GMRES iterations (default 200)
+    *
+    * @return Green's function at DLR imaginary time nodes, number of iterations,
+    * and relative residual
+    *
+    * \note If a preconditioner has been set by set_preconditioner, it is
+    * applied on the right. Free Green's function (right hand side of Dyson
+    * equation) specified at construction of dyson_it object.
+    */
+    template <nda::MemoryArray Tsig, nda::MemoryArray Tginit, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>>
+    std::tuple<Tg, int, double> solve_iterative(Tsig const &sig, Tginit const &g_init, double tol = 1e-12, int maxiter = 200) const {
+
+      CPPDLR_PROBE("dyson_it::solve_iterative", 8 * sig.size() * sizeof(nda::get_value_t<Tg>), 0);
+
+      using S    = nda::get_value_t<Tg>;
+      auto shape = sig.shape();
+      auto sigc  = itops_ptr->vals2coefs(sig); // DLR coefficients of self-energy
+
+      // Apply Dyson operator G -> G - G0 * Sig * G to flattened Green's function
+      auto apply_a = [&](nda::vector<S> const &v) {
+        auto g  = Tg(nda::reshape(v, shape));
+        auto sg = itops_ptr->convolve(beta, Fermion, sigc, itops_ptr->vals2coefs(g), time_order);
+        g -= itops_ptr->convolve(beta, Fermion, g0c, itops_ptr->vals2coefs(sg), time_order);
+        return nda::vector<S>(nda::reshape(g, v.size()));
+      };
+
+      // Apply preconditioner, if any, to flattened Green's function
+      auto apply_m = [&](nda::vector<S> const &v) {
+        if (pcpiv.size() == 0) return nda::vector<S>(v);
+        auto g = Tg(nda::reshape(v, shape));
+        precondition(g);
+        return nda::vector<S>(nda::reshape(g, v.size()));
+      };
+
+      auto g0 = Tg(itops_ptr->coefs2vals(g0c)); // Right hand side of Dyson equation
+      auto b  = nda::vector<S>(nda::reshape(g0, g0.size()));
+      auto g  = Tg(g_init);
+      auto x  = nda::vector<S>(nda::reshape(g, g.size()));
+
+      auto [niter, resid] = gmres<S>(apply_a, apply_m, b, x, tol, maxiter);
+
+      return {Tg(nda::reshape(x, shape)), niter, resid};
+    }
+
+    /**
+    * @brief Solve Dyson equation for given self-energy by preconditioned GMRES,
+    * using free Green's function as initial guess
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] sig Self-energy at DLR imaginary time nodes
+    * @param[in] tol Tolerance on relative residual of Dyson equation (default
+    * 1e-12)
+    * @param[in] maxiter Maximum number of GMRES iterations (default 200)
+    *
+    * @return Green's function at DLR imaginary time nodes, number of iterations,
+    * and relative residual
+    */
+    template <nda::MemoryArray Tsig, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>>
+    std::tuple<Tg, int, double> solve_iterative(Tsig const &sig, double tol = 1e-12, int maxiter = 200) const {
+      return solve_iterative(sig, Tg(itops_ptr->coefs2vals(g0c)), tol, maxiter);
+    }
+
+    /**
+    * @brief Solve Dyson equation for given self-energy by mixed-precision
+    * iterative refinement
+    *
+    * The Dyson equation system matrix I - G0 * Sig is factorized in single
+    * precision (see lu_single), and the solution is refined in double
+    * precision: at each step, the residual of the Dyson equation G - G0 * Sig
+    * * G = G0 is computed in double precision, with both convolutions applied
+    * by imtime_ops::convolve as in solve_iterative, and a correction is
+    * obtained from the single precision factorization. Each step reduces the
+    * error by a factor of roughly the condition number of the system matrix
+    * times single precision machine epsilon, so for the well-conditioned
+    * systems typical of the Dyson equation a few steps reach double precision
+    * accuracy, while the factorization costs about half as much as in solve.
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] sig Self-energy at DLR imaginary time nodes
+    * @param[in] tol Tolerance on relative residual of Dyson equation (default
+    * 1e-12)
+    * @param[in] maxiter Maximum number of refinement steps (default 10)
+    *
+    * @return Green's function at DLR imaginary time nodes, number of
+    * refinement steps, and relative residual
+    */
+    template <nda::MemoryArray Tsig, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>>
+    std::tuple<Tg, int, double> solve_mixed(Tsig const &sig, double tol = 1e-12, int maxiter = 10) const {
+
+      [[maybe_unused]] double n = itops_ptr->rank() * norb; // Dimension of system matrix
+      CPPDLR_PROBE("dyson_it::solve_mixed", n * n * sizeof(nda::get_value_t<Tg>), (2.0 / 3 + 2) * n * n * n);
+
+      using S = nda::get_value_t<Tg>;
+      int r   = itops_ptr->rank(); // DLR rank
+
+      auto sigc = Tg(itops_ptr->vals2coefs(sig)); // DLR coefficients of self-energy
+      auto g0cs = Tg(g0c);                        // DLR coefficients of free Green's function
+
+      // Single precision factorization of system matrix
+      auto lu = lu_single<S>(nda::matrix<S>(nda::eye<double>(r * norb) - get_g0mat() * itops_ptr->convmat(beta, Fermion, sigc, time_order)));
+
+      // Apply Dyson operator G -> G - G0 * Sig * G
+      auto apply_a = [&](Tg const &g) {
+        auto sg = Tg(itops_ptr->convolve(beta, Fermion, sigc, itops_ptr->vals2coefs(g), time_order));
+        return Tg(g - itops_ptr->convolve(beta, Fermion, g0cs, itops_ptr->vals2coefs(sg), time_order));
+      };
+      auto nrm = [](Tg const &g) {
+        auto v = nda::reshape(g, g.size());
+        return std::sqrt(std::real(nda::blas::dotc(v, v)));
+      };
+
+      auto g0   = Tg(itops_ptr->coefs2vals(g0cs)); // Right hand side of Dyson equation
+      auto g    = Tg(g0.shape());
+      auto res  = Tg(g0); // Residual of initial guess g = 0
+      g         = 0;
+      int niter = 0;
+      double b  = nrm(g0), resid = 1;
+
+      while (resid >= tol && niter < maxiter) {
+        auto d = Tg(res);
+        lu.solve(nda::matrix_view<S>(nda::reshape(d, r * norb, d.size() / (r * norb))));
+        g += d;
+        res   = g0 - apply_a(g);
+        resid = nrm(res) / b;
+        ++niter;
+      }
+
+      return {g, niter, resid};
+    }
+
+    /**
+    * @brief Set preconditioner for solve_iterative
+    *
+    * The preconditioner is the inverse of the Dyson equation system matrix for
+    * the given self-energy, applied using its LU factorization. In a
+    * self-consistent iteration, it may be computed once for a self-energy from
+    * an early iteration and reused for many subsequent solves.
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] sig Self-energy at DLR imaginary time nodes
+    */
+    template <nda::MemoryArray Tsig> void set_preconditioner(Tsig const &sig) {
+
+      auto [sysmat, ipiv] = factorize(sig);
+      if constexpr (nda::is_complex_v<nda::get_value_t<decltype(sysmat)>>) {
+        pclu_z = sysmat;
+        pclu_r = nda::matrix<double>();
+      } else {
+        pclu_r = sysmat;
+        pclu_z = nda::matrix<dcomplex>();
+      }
+      pcpiv = ipiv;
+    }
+
+    /**
+    * @brief Remove preconditioner for solve_iterative
+    */
+    void clear_preconditioner() {
+      pclu_r = nda::matrix<double>();
+      pclu_z = nda::matrix<dcomplex>();
+      pcpiv  = nda::vector<int>();
+    }
+
     private:
+    /**
+    * @brief Get matrix of convolution by free Green's function, building it on
+    * first use
+    */
+    nda::matrix<Sh> const &get_g0mat() const {
+      g0mat_once.call_once([this] { g0mat = itops_ptr->convmat(beta, Fermion, g0c, time_order); });
+      return g0mat;
+    }
+
+    /**
+    * @brief Obtain Dyson equation system matrix I - G0 * Sig, where G0 and Sig
+    * are the matrices of convolution by the free Green's function and
+    * self-energy, respectively, and compute its LU factorization
+    */
+    template <nda::MemoryArray Tsig> auto factorize(Tsig const &sig) const {
+
+      [[maybe_unused]] double n = itops_ptr->rank() * norb; // Dimension of system matrix
+      CPPDLR_PROBE("dyson_it::factorize", 2 * n * n * sizeof(Sh), (2.0 / 3 + 2) * n * n * n);
+
+      int r     = itops_ptr->rank();          // DLR rank
+      auto sigc = itops_ptr->vals2coefs(sig); // DLR coefficients of self-energy
+
+      auto sysmat = make_regular(nda::eye<double>(r * norb) - get_g0mat() * itops_ptr->convmat(beta, Fermion, sigc, time_order));
+      auto ipiv   = nda::vector<int>(r * norb);
+      nda::lapack::getrf(sysmat, ipiv);
+
+      return std::make_pair(std::move(sysmat), std::move(ipiv));
+    }
+
+    /**
+    * @brief Apply preconditioner in place to Green's function at DLR imaginary
+    * time nodes
+    */
+    template <nda::MemoryArray Tg> void precondition(Tg &g) const {
+
+      using S = nda::get_value_t<Tg>;
+      int r   = itops_ptr->rank();
+
+      // Transpose some indices for compatibility w/ LAPACK, as in solve
+      auto y = nda::array<S, Tg::rank>(g.shape());
+      if constexpr (std::floating_point<Ht>) {
+        y = g;
+      } else {
+        y.resize(norb, r, norb);
+        y = permuted_indices_view<nda::encode<3>({1, 2, 0})>(g);
+      }
+      auto y_rs = nda::matrix_view<S>(nda::reshape(y, norb, r * norb));
+
+      if (pclu_r.size() > 0) {
+        if constexpr (nda::is_complex_v<S>) { // Apply real factorization to real and imaginary parts separately
+          auto yr = nda::matrix<double>(real(y_rs));
+          auto yi = nda::matrix<double>(imag(y_rs));
+          nda::lapack::getrs(pclu_r, yr, pcpiv);
+          nda::lapack::getrs(pclu_r, yi, pcpiv);
+          y_rs = yr + 1i * yi;
+        } else {
+          nda::lapack::getrs(pclu_r, y_rs, pcpiv);
+        }
+      } else {
+        if constexpr (nda::is_complex_v<S>) {
+          nda::lapack::getrs(pclu_z, y_rs, pcpiv);
+        } else { // Complex factorization for real Green's function; keep real part
+          auto yz = nda::matrix<dcomplex>(y_rs);
+          nda::lapack::getrs(pclu_z, yz, pcpiv);
+          y_rs = real(yz);
+        }
+      }
+
+      if constexpr (std::floating_point<Ht>) {
+        g = y;
+      } else {
+        g = permuted_indices_view<nda::encode<3>({2, 0, 1})>(y);
+      }
+    }
+
     double beta;                           ///< Inverse temperature
     std::shared_ptr<imtime_ops> itops_ptr; ///< shared pointer to imtime_ops object
     int norb;                              ///< Number of orbital indices
@@ -137,9 +501,51 @@ namespace cppdlr {
 
     typename std::conditional_t<std::floating_point<Ht>, nda::array<Sh, 1>, nda::array<Sh, 3>>
        rhs; ///< Right hand side of Dyson equation (in format compatible w/ LAPACK); vector if Hamiltonian is scalar, rank-3 array otherwise
-    nda::matrix<Sh> g0mat; ///< Matrix of convolution by free Green's function
+    typename std::conditional_t<std::floating_point<Ht>, nda::array<Sh, 1>, nda::array<Sh, 3>>
+       g0c;                        ///< DLR coefficients of free Green's function; vector if Hamiltonian is scalar, rank-3 array otherwise
+    mutable nda::matrix<Sh> g0mat; ///< Matrix of convolution by free Green's function; built on first use
+    mutable init_flag g0mat_once;  ///< Initialization of g0mat
+    nda::matrix<double> pclu_r;    ///< LU factors of real preconditioner for solve_iterative
+    nda::matrix<dcomplex> pclu_z;  ///< LU factors of complex preconditioner for solve_iterative
+    nda::vector<int> pcpiv;        ///< LU pivots of preconditioner; empty if no preconditioner is set
   };
 
+  /**
+  * @brief Compute free-particle imaginary time Green's function for a given
+  * block-diagonal Hamiltonian, block by block
+  *
+  * @param[in] beta Inverse temperature
+  * @param[in] it imtime_ops object
+  * @param[in] h Block-diagonal Hamiltonian
+  * @param[in] blocks Block sizes, summing to the dimension of h, e.g. as
+  * obtained by find_blocks
+  * @param[in] mu Chemical potential (default = 0)
+  * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+  * time-ordered (true or TIME_ORDERED) Dyson equation, which changes free
+  * Green's function
+  *
+  * @return List of diagonal blocks of Green's function at DLR imaginary time
+  * nodes
+  *
+  * \note Off-diagonal blocks of h are ignored.
+  */
+  template <nda::MemoryMatrix Ht, nda::Scalar S = nda::get_value_t<Ht>>
+  std::vector<nda::array<S, 3>> free_gf(double beta, imtime_ops const &itops, Ht const &h, std::vector<int> const &blocks, double mu = 0,
+                                        bool time_order = false) {
+
+    if (std::accumulate(blocks.begin(), blocks.end(), 0) != h.shape(0)) throw std::runtime_error("Block sizes must sum to dimension of Hamiltonian.");
+
+    auto g = std::vector<nda::array<S, 3>>();
+    g.reserve(blocks.size());
+    int o = 0; // Offset of current block
+    for (int n : blocks) {
+      g.push_back(free_gf(beta, itops, nda::matrix<S>(h(range(o, o + n), range(o, o + n))), mu, time_order));
+      o += n;
+    }
+
+    return g;
+  }
+
   /**
   * @brief Compute free-particle imaginary time Green's function for a given
   * Hamiltonian
@@ -226,4 +632,294 @@ namespace cppdlr {
     return free_gf(beta, itops, h, 0, time_order);
   };
 
+  /**
+  * @class dyson_it_block
+  * @brief Class for solving Dyson equation in imaginary time for a
+  * block-diagonal Hamiltonian and self-energy
+  *
+  * The Dyson equation is solved independently for each diagonal block, so
+  * that the cost of a solve is a sum over blocks of the cost of
+  * dyson_it::solve, rather than that of a solve for the full number of
+  * orbitals.
+  *
+  * @tparam Ht Type of Hamiltonian
+  */
+  template <nda::MemoryMatrix Ht, nda::Scalar Sh = get_value_t<Ht>> class dyson_it_block {
+
+    public:
+    /**
+    * @brief Constructor for dyson_it_block
+    * @param[in] beta Inverse temperature
+    * @param[in] itops DLR imaginary time object
+    * @param[in] h Block-diagonal Hamiltonian
+    * @param[in] blocks Block sizes, summing to the dimension of h
+    * @param[in] mu Chemical potential (default = 0)
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) Dyson equation
+    *
+    * \note Hamiltonian must either be a symmetric or a Hermitian matrix.
+    * Off-diagonal blocks of h are ignored.
+    */
+    dyson_it_block(double beta, imtime_ops const &itops, Ht const &h, std::vector<int> blocks, double mu = 0, bool time_order = false)
+       : blocks(blocks) {
+
+      if (std::accumulate(blocks.begin(), blocks.end(), 0) != h.shape(0)) {
+        throw std::runtime_error("Block sizes must sum to dimension of Hamiltonian.");
+      }
+
+      dys.reserve(blocks.size());
+      int o = 0; // Offset of current block
+      for (int n : blocks) {
+        dys.emplace_back(beta, itops, nda::matrix<Sh>(h(range(o, o + n), range(o, o + n))), mu, time_order);
+        o += n;
+      }
+    }
+
+    /**
+    * @brief Constructor for dyson_it_block, with block structure determined
+    * from the Hamiltonian by find_blocks
+    * @param[in] beta Inverse temperature
+    * @param[in] itops DLR imaginary time object
+    * @param[in] h Block-diagonal Hamiltonian
+    * @param[in] mu Chemical potential (default = 0)
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) Dyson equation
+    */
+    dyson_it_block(double beta, imtime_ops const &itops, Ht const &h, double mu = 0, bool time_order = false)
+       : dyson_it_block(beta, itops, h, find_blocks(h), mu, time_order) {}
+
+    /**
+    * @brief Constructor for dyson_it_block, with block structure determined
+    * from the Hamiltonian by find_blocks
+    * @param[in] beta Inverse temperature
+    * @param[in] itops DLR imaginary time object
+    * @param[in] h Block-diagonal Hamiltonian
+    * @param[in] time_order Flag for ordinary (false or ORDINARY) or
+    * time-ordered (true or TIME_ORDERED) Dyson equation
+    */
+    dyson_it_block(double beta, imtime_ops const &itops, Ht const &h, bool time_order) : dyson_it_block(beta, itops, h, 0, time_order) {}
+
+    /**
+    * @brief Solve Dyson equation for given block-diagonal self-energy, block by
+    * block
+    *
+    * @tparam Tsig Type of self-energy blocks
+    * @param[in] sig List of diagonal blocks of self-energy at DLR imaginary time
+    * nodes
+    * @param[in] nthreads Number of threads over which the solves for the
+    * diagonal blocks are distributed (default = 1); only used if cppdlr is
+    * built with OpenMP
+    *
+    * @return List of diagonal blocks of Green's function at DLR imaginary time
+    * nodes
+    */
+    template <nda::MemoryArray Tsig, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>>
+    std::vector<Tg> solve(std::vector<Tsig> const &sig, [[maybe_unused]] int nthreads = 1) const {
+
+      if (sig.size() != dys.size()) throw std::runtime_error("Number of self-energy blocks must equal number of Hamiltonian blocks.");
+
+      int nb = sig.size();
+      auto g = std::vector<Tg>(nb);
+#ifdef CPPDLR_USE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) if (nthreads > 1 && nb > 1)
+#endif
+      for (int i = 0; i < nb; ++i) { g[i] = dys[i].solve(sig[i]); }
+
+      return g;
+    }
+
+    /**
+    * @brief Solve Dyson equation for given block-diagonal self-energy
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] sig Self-energy at DLR imaginary time nodes, of shape (r,
+    * norb, norb)
+    * @param[in] nthreads Number of threads over which the solves for the
+    * diagonal blocks are distributed (default = 1); only used if cppdlr is
+    * built with OpenMP
+    *
+    * @return Green's function at DLR imaginary time nodes, with zero
+    * off-diagonal blocks
+    *
+    * \note Off-diagonal blocks of sig are ignored.
+    */
+    template <nda::MemoryArrayOfRank<3> Tsig> auto solve(Tsig const &sig, int nthreads = 1) const {
+      return join_blocks(solve(split_blocks(sig, blocks), nthreads));
+    }
+
+    /**
+    * @brief Get block sizes
+    */
+    std::vector<int> const &get_blocks() const { return blocks; }
+
+    private:
+    std::vector<int> blocks;                    ///< Block sizes
+    std::vector<dyson_it<nda::matrix<Sh>>> dys; ///< Dyson solvers for diagonal blocks
+  };
+
+  /**
+  * @class dyson_if
+  * @brief Class for solving Dyson equation in imaginary frequency
+  *
+  * In imaginary frequency, the Dyson equation is diagonal in the Matsubara
+  * frequency index, G(i nu_n) = (i nu_n + mu - h - Sig(i nu_n))^(-1), so it is
+  * solved by r independent norb x norb inversions at the DLR imaginary
+  * frequency nodes, in O(r norb^3) operations, rather than by the dense solve
+  * of size r norb of dyson_it.
+  *
+  * Green's functions and self-energies given in imaginary time may be
+  * converted to and from the DLR imaginary frequency grid through their DLR
+  * coefficients (it2if, if2it); solve_it combines these, and may be used as a
+  * replacement for dyson_it::solve.
+  *
+  * \note The imfreq_ops object must be fermionic, and have been built from
+  * the same DLR frequencies as any imtime_ops object used with it.
+  *
+  * @tparam Ht Type of Hamiltonian
+  */
+  template <typename Ht, nda::Scalar Sh = std::conditional_t<std::floating_point<Ht>, Ht, get_value_t<Ht>>>
+    requires(std::floating_point<Ht> || nda::MemoryMatrix<Ht>)
+  class dyson_if {
+
+    public:
+    /**
+    * @brief Constructor for dyson_if
+    * @param[in] beta Inverse temperature
+    * @param[in] ifops DLR imaginary frequency object (fermionic)
+    * @param[in] h Hamiltonian
+    * @param[in] mu Chemical potential (default = 0)
+    *
+    * \note Hamiltonian must either be a symmetric matrix, a Hermitian matrix,
+    * or a real scalar.
+    */
+    dyson_if(double beta, imfreq_ops const &ifops, Ht const &h, double mu = 0) : beta(beta), ifops_ptr(std::make_shared<imfreq_ops>(ifops)) {
+
+      if (ifops.get_statistic() != Fermion) throw std::runtime_error("dyson_if requires a fermionic imfreq_ops object.");
+
+      int r = ifops.rank(); // DLR rank
+
+      // Inverse of free Green's function, i nu_n + mu - h, at DLR imaginary
+      // frequency nodes
+      if constexpr (std::floating_point<Ht>) {
+        norb  = 1;
+        g0inv = nda::array<dcomplex, 1>(r);
+        for (int n = 0; n < r; ++n) { g0inv(n) = nu(n) + mu - h; }
+      } else {
+        norb  = h.shape(0);
+        g0inv = nda::array<dcomplex, 3>(r, norb, norb);
+        for (int n = 0; n < r; ++n) {
+          g0inv(n, _, _) = -h;
+          for (int i = 0; i < norb; ++i) { g0inv(n, i, i) += nu(n) + mu; }
+        }
+      }
+    }
+
+    /**
+    * @brief Solve Dyson equation for given self-energy
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] sig Self-energy at DLR imaginary frequency nodes
+    * @param[in] nthreads Number of threads over which the inversions at the
+    * DLR imaginary frequency nodes are distributed (default = 1); only used if
+    * cppdlr is built with OpenMP
+    *
+    * @return Green's function at DLR imaginary frequency nodes
+    */
+    template <nda::MemoryArray Tsig> nda::array<dcomplex, nda::get_rank<Tsig>> solve(Tsig const &sig, [[maybe_unused]] int nthreads = 1) const {
+
+      static_assert(nda::get_rank<Tsig> == (std::floating_point<Ht> ? 1 : 3), "Self-energy must be rank 1 for scalar h, or rank 3 for matrix h.");
+
+      int r = ifops_ptr->rank(); // DLR rank
+      CPPDLR_PROBE("dyson_if::solve", 2 * sig.size() * sizeof(dcomplex), instrument::fma_flops<dcomplex> * (4.0 / 3) * r * norb * norb * norb);
+
+      if (sig.shape() != g0inv.shape()) throw std::runtime_error("Self-energy must have shape (r) for scalar h, or (r, norb, norb) for matrix h.");
+
+      auto g = nda::array<dcomplex, nda::get_rank<Tsig>>(sig.shape());
+
+      if constexpr (std::floating_point<Ht>) {
+        for (int n = 0; n < r; ++n) { g(n) = 1.0 / (g0inv(n) - sig(n)); }
+      } else {
+#ifdef CPPDLR_USE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(nthreads) if (nthreads > 1 && r > 1)
+#endif
+        for (int n = 0; n < r; ++n) {
+          auto a   = nda::matrix<dcomplex, F_layout>(g0inv(n, _, _) - sig(n, _, _));
+          auto b   = nda::matrix<dcomplex, F_layout>(nda::eye<dcomplex>(norb));
+          auto piv = nda::vector<int>(norb);
+          nda::lapack::getrf(a, piv);
+          nda::lapack::getrs(a, b, piv);
+          g(n, _, _) = b;
+        }
+      }
+
+      return g;
+    }
+
+    /**
+    * @brief Transform Green's function or self-energy from DLR imaginary time
+    * grid to DLR imaginary frequency grid
+    *
+    * @param[in] itops DLR imaginary time object
+    * @param[in] g Values at DLR imaginary time nodes
+    *
+    * @return Values at DLR imaginary frequency nodes
+    */
+    template <nda::MemoryArray T> auto it2if(imtime_ops const &itops, T const &g) const {
+      if (itops.rank() != ifops_ptr->rank()) throw std::runtime_error("DLR ranks of imtime_ops and imfreq_ops objects differ.");
+      return ifops_ptr->coefs2vals(beta, itops.vals2coefs(g));
+    }
+
+    /**
+    * @brief Transform Green's function or self-energy from DLR imaginary
+    * frequency grid to DLR imaginary time grid
+    *
+    * @param[in] itops DLR imaginary time object
+    * @param[in] g Values at DLR imaginary frequency nodes
+    *
+    * @return Values at DLR imaginary time nodes
+    */
+    template <nda::MemoryArray T> auto if2it(imtime_ops const &itops, T const &g) const {
+      if (itops.rank() != ifops_ptr->rank()) throw std::runtime_error("DLR ranks of imtime_ops and imfreq_ops objects differ.");
+      return itops.coefs2vals(ifops_ptr->vals2coefs(beta, g));
+    }
+
+    /**
+    * @brief Solve Dyson equation for given self-energy in imaginary time
+    *
+    * The self-energy is transformed to the DLR imaginary frequency grid, the
+    * Dyson equation is solved there, and the Green's function is transformed
+    * back to the DLR imaginary time grid.
+    *
+    * @tparam Tsig Type of self-energy
+    * @param[in] itops DLR imaginary time object
+    * @param[in] sig Self-energy at DLR imaginary time nodes
+    * @param[in] nthreads Number of threads for solve (default = 1)
+    *
+    * @return Green's function at DLR imaginary time nodes; real if both the
+    * Hamiltonian and the self-energy are real
+    */
+    template <nda::MemoryArray Tsig, nda::MemoryArray Tg = make_common_t<Tsig, Sh, nda::get_value_t<Tsig>>>
+    Tg solve_it(imtime_ops const &itops, Tsig const &sig, int nthreads = 1) const {
+      auto g = if2it(itops, solve(it2if(itops, sig), nthreads));
+      if constexpr (nda::is_complex_v<nda::get_value_t<Tg>>) {
+        return Tg(g);
+      } else {
+        return Tg(nda::real(g));
+      }
+    }
+
+    private:
+    /**
+    * @brief Get i nu_n at DLR imaginary frequency node @p n
+    */
+    dcomplex nu(int n) const { return (2 * ifops_ptr->get_ifnodes(n) + 1) * std::numbers::pi * 1i / beta; }
+
+    double beta;                           ///< Inverse temperature
+    std::shared_ptr<imfreq_ops> ifops_ptr; ///< shared pointer to imfreq_ops object
+    int norb;                              ///< Number of orbital indices
+
+    typename std::conditional_t<std::floating_point<Ht>, nda::array<dcomplex, 1>, nda::array<dcomplex, 3>>
+       g0inv; ///< Inverse of free Green's function at DLR imaginary frequency nodes; vector if Hamiltonian is scalar, rank-3 array otherwise
+  };
+
 } // namespace cppdlr
\ No newline at end of file
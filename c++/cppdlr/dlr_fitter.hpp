@@ -0,0 +1,223 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "cppdlr/dlr_imtime.hpp"
+#include "cppdlr/dlr_imfreq.hpp"
+#include "cppdlr/dlr_kernels.hpp"
+#include "cppdlr/instrument.hpp"
+#include "cppdlr/utils.hpp"
+
+#include <type_traits>
+
+namespace cppdlr {
+
+  /**
+  * @class dlr_fitter
+  * @brief Least squares fitting of DLR coefficients to data on a fixed
+  * scattered grid
+  *
+  * A QR factorization A = QR of the n x r sampling matrix A, whose columns are
+  * the DLR basis functions evaluated at the grid points, is computed once at
+  * construction. Each subsequent fit of data g on the same grid then costs a
+  * matrix-matrix product Q^H g and a triangular solve, rather than the
+  * construction of A and an SVD-based solve performed by
+  * imtime_ops::fitvals2coefs.
+  *
+  * Optionally, per-point weights w can be given, in which case the weighted
+  * residual |diag(w) (A gc - g)| is minimized. For data with error bars
+  * sigma_i, use w_i = 1 / sigma_i.
+  *
+  * @tparam S Scalar type of sampling matrix: double for imaginary time data,
+  * dcomplex for imaginary frequency data
+  *
+  * \note The QR factorization is computed by Gram-Schmidt with
+  * reorthogonalization, which assumes that A has full numerical rank. This is
+  * the case if the grid resolves the DLR basis functions, e.g. if it has at
+  * least as many points as the DLR rank, spread over the full interval.
+  */
+  template <nda::Scalar S> class dlr_fitter {
+
+    public:
+    /**
+    * @brief Constructor for fitting of imaginary time data
+    *
+    * @param[in] itops DLR imaginary time object
+    * @param[in] t Imaginary time grid points, in relative format
+    * @param[in] w Per-point weights (optional)
+    */
+    dlr_fitter(imtime_ops const &itops, nda::vector_const_view<double> t, nda::vector_const_view<double> w = {})
+      requires(std::is_same_v<S, double>)
+       : dlr_fitter(nda::matrix<double, F_layout>(itops.build_evalmat(t)), w) {}
+
+    /**
+    * @brief Constructor for fitting of imaginary frequency data
+    *
+    * @param[in] ifops DLR imaginary frequency object
+    * @param[in] n Imaginary frequency indices of grid points
+    * @param[in] w Per-point weights (optional)
+    */
+    dlr_fitter(imfreq_ops const &ifops, nda::vector_const_view<int> n, nda::vector_const_view<double> w = {})
+      requires(nda::is_complex_v<S>)
+       : dlr_fitter(nda::matrix<dcomplex, F_layout>(build_kmat_if(ifops, n)), w) {}
+
+    /**
+    * @brief Obtain DLR coefficients of a Green's function G from its values on
+    * the grid by least squares fitting
+    *
+    * @param[in] g Values of G on grid; first dimension must be the number of
+    * grid points, and the remaining dimensions (e.g. orbital indices, or a
+    * batch of data sets) are arbitrary
+    *
+    * @return DLR coefficients of G, with first dimension r and remaining
+    * dimensions same as @p g
+    */
+    template <nda::MemoryArray T, nda::Scalar Sg = nda::get_value_t<T>> auto fit(T const &g) const {
+
+      using Sc = std::conditional_t<nda::is_complex_v<S> || nda::is_complex_v<Sg>, dcomplex, double>; // Scalar type of coefficients
+
+      if (g.shape(0) != n) throw std::runtime_error("First dim of g must be equal to number of grid points.");
+      long m = g.size() / n;
+
+      CPPDLR_PROBE("dlr_fitter::fit", (n + r) * m * sizeof(Sc), instrument::fma_flops<Sc> * r * (n + r) * m);
+
+      // Reshape g to matrix w/ first dimension n, and apply weights
+      auto gw = nda::matrix<Sc>(nda::reshape(nda::array<Sg, nda::get_rank<T>>(g), n, m));
+      if (w.size() > 0) {
+        for (int i = 0; i < n; ++i) { gw(i, _) *= w(i); }
+      }
+
+      // Apply Q^H
+      auto y = nda::matrix<Sc>(r, m);
+      if constexpr (std::is_same_v<S, Sc>) {
+        nda::blas::gemm(1.0, qh, gw, 0.0, y);
+      } else { // Real Q^H, complex data
+        realgemm(1.0, qh, gw, 0.0, y);
+      }
+
+      // Solve R gc = Q^H g by back substitution
+      for (int j = r - 1; j >= 0; --j) {
+        for (int k = j + 1; k < r; ++k) { y(j, _) -= rr(j, k) * y(k, _); }
+        y(j, _) /= rr(j, j);
+      }
+
+      auto gc_shape          = g.shape(); // Output shape is same as g...
+      gc_shape[0]            = r;         // ...with first dimension n replaced by r
+      auto gc                = nda::array<Sc, nda::get_rank<T>>(gc_shape);
+      nda::reshape(gc, r, m) = y;
+
+      return gc;
+    }
+
+    /**
+    * @brief Obtain DLR coefficients of a Green's function G from its values on
+    * an imaginary frequency grid by least squares fitting, given inverse
+    * temperature
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] g Values of G on grid
+    *
+    * @return DLR coefficients of G
+    */
+    template <nda::MemoryArray T>
+      requires(nda::is_complex_v<S>)
+    auto fit(double beta, T const &g) const {
+      return fit(make_regular(g / beta));
+    }
+
+    /**
+    * @brief Get number of grid points
+    */
+    int size() const { return n; }
+
+    /**
+    * @brief Get DLR rank
+    */
+    int rank() const { return r; }
+
+    /**
+    * @brief Get R factor of QR factorization A = QR of (weighted) sampling
+    * matrix
+    *
+    * \note R^H R = A^H A is the Gram matrix of the (weighted) sampling matrix,
+    * so R is its Cholesky factor, obtained without forming A^H A.
+    */
+    nda::matrix_const_view<S> get_rfactor() const { return rr; }
+
+    private:
+    int n;                 ///< Number of grid points
+    int r;                 ///< DLR rank
+    nda::vector<double> w; ///< Per-point weights; empty if not given
+    nda::matrix<S> qh;     ///< Q^H, where A = QR is QR factorization of (weighted) sampling matrix
+    nda::matrix<S> rr;     ///< R factor of QR factorization
+
+    /**
+    * @brief Constructor from sampling matrix
+    */
+    dlr_fitter(nda::matrix<S, F_layout> a, nda::vector_const_view<double> w) : n(a.extent(0)), r(a.extent(1)), w(w) {
+
+      if (n < r) throw std::runtime_error("Number of grid points must be at least DLR rank r.");
+      if (w.size() > 0 && w.size() != n) throw std::runtime_error("Number of weights must be equal to number of grid points.");
+
+      for (int i = 0; i < w.size(); ++i) { a(i, _) *= w(i); }
+
+      // QR factorization by modified Gram-Schmidt on columns of a, with one
+      // step of reorthogonalization ("twice is enough")
+      rr = nda::matrix<S>(r, r);
+      rr = 0;
+      for (int j = 0; j < r; ++j) {
+        for (int pass = 0; pass < 2; ++pass) {
+          for (int i = 0; i < j; ++i) {
+            S c = nda::blas::dotc(a(_, i), a(_, j));
+            a(_, j) -= c * a(_, i);
+            rr(i, j) += c;
+          }
+        }
+        rr(j, j) = std::sqrt(std::real(nda::blas::dotc(a(_, j), a(_, j))));
+        if (std::abs(rr(j, j)) == 0) throw std::runtime_error("Sampling matrix is rank deficient.");
+        a(_, j) /= rr(j, j);
+      }
+
+      if constexpr (nda::is_complex_v<S>) {
+        qh = nda::matrix<S>(transpose(conj(a)));
+      } else {
+        qh = nda::matrix<S>(transpose(a));
+      }
+    }
+
+    /**
+    * @brief Build imaginary frequency sampling matrix K(i nu_{n_i}, om_l)
+    */
+    static nda::matrix<dcomplex> build_kmat_if(imfreq_ops const &ifops, nda::vector_const_view<int> n) {
+
+      auto nn     = nda::vector<int>(n);
+      auto dlr_rf = nda::vector<double>(ifops.get_rfnodes());
+      auto kmat   = nda::matrix<dcomplex>(nn.size(), dlr_rf.size());
+      k_if({nn.data(), size_t(nn.size())}, {dlr_rf.data(), size_t(dlr_rf.size())}, ifops.get_statistic(), {kmat.data(), size_t(kmat.size())});
+
+      return kmat;
+    }
+  };
+
+  // Deduction guides: imaginary time fitter has real sampling matrix,
+  // imaginary frequency fitter has complex sampling matrix
+  dlr_fitter(imtime_ops const &, nda::vector_const_view<double>) -> dlr_fitter<double>;
+  dlr_fitter(imtime_ops const &, nda::vector_const_view<double>, nda::vector_const_view<double>) -> dlr_fitter<double>;
+  dlr_fitter(imfreq_ops const &, nda::vector_const_view<int>) -> dlr_fitter<dcomplex>;
+  dlr_fitter(imfreq_ops const &, nda::vector_const_view<int>, nda::vector_const_view<double>) -> dlr_fitter<dcomplex>;
+
+} // namespace cppdlr
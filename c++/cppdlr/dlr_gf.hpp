@@ -0,0 +1,214 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "dlr_imtime.hpp"
+
+#include <h5/h5.hpp>
+#include <nda/h5.hpp>
+
+#include <string>
+#include <vector>
+
+namespace cppdlr {
+
+  /**
+  * @class dlr_gf
+  * @brief Block-diagonal imaginary time Green's function stored by its DLR
+  * coefficients
+  *
+  * A Green's function G is stored as a list of orbital blocks G_b, each given
+  * by an r x n_b x m_b array of DLR coefficients, together with the
+  * imtime_ops object defining the DLR basis and the inverse temperature beta.
+  * Values of G at arbitrary imaginary time points are evaluated on the fly
+  * from the coefficients, so the dense imaginary time grid never needs to be
+  * formed.
+  *
+  * \note The HDF5 representation stores each block as a separate dataset, so
+  * that single blocks can be read without loading the others (see
+  * h5_read_block and h5_read_blocks).
+  *
+  * @tparam S Scalar type of Green's function (double or dcomplex)
+  */
+  template <nda::Scalar S = double> class dlr_gf {
+
+    public:
+    /**
+    * @brief Constructor for dlr_gf
+    *
+    * @param[in] itops DLR imaginary time object
+    * @param[in] beta Inverse temperature
+    * @param[in] blocks DLR coefficients of each block of G; first dimension of
+    * each block must be the DLR rank r
+    */
+    dlr_gf(imtime_ops const &itops, double beta, std::vector<nda::array<S, 3>> blocks) : itops_(itops), beta_(beta), blocks_(std::move(blocks)) {
+      for (auto const &gc : blocks_) {
+        if (gc.shape(0) != itops_.rank()) throw std::runtime_error("First dim of block != DLR rank r.");
+      }
+    }
+
+    dlr_gf() = default;
+
+    /**
+    * @brief Get DLR imaginary time object
+    */
+    imtime_ops const &itops() const { return itops_; }
+
+    /**
+    * @brief Get inverse temperature
+    */
+    double beta() const { return beta_; }
+
+    /**
+    * @brief Get DLR rank
+    */
+    int rank() const { return itops_.rank(); }
+
+    /**
+    * @brief Get number of blocks
+    */
+    int nblocks() const { return blocks_.size(); }
+
+    /**
+    * @brief Get DLR coefficients of a block
+    *
+    * @param[in] b Block index
+    *
+    * @return DLR coefficients of block @p b, r x n_b x m_b
+    */
+    nda::array_const_view<S, 3> block(int b) const { return blocks_.at(b); }
+
+    /**
+    * @copydoc block(int) const
+    */
+    nda::array_view<S, 3> block(int b) { return blocks_.at(b); }
+
+    /**
+    * @brief Evaluate a block of G at an imaginary time point
+    *
+    * @param[in] b Block index
+    * @param[in] t Evaluation point, in relative format
+    *
+    * @return Value of block @p b of G at @p t, n_b x m_b
+    *
+    * \note The given evaluation point must be scaled to the interval [0, 1]
+    * (rather than [0, beta]) and then given in the relative time format. Please
+    * see the "Imaginary time point format" section in the Background page of
+    * the documentation for more information.
+    */
+    nda::matrix<S> operator()(int b, double t) const { return nda::matrix<S>(itops_.coefs2eval(blocks_.at(b), t)); }
+
+    /**
+    * @brief Evaluate a block of G on a set of imaginary time points
+    *
+    * @param[in] b Block index
+    * @param[in] t Evaluation points, in relative format
+    *
+    * @return Values of block @p b of G at points @p t, # points x n_b x m_b
+    *
+    * \note See imtime_ops::coefs2eval for the format of the evaluation points
+    */
+    nda::array<S, 3> operator()(int b, nda::vector_const_view<double> t) const { return itops_.coefs2eval(blocks_.at(b), t); }
+
+    private:
+    imtime_ops itops_;                     ///< DLR imaginary time object
+    double beta_ = 0;                      ///< Inverse temperature
+    std::vector<nda::array<S, 3>> blocks_; ///< DLR coefficients of each block
+
+    // -------------------- hdf5 -------------------
+
+    public:
+    static std::string hdf5_format() { return "cppdlr::dlr_gf"; }
+
+    friend void h5_write(h5::group fg, std::string const &subgroup_name, dlr_gf const &g) {
+
+      h5::group gr = fg.create_group(subgroup_name);
+      write_hdf5_format(gr, g);
+
+      h5::write(gr, "beta", g.beta_);
+      h5::write(gr, "itops", g.itops_);
+      h5::write(gr, "nblocks", g.nblocks());
+
+      // One dataset per block
+      h5::group bgr = gr.create_group("blocks");
+      for (int b = 0; b < g.nblocks(); ++b) { h5::write(bgr, std::to_string(b), g.blocks_[b]); }
+    }
+
+    friend void h5_read(h5::group fg, std::string const &subgroup_name, dlr_gf &g) {
+
+      h5::group gr = fg.open_group(subgroup_name);
+      int nb       = h5::read<int>(gr, "nblocks");
+
+      auto bl = std::vector<int>(nb);
+      for (int b = 0; b < nb; ++b) { bl[b] = b; }
+
+      g = dlr_gf::h5_read_blocks(fg, subgroup_name, bl);
+    }
+
+    /**
+    * @brief Read DLR coefficients of a single block of G from HDF5
+    *
+    * @param[in] fg HDF5 group containing G
+    * @param[in] subgroup_name Name of G within @p fg
+    * @param[in] b Block index
+    *
+    * @return DLR coefficients of block @p b
+    *
+    * \note Only the dataset of block @p b is read
+    */
+    static nda::array<S, 3> h5_read_block(h5::group fg, std::string const &subgroup_name, int b) {
+
+      h5::group gr = fg.open_group(subgroup_name);
+      assert_hdf5_format_as_string(gr, hdf5_format().c_str(), true);
+
+      if (b < 0 || b >= h5::read<int>(gr, "nblocks")) throw std::runtime_error("Block index out of range.");
+
+      return h5::read<nda::array<S, 3>>(gr.open_group("blocks"), std::to_string(b));
+    }
+
+    /**
+    * @brief Read a subset of the blocks of G from HDF5
+    *
+    * @param[in] fg HDF5 group containing G
+    * @param[in] subgroup_name Name of G within @p fg
+    * @param[in] bl Indices of blocks to read
+    *
+    * @return dlr_gf object containing the blocks @p bl of G, in the given
+    * order, with the DLR basis and inverse temperature of G
+    */
+    static dlr_gf h5_read_blocks(h5::group fg, std::string const &subgroup_name, std::vector<int> const &bl) {
+
+      h5::group gr = fg.open_group(subgroup_name);
+      assert_hdf5_format_as_string(gr, hdf5_format().c_str(), true);
+
+      auto beta  = h5::read<double>(gr, "beta");
+      auto itops = h5::read<imtime_ops>(gr, "itops");
+      int nb     = h5::read<int>(gr, "nblocks");
+
+      h5::group bgr = gr.open_group("blocks");
+      auto blocks   = std::vector<nda::array<S, 3>>();
+      blocks.reserve(bl.size());
+      for (int b : bl) {
+        if (b < 0 || b >= nb) throw std::runtime_error("Block index out of range.");
+        blocks.push_back(h5::read<nda::array<S, 3>>(bgr, std::to_string(b)));
+      }
+
+      return dlr_gf(itops, beta, std::move(blocks));
+    }
+  };
+
+} // namespace cppdlr
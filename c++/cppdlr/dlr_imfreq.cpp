@@ -17,18 +17,25 @@
 #include "dlr_imfreq.hpp"
 #include "cppdlr/dlr_kernels.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 using namespace nda;
 
 namespace cppdlr {
 
   imfreq_ops::imfreq_ops(double lambda, nda::vector_const_view<double> dlr_rf, statistic_t statistic, bool symmetrize)
-     : lambda_(lambda), statistic(statistic), r(dlr_rf.size()), dlr_rf(dlr_rf) {
-    
+     : lambda_(lambda), statistic(statistic), r(dlr_rf.size()) {
+
     // Get # DLR imaginary frequency nodes; for symmetrized bosonic case, this
     // is DLR rank + 1, otherwise it is DLR rank
     niom = (statistic == Boson && symmetrize) ? r + 1 : r;
-    dlr_if   = nda::vector<int>(niom);
-    cf2if    = nda::matrix<dcomplex>(niom, r);
+
+    auto bd    = std::make_shared<basis_data>();
+    bd->dlr_rf = dlr_rf;
+    bd->dlr_if = nda::vector<int>(niom);
+    bd->cf2if  = nda::matrix<dcomplex>(niom, r);
 
     // Get analytic continuation kernel at DLR frequencies, up to imaginary
     // frequency cutoff
@@ -36,28 +43,83 @@ namespace cppdlr {
     auto kmat = build_k_if(nmax, dlr_rf, statistic);
 
     // Pivoted Gram-Schmidt to obtain DLR imaginary frequency nodes
-    auto [q, norms, piv] = (symmetrize ? pivrgs_sym(kmat, niom) : pivrgs(kmat, 1e-100));
+    auto [q, norms, piv] = (symmetrize ? pivrgs_sym_blocked(kmat, niom) : pivrgs_blocked(kmat, 1e-100));
     std::sort(piv.begin(), piv.end()); // Sort pivots in ascending order
-    for (int i = 0; i < niom; ++i) { dlr_if(i) = piv(i) - nmax; }
+    for (int i = 0; i < niom; ++i) { bd->dlr_if(i) = piv(i) - nmax; }
 
     // Obtain coefficients to imaginary frequency values transformation matrix
     for (int i = 0; i < niom; ++i) {
-      for (int j = 0; j < r; ++j) { cf2if(i, j) = kmat(piv(i), j); }
+      for (int j = 0; j < r; ++j) { bd->cf2if(i, j) = kmat(piv(i), j); }
     }
 
     if (!(symmetrize && statistic == Boson)) {
       // Prepare imaginary time values to coefficients transformation by computing
       // LU factors of coefficient to imaginary time matrix
-      if2cf.lu  = nda::matrix<dcomplex>(cf2if);
-      if2cf.piv = nda::vector<int>(r);
-      lapack::getrf(if2cf.lu, if2cf.piv);
+      bd->if2cf.lu  = nda::matrix<dcomplex>(bd->cf2if);
+      bd->if2cf.piv = nda::vector<int>(r);
+      lapack::getrf(bd->if2cf.lu, bd->if2cf.piv);
     }
+
+    basis = std::move(bd);
+  }
+
+  imfreq_ops imfreq_ops::extend(double lambda, nda::vector_const_view<double> dlr_rf) const {
+
+    long r0 = r, rn = dlr_rf.size();
+    if (niom != r) throw std::runtime_error("Extension of symmetrized bosonic imfreq_ops object is not supported.");
+    if (rn < r0) throw std::runtime_error("Extended basis must contain the DLR frequencies of this object.");
+    for (long i = 0; i < r0; ++i) {
+      if (dlr_rf(i) != basis->dlr_rf(i)) throw std::runtime_error("First DLR frequencies of extended basis must be those of this object.");
+    }
+
+    // Get analytic continuation kernel at DLR frequencies, up to imaginary
+    // frequency cutoff
+    auto nmax = fineparams(lambda).nmax;
+    auto kmat = build_k_if(nmax, dlr_rf, statistic);
+    long m    = kmat.shape(0);
+
+    // Order candidate imaginary frequency nodes with previous DLR imaginary
+    // frequency nodes first
+    auto order = nda::vector<int>(m);
+    auto isold = std::vector<bool>(m, false);
+    for (long i = 0; i < r0; ++i) {
+      int k = basis->dlr_if(i) + nmax;
+      if (k < 0 || k >= m) throw std::runtime_error("Previous DLR imaginary frequency nodes exceed imaginary frequency cutoff.");
+      order(i) = k;
+      isold[k] = true;
+    }
+    for (long k = 0, i = r0; k < m; ++k) {
+      if (!isold[k]) { order(i++) = k; }
+    }
+
+    auto kord = nda::matrix<dcomplex>(m, rn);
+    for (long i = 0; i < m; ++i) { kord(i, nda::range::all) = kmat(order(i), nda::range::all); }
+
+    // Pivoted Gram-Schmidt to obtain DLR imaginary frequency nodes, with
+    // previous nodes selected first
+    auto [q, norms, piv] = pivrgs_blocked_seeded(kord, 1e-100, r0);
+    std::sort(piv.begin() + r0, piv.end()); // Sort new pivots in ascending order
+
+    auto dlr_if = nda::vector<int>(rn);
+    auto cf2if  = nda::matrix<dcomplex>(rn, rn);
+    for (int i = 0; i < rn; ++i) {
+      dlr_if(i) = order(piv(i)) - nmax;
+      for (int j = 0; j < rn; ++j) { cf2if(i, j) = kord(piv(i), j); }
+    }
+    cf2if(nda::range(r0), nda::range(r0)) = basis->cf2if; // Reuse previous block
+
+    // LU factors of coefficients to imaginary frequency values matrix
+    auto lu    = nda::matrix<dcomplex>(cf2if);
+    auto lupiv = nda::vector<int>(rn);
+    lapack::getrf(lu, lupiv);
+
+    return imfreq_ops(lambda, dlr_rf, statistic, dlr_if, cf2if, lu, lupiv);
   }
 
   nda::vector<dcomplex> imfreq_ops::build_evalvec(double beta, int n) const {
 
-    auto kvec = nda::vector<dcomplex>(r);
-    for (int l = 0; l < r; ++l) { kvec(l) = beta * k_if(n, dlr_rf(l), statistic); }
+    auto kvec = build_evalvec(n);
+    kvec *= beta;
 
     return kvec;
   }
@@ -65,9 +127,42 @@ namespace cppdlr {
   nda::vector<dcomplex> imfreq_ops::build_evalvec(int n) const {
 
     auto kvec = nda::vector<dcomplex>(r);
-    for (int l = 0; l < r; ++l) { kvec(l) = k_if(n, dlr_rf(l), statistic); }
+    k_if({&n, 1}, {basis->dlr_rf.data(), size_t(r)}, statistic, {kvec.data(), size_t(r)});
 
     return kvec;
   }
 
+  nda::matrix<dcomplex> imfreq_ops::build_evalmat(nda::vector_const_view<int> n) const {
+
+    auto nn   = nda::vector<int>(n);
+    auto kmat = nda::matrix<dcomplex>(nn.size(), r);
+    k_if({nn.data(), size_t(nn.size())}, {basis->dlr_rf.data(), size_t(r)}, statistic, {kmat.data(), size_t(kmat.size())});
+
+    return kmat;
+  }
+
+  nda::matrix<double> imfreq_ops::build_momentmat() const {
+
+    double om_max = max_element(abs(basis->dlr_rf));
+    if (om_max == 0) om_max = 1; // Only zeroth moment is used in this case
+    auto mmat = nda::matrix<double>(r, r);
+
+    for (int l = 0; l < r; ++l) {
+      mmat(0, l) = (statistic == Fermion ? 1.0 : std::tanh(0.5 * basis->dlr_rf(l))); // Numerator of kernel
+      for (int k = 1; k < r; ++k) { mmat(k, l) = mmat(k - 1, l) * basis->dlr_rf(l) / om_max; }
+    }
+
+    return mmat;
+  }
+
+  int imfreq_ops::multipole_order(double om_max, double nu) {
+
+    // Multipole expansion converges at least as fast as 2^(-k) for |nu| >= 2 Om
+    if (nu == 0 || std::abs(nu) < 2 * om_max) return 0;
+    if (om_max == 0) return 1;
+
+    double rho = om_max / std::abs(nu);
+    return std::max(1, int(std::ceil(std::log(std::numeric_limits<double>::epsilon()) / std::log(rho))));
+  }
+
 } // namespace cppdlr
@@ -20,12 +20,20 @@
 #include "dlr_kernels.hpp"
 #include "dlr_build.hpp"
 #include "utils.hpp"
+#include "instrument.hpp"
 
 #include <h5/h5.hpp>
 #include <nda/h5.hpp>
+#include <memory>
+#include <numbers>
 
 namespace cppdlr {
 
+  /**
+  * @brief Scratch storage for allocation-free imfreq_ops methods
+  */
+  using imfreq_workspace = workspace;
+
   /**
   * @class imfreq_ops
   * @brief Class responsible for all DLR imaginary frequency operations, including
@@ -57,17 +65,38 @@ namespace cppdlr {
                nda::matrix_const_view<nda::dcomplex> cf2if,                                 //
                nda::matrix_const_view<nda::dcomplex> if2cf_lu,                              //
                nda::vector_const_view<int> if2cf_piv)
-       : lambda_(lambda),
-         statistic(statistic),
-         r(cf2if.extent(1)),
-         niom(dlr_if.size()),
-         dlr_rf(dlr_rf),
-         dlr_if(dlr_if),
-         cf2if(cf2if),
-         if2cf{if2cf_lu, if2cf_piv} {};
+       : lambda_(lambda), statistic(statistic), r(cf2if.extent(1)), niom(dlr_if.size()) {
+      auto bd       = std::make_shared<basis_data>();
+      bd->dlr_rf    = dlr_rf;
+      bd->dlr_if    = dlr_if;
+      bd->cf2if     = cf2if;
+      bd->if2cf.lu  = if2cf_lu;
+      bd->if2cf.piv = if2cf_piv;
+      basis         = std::move(bd);
+    };
 
     imfreq_ops() = default;
 
+    /**
+    * @brief Build imfreq_ops object for a DLR basis extended by
+    * build_dlr_rf_extend
+    *
+    * The DLR imaginary frequency nodes of the extended basis are obtained by
+    * pivoted Gram-Schmidt with the DLR imaginary frequency nodes of this object
+    * selected first, so that they are kept, in their original order, as the
+    * first nodes of the extended basis, and the corresponding block of the
+    * coefficients -> imaginary frequency values matrix is reused.
+    *
+    * @param[in] lambda DLR cutoff parameter of extended basis
+    * @param[in] dlr_rf DLR frequencies of extended basis, the first r of which
+    * must be the DLR frequencies of this object
+    *
+    * @return imfreq_ops object for extended basis, with the same statistic
+    *
+    * \note Only unsymmetrized DLR frequencies are supported.
+    */
+    imfreq_ops extend(double lambda, nda::vector_const_view<double> dlr_rf) const;
+
     /** 
     * @brief Transform values of Green's function G on DLR imaginary frequency grid to
     * DLR coefficients
@@ -81,6 +110,8 @@ namespace cppdlr {
 
     template <nda::MemoryArray T> typename T::regular_type vals2coefs(T const &g) const {
 
+      CPPDLR_PROBE("imfreq_ops::vals2coefs", 2 * g.size() * sizeof(dcomplex), instrument::fma_flops<dcomplex> * r * g.size());
+
       // MemoryArray type can be nda vector, matrix, array, or view of any of
       // these; taking a regular_type converts, for example, a matrix view to a
       // matrix.
@@ -96,17 +127,61 @@ namespace cppdlr {
       // Solve linear system (multiple right hand sides) to convert vals ->
       // coeffs
       if (niom == r) {
-        nda::lapack::getrs(if2cf.lu, gfv, if2cf.piv);
+        nda::lapack::getrs(basis->if2cf.lu, gfv, basis->if2cf.piv);
       } else {                                 // Non-square system---use least squares solver
         auto s       = nda::vector<double>(r); // Not needed
         double rcond = 0;                      // Not needed
         int rank     = 0;                      // Not needed
-        nda::lapack::gelss(nda::matrix<dcomplex, F_layout>(cf2if), gfv, s, rcond, rank);
+        nda::lapack::gelss(nda::matrix<dcomplex, F_layout>(basis->cf2if), gfv, s, rcond, rank);
       }
 
       return gf(nda::range(r), nda::ellipsis());
     }
 
+    /** 
+    * @brief Transform values of Green's function G on DLR imaginary frequency
+    * grid to DLR coefficients, writing into a preallocated array
+    *
+    * Same as vals2coefs, but the result is written into @p gc, and scratch
+    * storage is taken from @p ws, so that no memory is allocated once @p ws
+    * has been used for arrays of the same size.
+    *
+    * @param[in] g Values of G on DLR imaginary frequency grid
+    * @param[out] gc DLR coefficients of G; first dimension must be r, other
+    * dimensions same as @p g
+    * @param[in] ws Workspace
+    *
+    * \note In the symmetrized bosonic case, in which the number of DLR
+    * imaginary frequency nodes is r+1, the least squares solver allocates its
+    * own work arrays.
+    */
+    template <nda::MemoryArray Tg, nda::MemoryArray Tc> void vals2coefs_into(Tg const &g, Tc &&gc, imfreq_workspace &ws) const {
+
+      if (niom != g.shape(0)) throw std::runtime_error("First dim of g != # DLR imaginary frequency nodes.");
+      if (r != gc.shape(0) || gc.size() / r != g.size() / niom) throw std::runtime_error("Output array has incompatible shape.");
+
+      // Copy data into workspace in Fortran Layout as required by getrs
+      long m   = g.size() / niom;
+      auto buf = ws.matrix<dcomplex, F_layout>(0, niom, m);
+      buf      = nda::reshape(g, niom, m);
+
+      // Solve linear system (multiple right hand sides) to convert vals ->
+      // coeffs
+      if (niom == r) {
+        nda::lapack::getrs(basis->if2cf.lu, buf, basis->if2cf.piv);
+      } else { // Non-square system---use least squares solver
+        auto a = ws.matrix<dcomplex, F_layout>(1, niom, r); // Copy of system matrix, overwritten by gelss
+        a      = basis->cf2if;
+
+        auto s       = nda::vector<double>(r); // Not needed
+        double rcond = 0;                      // Not needed
+        int rank     = 0;                      // Not needed
+        nda::lapack::gelss(a, buf, s, rcond, rank);
+      }
+
+      nda::reshape(gc, r, m) = buf(nda::range(r), nda::range::all);
+    }
+
     /** 
     * @brief Transform DLR coefficients of Green's function G to values on DLR
     * imaginary frequency grid
@@ -122,13 +197,15 @@ namespace cppdlr {
 
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> make_cplx_t<T> coefs2vals(T const &gc) const {
 
+      CPPDLR_PROBE("imfreq_ops::coefs2vals", (niom + r) * gc.size() / r * sizeof(dcomplex), instrument::fma_flops<dcomplex> * niom * gc.size());
+
       if (r != gc.shape(0)) throw std::runtime_error("First dim of gc != DLR rank r.");
 
       // Reshape gc to a matrix w/ first dimension r
       auto gc_rs = nda::reshape(gc, r, gc.size() / r);
 
       // Apply coeffs -> vals matrix
-      auto g = cf2if * nda::matrix_const_view<S>(gc_rs);
+      auto g = basis->cf2if * nda::matrix_const_view<S>(gc_rs);
 
       // Get output shape
       std::array<long, T::rank> shape_out;
@@ -139,6 +216,38 @@ namespace cppdlr {
       return nda::reshape(g, shape_out);
     }
 
+    /** 
+    * @brief Transform DLR coefficients of Green's function G to values on DLR
+    * imaginary frequency grid, writing into a preallocated array
+    *
+    * Same as coefs2vals, but the result is written directly into @p g by a
+    * matrix-matrix product. Real coefficients are first copied to complex
+    * scratch storage taken from @p ws, so that no memory is allocated once
+    * @p ws has been used for arrays of the same size.
+    *
+    * @param[in] gc DLR coefficients of G
+    * @param[out] g Values of G on DLR imaginary frequency grid; first dimension
+    * must be # DLR imaginary frequency nodes, other dimensions same as @p gc
+    * @param[in] ws Workspace
+    */
+    template <nda::MemoryArray Tc, nda::MemoryArray Tg, nda::Scalar S = nda::get_value_t<Tc>>
+    void coefs2vals_into(Tc const &gc, Tg &&g, imfreq_workspace &ws) const {
+
+      if (r != gc.shape(0)) throw std::runtime_error("First dim of gc != DLR rank r.");
+      if (niom != g.shape(0) || gc.size() / r != g.size() / niom) throw std::runtime_error("Output array has incompatible shape.");
+
+      long m    = gc.size() / r;
+      auto g_rs = nda::reshape(g, niom, m);
+
+      if constexpr (nda::is_complex_v<S>) {
+        nda::blas::gemm(1.0, basis->cf2if, nda::reshape(gc, r, m), 0.0, g_rs);
+      } else {
+        auto buf = ws.matrix<dcomplex>(0, r, m);
+        buf      = nda::reshape(gc, r, m);
+        nda::blas::gemm(1.0, basis->cf2if, buf, 0.0, g_rs);
+      }
+    }
+
     /** 
     * @brief Evaluate DLR expansion of G, given by its DLR coefficients, at imaginary
     * frequency point 
@@ -155,6 +264,8 @@ namespace cppdlr {
 
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> auto coefs2eval(T const &gc, int n) const {
 
+      CPPDLR_PROBE("imfreq_ops::coefs2eval", (gc.size() / r + r) * sizeof(dcomplex), instrument::fma_flops<dcomplex> * gc.size());
+
       if (r != gc.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
 
       // Scalar-valued Green's functions are handled differently than matrix-valued Green's functions
@@ -163,7 +274,7 @@ namespace cppdlr {
 
         // Evaluate DLR expansion
         std::complex<double> g = 0;
-        for (int l = 0; l < r; ++l) { g += k_if(n, dlr_rf(l), statistic) * gc(l); }
+        for (int l = 0; l < r; ++l) { g += k_if(n, basis->dlr_rf(l), statistic) * gc(l); }
 
         return g;
       } else {
@@ -184,6 +295,114 @@ namespace cppdlr {
       }
     }
 
+    /**
+    * @brief Evaluate DLR expansion of G, given by its DLR coefficients, on a
+    * set of imaginary frequency points
+    *
+    * @param[in] gc DLR coefficients of G
+    * @param[in] n  Evaluation point indices
+    *
+    * @return Values of G at Matsubara frequencies with indices @p n; first
+    * dimension is the number of evaluation points, remaining dimensions are
+    * those of @p gc
+    *
+    * @note Frequencies near the DLR real frequency support, |nu_n| < 2 * max_l
+    * |om_l|, are evaluated by building blocks of rows of the kernel matrix and
+    * applying them by a matrix-matrix product. For frequencies far from the
+    * support, we use the multipole (moment) expansion
+    *
+    * G(i nu_n) = 1/(i nu_n) sum_{k>=0} M_k (Om/(i nu_n))^k,
+    *
+    * with Om = max_l |om_l| and M_k = sum_l (om_l/Om)^k c_l, truncated once
+    * (Om/|nu_n|)^k falls below machine precision. This costs O(p) rather than
+    * O(r) per frequency, with p the number of terms, which is much smaller
+    * than r for most frequencies in a large range, e.g. all |n| < 10^5.
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::array<dcomplex, nda::get_rank<T>> coefs2eval(T const &gc, nda::vector_const_view<int> n) const {
+
+      if (r != gc.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+
+      long nn = n.size();
+      long m  = gc.size() / r;
+
+      CPPDLR_PROBE("imfreq_ops::coefs2eval_grid", nn * (m + r) * sizeof(dcomplex), instrument::fma_flops<dcomplex> * nn * gc.size());
+
+      // Complex copy of coefficients, reshaped to matrix w/ first dimension r
+      auto gcz = nda::matrix<dcomplex>(nda::reshape(nda::array<S, nda::get_rank<T>>(gc), r, m));
+
+      // Output array: same as gc, with first dimension r replaced by # points
+      auto g_shape = gc.shape();
+      g_shape[0]   = nn;
+      auto g       = nda::array<dcomplex, nda::get_rank<T>>(g_shape);
+      auto g_rs    = nda::reshape(g, nn, m);
+
+      // Moments of DLR expansion
+      auto mom = nda::matrix<dcomplex>(r, m);
+      realgemm(1.0, build_momentmat(), gcz, 0.0, mom);
+
+      // Split evaluation points into near field, evaluated directly, and far
+      // field, evaluated by multipole expansion
+      double om_max = max_element(abs(basis->dlr_rf));
+      auto inear    = nda::vector<long>(nn); // Positions of near field points
+      int nnear     = 0;
+      for (long i = 0; i < nn; ++i) {
+        double nu = (statistic == Fermion ? 2 * n(i) + 1 : 2 * n(i)) * std::numbers::pi;
+        int p     = multipole_order(om_max, nu);
+        if (p == 0 || p >= r) {
+          inear(nnear++) = i;
+          continue;
+        }
+        auto z     = dcomplex(0, -om_max / nu); // Om / (i nu)
+        g_rs(i, _) = mom(p - 1, _);
+        for (int k = p - 2; k >= 0; --k) { g_rs(i, _) = g_rs(i, _) * z + mom(k, _); }
+        g_rs(i, _) *= dcomplex(0, -1 / nu);
+      }
+
+      // Near field: one block of evaluation points at a time
+      auto nblk = nda::vector<int>(evalblk);
+      auto kmat = nda::matrix<dcomplex>(evalblk, r);
+      auto gblk = nda::matrix<dcomplex>(evalblk, m);
+      for (int i0 = 0; i0 < nnear; i0 += evalblk) {
+        int nb = std::min(evalblk, nnear - i0);
+        for (int j = 0; j < nb; ++j) { nblk(j) = n(inear(i0 + j)); }
+        k_if({nblk.data(), size_t(nb)}, {basis->dlr_rf.data(), size_t(r)}, statistic, {kmat.data(), size_t(nb * r)});
+        nda::blas::gemm(1.0, kmat(nda::range(nb), _), gcz, 0.0, gblk(nda::range(nb), _));
+        for (int j = 0; j < nb; ++j) { g_rs(inear(i0 + j), _) = gblk(j, _); }
+      }
+
+      return g;
+    }
+
+    /**
+    * @brief Evaluate DLR expansion of G, given by its DLR coefficients, on a
+    * set of imaginary frequency points, given inverse temperature
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] gc   DLR coefficients of G
+    * @param[in] n    Evaluation point indices
+    *
+    * @return Values of G at Matsubara frequencies with indices @p n
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::array<dcomplex, nda::get_rank<T>> coefs2eval(double beta, T const &gc, nda::vector_const_view<int> n) const {
+      auto g = coefs2eval(gc, n);
+      g *= beta;
+      return g;
+    }
+
+    /**
+    * @brief Build matrix of evaluation of DLR expansion on a set of imaginary
+    * frequency points
+    *
+    * @param[in] n Evaluation point indices
+    *
+    * @return Matrix of size (# evaluation points) x r, entry (i,l) of which is
+    * the lth DLR basis function evaluated at Matsubara frequency with index
+    * n(i)
+    */
+    nda::matrix<nda::dcomplex> build_evalmat(nda::vector_const_view<int> n) const;
+
     /** 
     * @brief Get vector of evaluation of DLR expansion at an imaginary frequency point 
     *
@@ -200,37 +419,37 @@ namespace cppdlr {
     *
     * @return DLR imaginary frequency nodes
     */
-    nda::vector_const_view<int> get_ifnodes() const { return dlr_if; };
-    int get_ifnodes(int i) const { return dlr_if(i); };
+    nda::vector_const_view<int> get_ifnodes() const { return basis->dlr_if; };
+    int get_ifnodes(int i) const { return basis->dlr_if(i); };
 
     /**
     * @brief Get DLR real frequency nodes
     *
     * @return DLR real frequency nodes
     */
-    nda::vector_const_view<double> get_rfnodes() const { return dlr_rf; };
-    double get_rfnodes(int i) const { return dlr_rf(i); };
+    nda::vector_const_view<double> get_rfnodes() const { return basis->dlr_rf; };
+    double get_rfnodes(int i) const { return basis->dlr_rf(i); };
 
     /**
     * @brief Get transformation matrix from DLR coefficients to values at DLR imaginary frequency nodes
     *
     * @return Transformation matrix
     */
-    nda::matrix_const_view<nda::dcomplex> get_cf2if() const { return cf2if; };
+    nda::matrix_const_view<nda::dcomplex> get_cf2if() const { return basis->cf2if; };
 
     /**
     * @brief Get LU factors of transformation matrix from DLR imaginary frequency values to coefficients
     *
     * @return LU factors
     */
-    nda::matrix_const_view<nda::dcomplex> get_if2cf_lu() const { return if2cf.lu; };
+    nda::matrix_const_view<nda::dcomplex> get_if2cf_lu() const { return basis->if2cf.lu; };
 
     /**
     * @brief Get LU pivots of transformation matrix from DLR imaginary frequency values to coefficients
     *
     * @return LU pivots
     */
-    nda::vector_const_view<int> get_if2cf_piv() const { return if2cf.piv; };
+    nda::vector_const_view<int> get_if2cf_piv() const { return basis->if2cf.piv; };
 
     /** 
     * @brief Get DLR rank
@@ -242,21 +461,46 @@ namespace cppdlr {
     statistic_t get_statistic() const { return statistic; }
 
     private:
+    static constexpr int evalblk = 1024; ///< Block size (# evaluation points) used by coefs2eval on a set of points
+
+    /**
+    * @brief Build matrix of moments of DLR basis functions, entry (k,l) of
+    * which is (om_l/Om)^k times the numerator of the lth basis function, with
+    * Om = max_l |om_l|, for k = 0,...,r-1
+    */
+    nda::matrix<double> build_momentmat() const;
+
+    /**
+    * @brief Number of terms of multipole expansion needed to evaluate DLR
+    * expansion to machine precision at imaginary frequency nu, or 0 if it
+    * does not converge fast enough
+    */
+    static int multipole_order(double om_max, double nu);
+
     double lambda_;                   ///< Energy cutoff divided by temperature
     statistic_t statistic;            ///< Particle statistic: Fermion or Boson
     int r;                            ///< DLR rank
     int niom;                         ///< # DLR imaginary freq nodes (different from r in symmetrized bosonic case)
-    nda::vector<double> dlr_rf;       ///< DLR frequencies
-    nda::vector<int> dlr_if;          ///< DLR imaginary frequency nodes
-    nda::matrix<nda::dcomplex> cf2if; /// Transformation matrix from DLR coefficients to values at DLR imaginary frequency nodes
 
     /**
-    * @brief Struct for transformation from DLR imaginary frequency values to coefficients
+    * @brief DLR imaginary frequency basis data, shared between copies of an
+    * imfreq_ops object, and never modified after construction
     */
-    struct {
-      nda::matrix<nda::dcomplex> lu; ///< LU factors (LAPACK format) of imaginary frequency vals -> coefs matrix
-      nda::vector<int> piv;          ///< LU pivots (LAPACK format) of imaginary frequency vals -> coefs matrix
-    } if2cf;
+    struct basis_data {
+      nda::vector<double> dlr_rf;       ///< DLR frequencies
+      nda::vector<int> dlr_if;          ///< DLR imaginary frequency nodes
+      nda::matrix<nda::dcomplex> cf2if; /// Transformation matrix from DLR coefficients to values at DLR imaginary frequency nodes
+
+      /**
+      * @brief Struct for transformation from DLR imaginary frequency values to coefficients
+      */
+      struct {
+        nda::matrix<nda::dcomplex> lu; ///< LU factors (LAPACK format) of imaginary frequency vals -> coefs matrix
+        nda::vector<int> piv;          ///< LU pivots (LAPACK format) of imaginary frequency vals -> coefs matrix
+      } if2cf;
+    };
+
+    std::shared_ptr<basis_data const> basis = std::make_shared<basis_data>(); ///< DLR basis data, shared between copies
 
     // -------------------- hdf5 -------------------
 
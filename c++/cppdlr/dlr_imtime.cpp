@@ -24,12 +24,14 @@ using namespace nda;
 
 namespace cppdlr {
 
-  imtime_ops::imtime_ops(double lambda, nda::vector_const_view<double> dlr_rf, bool symmetrize) : lambda_(lambda), r(dlr_rf.size()), dlr_rf(dlr_rf) {
+  imtime_ops::imtime_ops(double lambda, nda::vector_const_view<double> dlr_rf, bool symmetrize) : lambda_(lambda), r(dlr_rf.size()) {
 
-    dlr_it    = nda::vector<double>(r);
-    cf2it     = nda::matrix<double>(r, r);
-    it2cf.lu  = nda::matrix<double>(r, r);
-    it2cf.piv = nda::vector<int>(r);
+    auto bd       = std::make_shared<basis_data>();
+    bd->dlr_rf    = dlr_rf;
+    bd->dlr_it    = nda::vector<double>(r);
+    bd->cf2it     = nda::matrix<double>(r, r);
+    bd->it2cf.lu  = nda::matrix<double>(r, r);
+    bd->it2cf.piv = nda::vector<int>(r);
 
     // Get discretization of analytic continuation kernel on fine grid in
     // imaginary time, at DLR frequencies
@@ -38,35 +40,114 @@ namespace cppdlr {
     auto kmat   = build_k_it(t, dlr_rf);
 
     // Pivoted Gram-Schmidt to obtain DLR imaginary time nodes
-    auto [q, norms, piv] = (symmetrize ? pivrgs_sym(kmat, 1e-100) : pivrgs(kmat, 1e-100));
+    auto [q, norms, piv] = (symmetrize ? pivrgs_sym_blocked(kmat, 1e-100) : pivrgs_blocked(kmat, 1e-100));
     std::sort(piv.begin(), piv.end()); // Sort pivots in ascending order
-    for (int i = 0; i < r; ++i) { dlr_it(i) = t(piv(i)); }
+    for (int i = 0; i < r; ++i) { bd->dlr_it(i) = t(piv(i)); }
 
     // Obtain coefficients to imaginary time values transformation matrix
     for (int i = 0; i < r; ++i) {
-      for (int j = 0; j < r; ++j) { cf2it(i, j) = kmat(piv(i), j); }
+      for (int j = 0; j < r; ++j) { bd->cf2it(i, j) = kmat(piv(i), j); }
     }
 
     // Prepare imaginary time values to coefficients transformation by computing
     // LU factors of coefficient to imaginary time matrix
-    it2cf.lu = cf2it;
-    lapack::getrf(it2cf.lu, it2cf.piv);
-    it2cf.zlu = it2cf.lu;
+    bd->it2cf.lu = bd->cf2it;
+    lapack::getrf(bd->it2cf.lu, bd->it2cf.piv);
+
+    basis = std::move(bd);
   }
 
   imtime_ops::imtime_ops(double lambda, nda::vector_const_view<double> dlr_rf) : imtime_ops(lambda, dlr_rf, NONSYM) {}
 
+  imtime_ops imtime_ops::extend(double lambda, nda::vector_const_view<double> dlr_rf) const {
+
+    long r0 = r, rn = dlr_rf.size();
+    if (rn < r0) throw std::runtime_error("Extended basis must contain the DLR frequencies of this object.");
+    for (long i = 0; i < r0; ++i) {
+      if (dlr_rf(i) != basis->dlr_rf(i)) throw std::runtime_error("First DLR frequencies of extended basis must be those of this object.");
+    }
+
+    // Candidate imaginary time nodes: previous DLR imaginary time nodes,
+    // followed by fine grid
+    auto fine   = fineparams(lambda);
+    auto [t, w] = build_it_fine(fine);
+    long nt     = t.size();
+    auto tc     = nda::vector<double>(r0 + nt);
+
+    tc(nda::range(r0))          = basis->dlr_it;
+    tc(nda::range(r0, r0 + nt)) = t;
+
+    // Pivoted Gram-Schmidt to obtain DLR imaginary time nodes, with previous
+    // nodes selected first
+    auto kmat            = build_k_it(tc, dlr_rf);
+    auto [q, norms, piv] = pivrgs_blocked_seeded(kmat, 1e-100, r0);
+    std::sort(piv.begin() + r0, piv.end()); // Sort new pivots in ascending order
+
+    auto dlr_it = nda::vector<double>(rn);
+    auto cf2it  = nda::matrix<double>(rn, rn);
+    for (int i = 0; i < rn; ++i) {
+      dlr_it(i) = tc(piv(i));
+      for (int j = 0; j < rn; ++j) { cf2it(i, j) = kmat(piv(i), j); }
+    }
+    cf2it(nda::range(r0), nda::range(r0)) = basis->cf2it; // Reuse previous block
+
+    // LU factors of coefficients to imaginary time values matrix
+    auto lu    = nda::matrix<double>(cf2it);
+    auto lupiv = nda::vector<int>(rn);
+    lapack::getrf(lu, lupiv);
+
+    return imtime_ops(lambda, dlr_rf, dlr_it, cf2it, lu, lupiv);
+  }
+
   nda::vector<double> imtime_ops::build_evalvec(double t) const {
 
-    // TODO: can be further optimized to reduce # exponential evals.
-    auto kvec = nda::vector<double>(r);
-    if (t >= 0) {
-      for (int l = 0; l < r; ++l) { kvec(l) = k_it_abs(t, dlr_rf(l)); }
-    } else {
-      for (int l = 0; l < r; ++l) { kvec(l) = k_it_abs(-t, -dlr_rf(l)); }
+    return build_k_it(t, basis->dlr_rf);
+  }
+
+  nda::matrix<double> imtime_ops::build_evalmat(nda::vector_const_view<double> t) const {
+
+    if (is_eqptsrel(t)) { return build_evalmat_eqpts(t.size(), 0, t.size()); }
+
+    return build_k_it(t, basis->dlr_rf);
+  }
+
+  nda::matrix<double> imtime_ops::build_evalmat_eqpts(int n, int i0, int i1) const {
+
+    if (n < 2) { return build_k_it(eqptsrel(n)(nda::range(i0, i1)), basis->dlr_rf); }
+
+    constexpr int nrestart = 64; // # recurrence steps between direct evaluations
+
+    double h  = 1.0 / (n - 1); // Grid spacing
+    auto kmat = nda::matrix<double>(i1 - i0, r);
+
+    // Point i of grid is i*h in absolute format. For om >= 0, the basis
+    // function is d*exp(-i*h*om), which decays with increasing i; for om < 0,
+    // it is d*exp((n-1-i)*h*om), which decays with decreasing i. Run the
+    // recurrence in the decaying direction in each case.
+    for (int l = 0; l < r; ++l) {
+      double om = basis->dlr_rf(l);
+      double d  = -1.0 / (1.0 + std::exp(-std::abs(om)));
+      double q  = std::exp(-h * std::abs(om));
+
+      for (int a = i0; a < i1; a += nrestart) {
+        int b = std::min(a + nrestart, i1);
+        if (om >= 0) {
+          double k = d * std::exp(-a * h * om);
+          for (int i = a; i < b; ++i) {
+            kmat(i - i0, l) = k;
+            k *= q;
+          }
+        } else {
+          double k = d * std::exp((n - b) * h * om);
+          for (int i = b - 1; i >= a; --i) {
+            kmat(i - i0, l) = k;
+            k *= q;
+          }
+        }
+      }
     }
 
-    return kvec;
+    return kmat;
   }
 
 } // namespace cppdlr
@@ -20,15 +20,25 @@
 #include "cppdlr/dlr_kernels.hpp"
 #include "cppdlr/dlr_build.hpp"
 #include "cppdlr/utils.hpp"
+#include "cppdlr/instrument.hpp"
 #include "nda/clef/clef.hpp"
 
 #include <h5/h5.hpp>
 #include <nda/h5.hpp>
 
+#include <array>
+#include <memory>
+#include <tuple>
+
 namespace cppdlr {
 
   static constexpr auto _ = nda::range::all;
 
+  /**
+  * @brief Scratch storage for allocation-free imtime_ops methods
+  */
+  using imtime_workspace = workspace;
+
   /**
   * Option for ordinary or time-ordered convolution 
   */
@@ -41,6 +51,14 @@ namespace cppdlr {
   *
   * \note First dimension of all Green's function and coefficient arrays must be
   * DLR rank r.
+  *
+  * \note The transformations vals2coefs and coefs2vals, their _into variants,
+  * convolve(double, statistic_t, T const &, T const &, bool) and convolve_into
+  * also accept single precision (float or std::complex<float>) Green's
+  * functions, for DLR tolerances eps above roughly 1e-6. These are computed
+  * by BLAS sgemm with single precision copies of the DLR matrices, built on
+  * first use, and take half the memory bandwidth of double precision. In
+  * single precision, arrays passed to the _into variants must be contiguous.
   */
 
   class imtime_ops {
@@ -65,11 +83,52 @@ namespace cppdlr {
     imtime_ops(double lambda, nda::vector_const_view<double> dlr_rf);
 
     imtime_ops(double lambda, nda::vector_const_view<double> dlr_rf, nda::vector_const_view<double> dlr_it, nda::matrix_const_view<double> cf2it,
-               nda::matrix_const_view<double> it2cf_lu, nda::matrix_const_view<dcomplex> it2cf_zlu, nda::vector_const_view<int> it2cf_piv)
-       : lambda_(lambda), r(dlr_rf.size()), dlr_rf(dlr_rf), dlr_it(dlr_it), cf2it(cf2it), it2cf{it2cf_lu, it2cf_zlu, it2cf_piv} {};
+               nda::matrix_const_view<double> it2cf_lu, nda::vector_const_view<int> it2cf_piv)
+       : lambda_(lambda), r(dlr_rf.size()) {
+      auto bd       = std::make_shared<basis_data>();
+      bd->dlr_rf    = dlr_rf;
+      bd->dlr_it    = dlr_it;
+      bd->cf2it     = cf2it;
+      bd->it2cf.lu  = it2cf_lu;
+      bd->it2cf.piv = it2cf_piv;
+      basis         = std::move(bd);
+    };
+
+    /**
+    * @brief Constructor for imtime_ops from precomputed arrays, including a
+    * complex copy of the LU factors
+    *
+    * \note The complex copy of the LU factors is no longer stored, and
+    * @p it2cf_zlu is ignored. This constructor is kept for backward
+    * compatibility.
+    */
+    imtime_ops(double lambda, nda::vector_const_view<double> dlr_rf, nda::vector_const_view<double> dlr_it, nda::matrix_const_view<double> cf2it,
+               nda::matrix_const_view<double> it2cf_lu, [[maybe_unused]] nda::matrix_const_view<dcomplex> it2cf_zlu,
+               nda::vector_const_view<int> it2cf_piv)
+       : imtime_ops(lambda, dlr_rf, dlr_it, cf2it, it2cf_lu, it2cf_piv) {};
 
     imtime_ops() = default;
 
+    /**
+    * @brief Build imtime_ops object for a DLR basis extended by
+    * build_dlr_rf_extend
+    *
+    * The DLR imaginary time nodes of the extended basis are obtained by
+    * pivoted Gram-Schmidt with the DLR imaginary time nodes of this object
+    * selected first, so that they are kept, in their original order, as the
+    * first nodes of the extended basis, and the corresponding block of the
+    * coefficients -> imaginary time values matrix is reused.
+    *
+    * @param[in] lambda DLR cutoff parameter of extended basis
+    * @param[in] dlr_rf DLR frequencies of extended basis, the first r of which
+    * must be the DLR frequencies of this object
+    *
+    * @return imtime_ops object for extended basis
+    *
+    * \note Only unsymmetrized DLR frequencies are supported.
+    */
+    imtime_ops extend(double lambda, nda::vector_const_view<double> dlr_rf) const;
+
     /** 
     * @brief Transform values of Green's function G on DLR imaginary time grid to
     * DLR coefficients 
@@ -100,26 +159,83 @@ namespace cppdlr {
     */
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> typename T::regular_type vals2coefs(T const &g, bool transpose = false) const {
 
+      CPPDLR_PROBE("imtime_ops::vals2coefs", g.size() * sizeof(S), instrument::fma_flops<S> * r * g.size());
+
       // MemoryArray type can be nda vector, matrix, array, or view of any of
       // these; taking a regular_type converts, for example, a matrix view to a
       // matrix.
 
       if (r != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
 
-      // Make a copy of the data in Fortran Layout as required by getrs
-      auto gf = nda::array<get_value_t<T>, get_rank<T>, F_layout>(g);
+      if constexpr (is_single_v<S>) { // Single precision: product with explicit vals -> coefs matrix
 
-      // Reshape as matrix_view with r rows
-      auto gfv = nda::reshape(gf, r, g.size() / r);
+        auto gs             = nda::array<S, get_rank<T>>(g);
+        auto gc             = nda::array<S, get_rank<T>>(g.shape());
+        auto const &it2cf_s = single_mats().second;
+        long m              = g.size() / r;
+        if (transpose) {
+          realgemm(1.0, nda::transpose(it2cf_s), nda::reshape(gs, r, m), 0.0, nda::reshape(gc, r, m));
+        } else {
+          realgemm(1.0, it2cf_s, nda::reshape(gs, r, m), 0.0, nda::reshape(gc, r, m));
+        }
+        return gc;
 
-      // Solve linear system (multiple right hand sides) to convert vals -> coeffs
-      if constexpr (nda::is_complex_v<S>) { // getrs requires matrix and rhs to have same value type
-        transpose ? nda::lapack::getrs(nda::transpose(it2cf.zlu), gfv, it2cf.piv) : nda::lapack::getrs(it2cf.zlu, gfv, it2cf.piv);
       } else {
-        transpose ? nda::lapack::getrs(nda::transpose(it2cf.lu), gfv, it2cf.piv) : nda::lapack::getrs(it2cf.lu, gfv, it2cf.piv);
+
+        // Make a copy of the data in Fortran Layout as required by getrs
+        auto gf = nda::array<get_value_t<T>, get_rank<T>, F_layout>(g);
+
+        // Reshape as matrix_view with r rows
+        auto gfv = nda::reshape(gf, r, g.size() / r);
+
+        // Solve linear system (multiple right hand sides) to convert vals -> coeffs
+        auto ws = imtime_workspace();
+        it2cf_solve(gfv, transpose, ws);
+
+        return gf;
       }
+    }
+
+    /** 
+    * @brief Transform values of Green's function G on DLR imaginary time grid to
+    * DLR coefficients, writing into a preallocated array
+    *
+    * Same as vals2coefs, but the result is written into @p gc, and scratch
+    * storage is taken from @p ws, so that no memory is allocated once @p ws
+    * has been used for arrays of the same size.
+    *
+    * @param[in] g          Values of G on DLR imaginary time grid
+    * @param[out] gc        DLR coefficients of G; must have same shape as @p g
+    * @param[in] ws         Workspace
+    * @param[in] transpose  Transpose values -> coefficients transformation
+    * (default is false)
+    */
+    template <nda::MemoryArray Tg, nda::MemoryArray Tc, nda::Scalar S = nda::get_value_t<Tg>>
+    void vals2coefs_into(Tg const &g, Tc &&gc, imtime_workspace &ws, bool transpose = false) const {
+
+      if (r != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+      if (gc.shape() != g.shape()) throw std::runtime_error("Output array must have the same shape as g.");
+
+      long m = g.size() / r;
 
-      return gf;
+      if constexpr (is_single_v<S>) { // Single precision: product with explicit vals -> coefs matrix
+        auto const &it2cf_s = single_mats().second;
+        if (transpose) {
+          realgemm(1.0, nda::transpose(it2cf_s), nda::reshape(g, r, m), 0.0, nda::reshape(gc, r, m));
+        } else {
+          realgemm(1.0, it2cf_s, nda::reshape(g, r, m), 0.0, nda::reshape(gc, r, m));
+        }
+      } else {
+
+        // Copy data into workspace in Fortran Layout as required by getrs
+        auto buf = ws.matrix<S, F_layout>(0, r, m);
+        buf      = nda::reshape(g, r, m);
+
+        // Solve linear system (multiple right hand sides) to convert vals -> coeffs
+        it2cf_solve(buf, transpose, ws);
+
+        nda::reshape(gc, r, m) = buf;
+      }
     }
 
     /** 
@@ -132,16 +248,53 @@ namespace cppdlr {
     * */
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> typename T::regular_type coefs2vals(T const &gc) const {
 
+      CPPDLR_PROBE("imtime_ops::coefs2vals", gc.size() * sizeof(S), instrument::fma_flops<S> * r * gc.size());
+
       if (r != gc.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
 
-      // Reshape gc to a matrix w/ first dimension r
-      auto gc_rs = nda::reshape(gc, r, gc.size() / r);
+      if constexpr (is_single_v<S>) { // Single precision copy of coeffs -> vals matrix
+
+        auto gcs = nda::array<S, get_rank<T>>(gc);
+        auto g   = nda::array<S, get_rank<T>>(gc.shape());
+        long m   = gc.size() / r;
+        realgemm(1.0, single_mats().first, nda::reshape(gcs, r, m), 0.0, nda::reshape(g, r, m));
+        return g;
+
+      } else {
+
+        // Reshape gc to a matrix w/ first dimension r
+        auto gc_rs = nda::reshape(gc, r, gc.size() / r);
 
-      // Apply coeffs -> vals matrix
-      auto g = cf2it * nda::matrix_const_view<S>(gc_rs);
+        // Apply coeffs -> vals matrix
+        auto g = basis->cf2it * nda::matrix_const_view<S>(gc_rs);
 
-      // Reshape to original dimensions and return
-      return nda::reshape(g, gc.shape());
+        // Reshape to original dimensions and return
+        return nda::reshape(g, gc.shape());
+      }
+    }
+
+    /** 
+    * @brief Transform DLR coefficients of Green's function G to values on DLR
+    * imaginary time grid, writing into a preallocated array
+    *
+    * Same as coefs2vals, but the result is written directly into @p g by a
+    * matrix-matrix product, without allocating memory.
+    *
+    * @param[in] gc DLR coefficients of G
+    * @param[out] g Values of G on DLR imaginary time grid; must have same shape
+    * as @p gc, and be contiguous
+    * */
+    template <nda::MemoryArray Tc, nda::MemoryArray Tg> void coefs2vals_into(Tc const &gc, Tg &&g) const {
+
+      if (r != gc.shape(0)) throw std::runtime_error("First dim of gc != DLR rank r.");
+      if (gc.shape() != g.shape()) throw std::runtime_error("Output array must have the same shape as gc.");
+
+      long m = gc.size() / r;
+      if constexpr (is_single_v<nda::get_value_t<Tc>>) {
+        realgemm(1.0, single_mats().first, nda::reshape(gc, r, m), 0.0, nda::reshape(g, r, m));
+      } else {
+        realgemm(1.0, basis->cf2it, nda::reshape(gc, r, m), 0.0, nda::reshape(g, r, m));
+      }
     }
 
     /** 
@@ -160,20 +313,19 @@ namespace cppdlr {
     */
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> auto coefs2eval(T const &gc, double t) const {
 
+      CPPDLR_PROBE("imtime_ops::coefs2eval", (gc.size() / r + r) * sizeof(S), instrument::fma_flops<S> * gc.size());
+
       if (r != gc.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
 
       // Scalar-valued Green's functions are handled differently than matrix-valued Green's functions
 
       if constexpr (T::rank == 1) {
 
-        // TODO: can be further optimized to reduce # exponential evals.
-        // Evaluate DLR expansion
-        S g = 0;
-        if (t >= 0) {
-          for (int l = 0; l < r; ++l) { g += k_it_abs(t, dlr_rf(l)) * gc(l); }
-        } else {
-          for (int l = 0; l < r; ++l) { g += k_it_abs(-t, -dlr_rf(l)) * gc(l); }
-        }
+        // Evaluate DLR expansion (for many evaluation points, use
+        // coefs2eval(gc, t) with a vector of points instead)
+        auto kvec = build_evalvec(t);
+        S g       = 0;
+        for (int l = 0; l < r; ++l) { g += kvec(l) * gc(l); }
 
         return g;
       } else {
@@ -208,6 +360,79 @@ namespace cppdlr {
     **/
     nda::vector<double> build_evalvec(double t) const;
 
+    /** 
+    * @brief Evaluate DLR expansion of G, given by its DLR coefficients, on a
+    * grid of imaginary time points
+    *
+    * @param[in] gc DLR coefficients of G
+    * @param[in] t  Evaluation points, in relative format
+    *
+    * @return Values of G on grid @p t; first dimension is the number of
+    * evaluation points, remaining dimensions are those of @p gc
+    *
+    * @note The evaluation matrix is built and applied in blocks of rows, so
+    * that memory usage does not grow with the number of evaluation points. If
+    * @p t is the equispaced grid returned by eqptsrel, the evaluation matrix is
+    * built using a multiplicative recurrence in place of most exponential
+    * evaluations (see build_evalmat).
+    *
+    * @note The given evaluation points must be scaled to the interval [0, 1]
+    * (rather than [0, beta]) and then given in the relative time format. Please
+    * see the "Imaginary time point format" section in the Background page of
+    * the documentation for more information.
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    typename T::regular_type coefs2eval(T const &gc, nda::vector_const_view<double> t) const {
+
+      CPPDLR_PROBE("imtime_ops::coefs2eval_grid", t.size() * (gc.size() / r * sizeof(S) + r * sizeof(double)),
+                   instrument::fma_flops<S> * t.size() * gc.size());
+
+      if (r != gc.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+
+      int n = t.size();
+
+      // Reshape gc to matrix w/ first dimension r
+      auto gc_rs = nda::matrix_const_view<S>(nda::reshape(gc, r, gc.size() / r));
+
+      // Output array: same as gc, with first dimension r replaced by n
+      auto g_shape = gc.shape();
+      g_shape[0]   = n;
+      auto g       = typename T::regular_type(g_shape);
+      auto g_rs    = nda::reshape(g, n, gc.size() / r);
+
+      // Evaluate DLR expansion one block of evaluation points at a time
+      bool eqpts = is_eqptsrel(t);
+      for (int i0 = 0; i0 < n; i0 += evalblk) {
+        int i1                      = std::min(i0 + evalblk, n);
+        auto kmat                   = (eqpts ? build_evalmat_eqpts(n, i0, i1) : build_k_it(t(nda::range(i0, i1)), basis->dlr_rf));
+        g_rs(nda::range(i0, i1), _) = kmat * gc_rs;
+      }
+
+      return g;
+    }
+
+    /** 
+    * @brief Build matrix of evaluation of DLR expansion on a grid of imaginary
+    * time points
+    *
+    * @param[in] t  Evaluation points, in relative format
+    *
+    * @return Matrix of size (# evaluation points) x r, entry (i,l) of which is
+    * the lth DLR basis function evaluated at t(i)
+    *
+    * @note If @p t is the equispaced grid returned by eqptsrel, the matrix is
+    * built using the recurrence exp(-(i+1) h om) = exp(-i h om) exp(-h om),
+    * run in the direction in which the basis function decays, and restarted
+    * from a direct evaluation every few points to limit error accumulation.
+    * This replaces most exponential evaluations by multiplications.
+    *
+    * @note The given evaluation points must be scaled to the interval [0, 1]
+    * (rather than [0, beta]) and then given in the relative time format. Please
+    * see the "Imaginary time point format" section in the Background page of
+    * the documentation for more information.
+    **/
+    nda::matrix<double> build_evalmat(nda::vector_const_view<double> t) const;
+
     /** 
     * @brief Obtain DLR coefficients of a Green's function G from scattered
     * imaginary time grid by least squares fitting
@@ -220,6 +445,9 @@ namespace cppdlr {
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
     typename T::regular_type fitvals2coefs(nda::vector_const_view<double> t, T const &g) const {
 
+      CPPDLR_PROBE("imtime_ops::fitvals2coefs", t.size() * r * sizeof(double) + 2 * g.size() * sizeof(S),
+                   instrument::fma_flops<S> * r * (t.size() * r + g.size()));
+
       // Check first dimension of g equal to length of t
       int n = t.size();
       if (n != g.shape(0)) throw std::runtime_error("First dim of g must be equal to length of t.");
@@ -227,10 +455,7 @@ namespace cppdlr {
       // Get matrix for least squares fitting: columns are DLR basis functions
       // evaluating at data points t. Must built in Fortran layout for
       // compatibility with LAPACK.
-      auto kmat = nda::matrix<S, F_layout>(n, r); // Make sure matrix has same scalar type as g
-      for (int j = 0; j < r; ++j) {
-        for (int i = 0; i < n; ++i) { kmat(i, j) = k_it(t(i), dlr_rf(j)); }
-      }
+      auto kmat = nda::matrix<S, F_layout>(build_k_it(t, basis->dlr_rf)); // Make sure matrix has same scalar type as g
 
       // Reshape g to matrix w/ first dimension n, and put in Fortran layout for
       // compatibility w/ LAPACK
@@ -262,16 +487,18 @@ namespace cppdlr {
     */
     template <nda::MemoryArray T> typename T::regular_type reflect(T const &g) const {
 
+      CPPDLR_PROBE("imtime_ops::reflect", g.size() * sizeof(nda::get_value_t<T>), instrument::fma_flops<nda::get_value_t<T>> * r * g.size());
+
       if (r != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
 
       // Initialize reflection matrix, if it hasn't been done already
-      if (refl.empty()) { reflect_init(); }
+      reflect_init();
 
       if constexpr (T::rank == 1) { // Scalar-valued Green's function
-        return matmul(refl, g);
+        return matmul(basis->refl, g);
       } else {
         auto gr                      = typename T::regular_type(g.shape());       // Output has same type/shape as g
-        reshape(gr, r, g.size() / r) = matmul(refl, reshape(g, r, g.size() / r)); // Reshape, matrix multiply, reshape back
+        reshape(gr, r, g.size() / r) = matmul(basis->refl, reshape(g, r, g.size() / r)); // Reshape, matrix multiply, reshape back
         return gr;
       }
     }
@@ -308,50 +535,287 @@ namespace cppdlr {
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
     typename T::regular_type convolve(double beta, statistic_t statistic, T const &fc, T const &gc, bool time_order = false) const {
 
+      CPPDLR_PROBE("imtime_ops::convolve", 4 * fc.size() * sizeof(S),
+                   instrument::fma_flops<S> * (4.0 * r * fc.size() + fc.size() * std::sqrt(fc.size() / r)));
+
       if (r != fc.shape(0) || r != gc.shape(0)) throw std::runtime_error("First dim of input arrays must be equal to DLR rank r.");
       if (fc.shape() != gc.shape()) throw std::runtime_error("Input arrays must have the same shape.");
 
-      // TODO: implement bosonic case and remove
-      if (statistic == 0) throw std::runtime_error("imtime_ops::convolve not yet implemented for bosonic Green's functions.");
+      if constexpr (is_single_v<S>) { // Single precision: algorithm of convolve_into, with single precision matrices
+
+        auto fcs = nda::array<S, T::rank>(fc);
+        auto gcs = nda::array<S, T::rank>(gc);
+        auto h   = nda::array<S, T::rank>(fc.shape());
+        auto ws  = imtime_workspace();
+        convolve_into(beta, statistic, fcs, gcs, h, ws, time_order);
+        return h;
+
+      } else {
+
+        // Get view of helper matrices based on statistic and time_order flag,
+        // initializing them if it hasn't been done already
+        auto [hilb_v, tcf2it_v] = convolve_mats(statistic, time_order);
+
+        if constexpr (T::rank == 1) { // Scalar-valued Green's function
+
+          // Take array view of fc and gc
+          auto fca = nda::array_const_view<S, 1>(fc);
+          auto gca = nda::array_const_view<S, 1>(gc);
+
+          // Diagonal contribution
+          auto h = matvecmul(tcf2it_v, make_regular(fca * gca));
+
+          // Off-diagonal contribution
+          auto tmp = fca * arraymult(hilb_v, gca) + gca * arraymult(hilb_v, fca);
+          return beta * (h + matvecmul(basis->cf2it, make_regular(tmp)));
+
+        } else if (T::rank == 3) { // Matrix-valued Green's function
+
+          // Diagonal contribution
+          auto fcgc = nda::array<S, 3>(fc.shape()); // Product of coefficients of f and g
+          gemm_batch(1.0, fc, gc, 0.0, fcgc);
+          auto h = arraymult(tcf2it_v, fcgc);
+
+          // Off-diagonal contribution (products written into fcgc, which is no
+          // longer needed)
+          auto tmp1 = arraymult(hilb_v, fc);
+          auto tmp2 = arraymult(hilb_v, gc);
+          gemm_batch(1.0, tmp1, gc, 0.0, fcgc);
+          gemm_batch(1.0, fc, tmp2, 1.0, fcgc);
+
+          return beta * (h + arraymult(basis->cf2it, fcgc));
+
+        } else {
+          throw std::runtime_error("Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+        }
+      }
+    }
+
+    /** 
+    * @brief Compute convolution of two imaginary time Green's functions,
+    * writing into a preallocated array
+    *
+    * Same as convolve(double, statistic_t, T const &, T const &, bool), but the
+    * result is written into @p h, and scratch storage is taken from @p ws, so
+    * that no memory is allocated once @p ws has been used for arrays of the
+    * same size.
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc DLR coefficients of f
+    * @param[in] gc DLR coefficients of g
+    * @param[out] h Values of h = f * g on DLR imaginary time grid; must have
+    * same shape as @p fc, and be contiguous
+    * @param[in] ws Workspace
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    * */
+    template <nda::MemoryArray T, nda::MemoryArray Th, nda::Scalar S = nda::get_value_t<T>>
+    void convolve_into(double beta, statistic_t statistic, T const &fc, T const &gc, Th &&h, imtime_workspace &ws, bool time_order = false) const {
+
+      CPPDLR_PROBE("imtime_ops::convolve_into", 0, instrument::fma_flops<S> * (4.0 * r * fc.size() + fc.size() * std::sqrt(fc.size() / r)));
+
+      static_assert(T::rank == 1 || T::rank == 3,
+                    "Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+      if (r != fc.shape(0) || r != gc.shape(0)) throw std::runtime_error("First dim of input arrays must be equal to DLR rank r.");
+      if (fc.shape() != gc.shape() || fc.shape() != h.shape()) throw std::runtime_error("Input and output arrays must have the same shape.");
+
+      // Get view of helper matrices based on statistic and time_order flag,
+      // in the precision of the Green's functions, initializing them if it
+      // hasn't been done already
+      auto [hilb_v, tcf2it_v, cf2it_v] = convolve_mats<S>(statistic, time_order);
 
-      // Initialize convolution, if it hasn't been done already
-      if (!time_order & hilb.empty()) { convolve_init(); }
-      if (time_order & thilb.empty()) { tconvolve_init(); }
+      long m     = fc.size() / r;
+      auto fc_rs = nda::reshape(fc, r, m);
+      auto gc_rs = nda::reshape(gc, r, m);
 
-      // Get view of helper matrices based on time_order flag
-      auto hilb_v   = (time_order ? nda::matrix_const_view<double>(thilb) : nda::matrix_const_view<double>(hilb));
-      auto tcf2it_v = (time_order ? nda::matrix_const_view<double>(ttcf2it) : nda::matrix_const_view<double>(tcf2it));
+      // Hilbert transforms of coefficients of f and g
+      auto hf = ws.matrix<S>(0, r, m);
+      auto hg = ws.matrix<S>(1, r, m);
+      realgemm(1.0, hilb_v, fc_rs, 0.0, hf);
+      realgemm(1.0, hilb_v, gc_rs, 0.0, hg);
+
+      // Products of coefficients for diagonal (p) and off-diagonal (q)
+      // contributions
+      auto p = ws.matrix<S>(2, r, m);
+      auto q = ws.matrix<S>(3, r, m);
 
       if constexpr (T::rank == 1) { // Scalar-valued Green's function
+        for (int i = 0; i < r; ++i) {
+          p(i, 0) = fc(i) * gc(i);
+          q(i, 0) = hf(i, 0) * gc(i) + fc(i) * hg(i, 0);
+        }
+      } else { // Matrix-valued Green's function
+        long norb = fc.shape(1);
+        auto p3   = nda::reshape(p, r, norb, norb);
+        auto q3   = nda::reshape(q, r, norb, norb);
+        gemm_batch(1.0, fc, gc, 0.0, p3);
+        gemm_batch(1.0, nda::reshape(hf, r, norb, norb), gc, 0.0, q3);
+        gemm_batch(1.0, fc, nda::reshape(hg, r, norb, norb), 1.0, q3);
+      }
+
+      // h = beta * (tcf2it * p + cf2it * q)
+      auto h_rs = nda::reshape(h, r, m);
+      realgemm(beta, tcf2it_v, p, 0.0, h_rs);
+      realgemm(beta, cf2it_v, q, 1.0, h_rs);
+    }
+
+    /**
+    * @brief Transform values of a batch of Green's functions on DLR imaginary
+    * time grid to DLR coefficients
+    *
+    * Equivalent to calling vals2coefs on each g(b, ...), but all right hand
+    * sides are passed to a single triangular solve.
+    *
+    * @param[in] g          Values of Green's functions on DLR imaginary time
+    * grid; first dimension is the batch index, second dimension is r
+    * @param[in] transpose  Transpose values -> coefficients transformation
+    * (default is false)
+    *
+    * @return DLR coefficients of Green's functions, in the same layout as @p g
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    typename T::regular_type vals2coefs_batch(T const &g, bool transpose = false) const {
 
-        // Take array view of fc and gc
-        auto fca = nda::array_const_view<S, 1>(fc);
-        auto gca = nda::array_const_view<S, 1>(gc);
+      static_assert(T::rank >= 2, "Input array must have a batch dimension and a DLR dimension.");
+      if (r != g.shape(1)) throw std::runtime_error("Second dim of g != DLR rank r.");
 
-        // Diagonal contribution
-        auto h = matvecmul(tcf2it_v, make_regular(fca * gca));
+      // Gather all right hand sides in a single matrix, in Fortran layout as
+      // required by getrs
+      auto buf = batch_gather<F_layout>(g);
 
-        // Off-diagonal contribution
-        auto tmp = fca * arraymult(hilb_v, gca) + gca * arraymult(hilb_v, fca);
-        return beta * (h + matvecmul(cf2it, make_regular(tmp)));
+      // Solve linear system (multiple right hand sides) to convert vals -> coeffs
+      auto ws = imtime_workspace();
+      it2cf_solve(buf, transpose, ws);
 
-      } else if (T::rank == 3) { // Matrix-valued Green's function
+      auto gc = typename T::regular_type(g.shape());
+      batch_scatter(buf, gc);
 
-        // Diagonal contribution
-        auto fcgc = nda::array<S, 3>(fc.shape()); // Product of coefficients of f and g
-        for (int i = 0; i < r; ++i) { fcgc(i, _, _) = matmul(fc(i, _, _), gc(i, _, _)); }
-        auto h = arraymult(tcf2it_v, fcgc);
+      return gc;
+    }
 
-        // Off-diagonal contribution
-        auto tmp1 = arraymult(hilb_v, fc);
-        auto tmp2 = arraymult(hilb_v, gc);
-        for (int i = 0; i < r; ++i) { tmp1(i, _, _) = matmul(tmp1(i, _, _), gc(i, _, _)) + matmul(fc(i, _, _), tmp2(i, _, _)); }
+    /**
+    * @brief Transform DLR coefficients of a batch of Green's functions to
+    * values on DLR imaginary time grid
+    *
+    * Equivalent to calling coefs2vals on each gc(b, ...), but performed as a
+    * single matrix-matrix product.
+    *
+    * @param[in] gc DLR coefficients of Green's functions; first dimension is
+    * the batch index, second dimension is r
+    *
+    * @return Values of Green's functions on DLR imaginary time grid, in the
+    * same layout as @p gc
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> typename T::regular_type coefs2vals_batch(T const &gc) const {
 
-        return beta * (h + arraymult(cf2it, tmp1));
+      static_assert(T::rank >= 2, "Input array must have a batch dimension and a DLR dimension.");
+      if (r != gc.shape(1)) throw std::runtime_error("Second dim of gc != DLR rank r.");
 
-      } else {
-        throw std::runtime_error("Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+      auto g = typename T::regular_type(gc.shape());
+      batch_scatter(nda::matrix<S>(basis->cf2it * batch_gather<nda::C_layout>(gc)), g);
+
+      return g;
+    }
+
+    /**
+    * @brief Compute reflection of a batch of imaginary time Green's functions
+    *
+    * Equivalent to calling reflect on each g(b, ...), but performed as a
+    * single matrix-matrix product.
+    *
+    * @param[in] g Values of Green's functions at DLR imaginary time nodes;
+    * first dimension is the batch index, second dimension is r
+    *
+    * @return Values of reflections at DLR imaginary time nodes, in the same
+    * layout as @p g
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> typename T::regular_type reflect_batch(T const &g) const {
+
+      static_assert(T::rank >= 2, "Input array must have a batch dimension and a DLR dimension.");
+      if (r != g.shape(1)) throw std::runtime_error("Second dim of g != DLR rank r.");
+
+      // Initialize reflection matrix, if it hasn't been done already
+      reflect_init();
+
+      auto gr = typename T::regular_type(g.shape());
+      batch_scatter(nda::matrix<S>(basis->refl * batch_gather<nda::C_layout>(g)), gr);
+
+      return gr;
+    }
+
+    /**
+    * @brief Compute convolutions of a batch of pairs of imaginary time Green's
+    * functions
+    *
+    * Equivalent to calling convolve(beta, statistic, fc(b, ...), gc(b, ...),
+    * time_order) for each b, but the applications of the r x r convolution
+    * matrices are performed as single matrix-matrix products over the whole
+    * batch.
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc DLR coefficients of f; first dimension is the batch index,
+    * second dimension is r
+    * @param[in] gc DLR coefficients of g, same shape as @p fc
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return Values of h = f * g on DLR imaginary time grid, in the same
+    * layout as @p fc
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    typename T::regular_type convolve_batch(double beta, statistic_t statistic, T const &fc, T const &gc, bool time_order = false) const {
+
+      static_assert(T::rank == 2 || T::rank == 4,
+                    "Input arrays must be rank 2 (batch of scalar-valued Green's functions) or 4 (batch of matrix-valued Green's functions).");
+      if (r != fc.shape(1) || r != gc.shape(1)) throw std::runtime_error("Second dim of input arrays must be equal to DLR rank r.");
+      if (fc.shape() != gc.shape()) throw std::runtime_error("Input arrays must have the same shape.");
+
+      // Get view of helper matrices based on statistic and time_order flag,
+      // initializing them if it hasn't been done already
+      auto [hilb_v, tcf2it_v] = convolve_mats(statistic, time_order);
+
+      // Gather coefficients of all f's and g's, and apply Hilbert transform
+      // matrix to all of them at once
+      auto fb = batch_gather<nda::C_layout>(fc);
+      auto gb = batch_gather<nda::C_layout>(gc);
+      auto hf = nda::matrix<S>(hilb_v * fb);
+      auto hg = nda::matrix<S>(hilb_v * gb);
+
+      // Products of coefficients for diagonal (p) and off-diagonal (q)
+      // contributions
+      auto p = nda::matrix<S>(fb.shape());
+      auto q = nda::matrix<S>(fb.shape());
+
+      if constexpr (T::rank == 2) { // Scalar-valued Green's functions
+
+        // Take array views for elementwise products
+        auto fba = nda::array_const_view<S, 2>(fb);
+        auto gba = nda::array_const_view<S, 2>(gb);
+        auto hfa = nda::array_const_view<S, 2>(hf);
+        auto hga = nda::array_const_view<S, 2>(hg);
+
+        nda::array_view<S, 2>(p) = fba * gba;
+        nda::array_view<S, 2>(q) = hfa * gba + fba * hga;
+
+      } else { // Matrix-valued Green's functions
+
+        // Row i of each gathered matrix holds the nb norb x norb blocks of
+        // DLR index i, so it can be viewed as a batch of r * nb matrices
+        long nb   = fc.shape(0);
+        long norb = fc.shape(2);
+        auto blk  = [&](auto &x) { return nda::reshape(x, r * nb, norb, norb); };
+
+        gemm_batch(1.0, blk(fb), blk(gb), 0.0, blk(p));
+        gemm_batch(1.0, blk(hf), blk(gb), 0.0, blk(q));
+        gemm_batch(1.0, blk(fb), blk(hg), 1.0, blk(q));
       }
+
+      auto h = typename T::regular_type(fc.shape());
+      batch_scatter(nda::matrix<S>(beta * (tcf2it_v * p + basis->cf2it * q)), h);
+
+      return h;
     }
 
     /** 
@@ -451,18 +915,13 @@ namespace cppdlr {
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
     nda::matrix<S> convmat(double beta, statistic_t statistic, T const &fc, bool time_order = false) const {
 
-      if (r != fc.shape(0)) throw std::runtime_error("First dim of input array must be equal to DLR rank r.");
-
-      // TODO: implement bosonic case and remove
-      if (statistic == 0) throw std::runtime_error("imtime_ops::convmat not yet implemented for bosonic Green's functions.");
+      CPPDLR_PROBE("imtime_ops::convmat", 2 * r * fc.size() * sizeof(S), instrument::fma_flops<S> * 2.0 * r * r * fc.size());
 
-      // Initialize convolution, if it hasn't been done already
-      if (!time_order & hilb.empty()) { convolve_init(); }
-      if (time_order & thilb.empty()) { tconvolve_init(); }
+      if (r != fc.shape(0)) throw std::runtime_error("First dim of input array must be equal to DLR rank r.");
 
-      // Get view of helper matrices based on time_order flag
-      auto hilb_v   = (time_order ? nda::matrix_const_view<double>(thilb) : nda::matrix_const_view<double>(hilb));
-      auto tcf2it_v = (time_order ? nda::matrix_const_view<double>(ttcf2it) : nda::matrix_const_view<double>(tcf2it));
+      // Get view of helper matrices based on statistic and time_order flag,
+      // initializing them if it hasn't been done already
+      auto [hilb_v, tcf2it_v] = convolve_mats(statistic, time_order);
 
       if constexpr (T::rank == 1) { // Scalar-valued Green's function
 
@@ -485,73 +944,213 @@ namespace cppdlr {
           }
           tmp2(k, k) += tmp1(k); // diag(fc)*hilb + diag(hilb*fc)
         }
-        fconv += matmul(cf2it, tmp2);
+        fconv += matmul(basis->cf2it, tmp2);
 
-        // Then precompose with DLR grid values to DLR coefficients matrix
-        if constexpr (nda::is_complex_v<S>) {                         // getrs requires matrix and rhs to have same value type
-          nda::lapack::getrs(transpose(it2cf.zlu), fconv, it2cf.piv); // Note: lapack effectively tranposes fconv by fortran reordering here
-        } else {
-          // getrs requires matrix and rhs to have same value type
-          nda::lapack::getrs(transpose(it2cf.lu), fconv, it2cf.piv);
-        }
+        // Then precompose with DLR grid values to DLR coefficients matrix:
+        // fconv * it2cf = (it2cf^T * fconv^T)^T
+        auto ws = imtime_workspace();
+        it2cf_solve(nda::transpose(fconv), true, ws);
 
         return beta * fconv;
 
       } else if (T::rank == 3) { // Matrix-valued Green's function
 
-        int norb1 = fc.shape(1);
-        int norb2 = fc.shape(2);
+        // Build all rows at once; see convmat_rows
+        return convmat_rows(beta, statistic, fc, nda::range(r), time_order);
 
-        // First construct convolution matrix from DLR coefficients to DLR grid
-        // values
-        auto fconv    = nda::matrix<S>(r * norb1, r * norb2);    // Matrix of convolution by f
-        auto fconv_rs = nda::reshape(fconv, r, norb1, r, norb2); // Array view to index into fconv for conevenience
+      } else {
+        throw std::runtime_error("Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+      }
+    }
 
-        // Diagonal contribution (given by diag(tau_k) * K(tau_k, om_l) * diag(fc_l))
-        for (int k = 0; k < r; ++k) {
-          for (int l = 0; l < r; ++l) { fconv_rs(k, _, l, _) = tcf2it_v(k, l) * fc(l, _, _); }
+    /**
+    * @brief Compute a block of rows of the matrix of convolution by an
+    * imaginary time Green's function
+    *
+    * Returns the rows of the matrix computed by convmat corresponding to the
+    * DLR imaginary time nodes in @p rows, i.e. the block rows rows.first(),
+    * ..., rows.last() - 1 of size norb1 each. Each block row is computed
+    * independently, with O(r * norb1 * norb2) working memory beyond the output,
+    * so that the convolution matrix can be built directly in distributed
+    * blocks (e.g. by each process of a parallel solver, for its own block
+    * rows) without forming the full matrix anywhere.
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc DLR coefficients of f
+    * @param[in] rows Range of DLR imaginary time node indices, with step 1
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return Rows of matrix of convolution by f, of size rows.size()*norb1 x
+    * r*norb2
+    *
+    * \note The block row of DLR node k is given by its diagonal contribution
+    * diag(tau_k) * K(tau_k, om_l) * fc_l, and off-diagonal contribution K(tau_k,
+    * om_l) * (hilb*fc)_l + sum_k' K(tau_k, om_k') * hilb(k', l) * fc_k', where
+    * K is the matrix K(dlr_it(k), dlr_rf(l)), precomposed with the DLR grid
+    * values to DLR coefficients matrix.
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::matrix<S> convmat_rows(double beta, statistic_t statistic, T const &fc, nda::range rows, bool time_order = false) const {
+
+      static_assert(T::rank == 1 || T::rank == 3,
+                    "Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+      if (r != fc.shape(0)) throw std::runtime_error("First dim of input array must be equal to DLR rank r.");
+      if (rows.step() != 1 || rows.first() < 0 || rows.last() > r) throw std::runtime_error("Rows must be a contiguous range of DLR node indices.");
+
+      CPPDLR_PROBE("imtime_ops::convmat_rows", 2 * rows.size() * fc.size() * sizeof(S), instrument::fma_flops<S> * 2.0 * r * rows.size() * fc.size());
+
+      // Get view of helper matrices based on statistic and time_order flag,
+      // initializing them if it hasn't been done already
+      auto [hilb_v, tcf2it_v] = convolve_mats(statistic, time_order);
+
+      long norb1 = (T::rank == 1 ? 1 : fc.shape(1));
+      long norb2 = (T::rank == 1 ? 1 : fc.shape(2));
+      long nn    = norb1 * norb2;
+      long k0    = rows.first();
+      long nk    = rows.size();
+
+      // Contiguous copies of coefficients of f and hilb * f, as r x norb1*norb2 matrices
+      auto fca = nda::matrix<S>(r, nn);
+      auto hfc = nda::matrix<S>(r, nn);
+      if constexpr (T::rank == 1) {
+        fca(_, 0) = fc;
+      } else {
+        nda::reshape(fca, r, norb1, norb2) = fc;
+      }
+      realgemm(1.0, hilb_v, fca, 0.0, hfc);
+
+      // The block rows are built in (k, a, b, l) index order, with the column
+      // DLR index l last, so that the solve with it2cf below acts on them in
+      // place. They are permuted to the (k, a, l, b) order of the output at the
+      // end.
+      auto fconvp  = nda::matrix<S>(nk * nn, r);
+      auto fconvp3 = nda::reshape(fconvp, nk, nn, r);
+      auto m       = nda::matrix<S>(r, r); // K(tau_k, om_k') * hilb(k', l) for fixed k
+      for (long i = 0; i < nk; ++i) {
+        long k = k0 + i;
+
+        // Diagonal contribution, and off-diagonal contribution from hilb*fc
+        for (long ab = 0; ab < nn; ++ab) {
+          for (int l = 0; l < r; ++l) { fconvp3(i, ab, l) = tcf2it_v(k, l) * fca(l, ab) + basis->cf2it(k, l) * hfc(l, ab); }
         }
 
-        // Off-diagonal contribution (given by K * (diag(hilb*fc) +
-        // (diag(fc)*hilb)), where K is the matrix K(dlr_it(k), dlr_rf(l))
-        auto tmp1 = arraymult(hilb_v, fc); // hilb * fc
-        auto tmp2 = nda::array<S, 4>(r, norb1, r, norb2);
-        for (int k = 0; k < r; ++k) {
+        // Remaining off-diagonal contribution: fconv_k += fc^T * m
+        for (int kp = 0; kp < r; ++kp) {
+          for (int l = 0; l < r; ++l) { m(kp, l) = basis->cf2it(k, kp) * hilb_v(kp, l); }
+        }
+        nda::blas::gemm(1.0, nda::transpose(fca), m, 1.0, fconvp(nda::range(i * nn, (i + 1) * nn), _));
+      }
+
+      // Precompose with DLR grid values to DLR coefficients matrix, in place:
+      // fconvp * it2cf = (it2cf^T * fconvp^T)^T
+      auto ws = imtime_workspace();
+      it2cf_solve(nda::transpose(fconvp), true, ws);
+
+      // Permute to (k, a, l, b) order, and scale by beta
+      auto fconv    = nda::matrix<S>(nk * norb1, r * norb2);
+      auto fconv_rs = nda::reshape(fconv, nk, norb1, r, norb2);
+      auto fconvp4  = nda::reshape(fconvp, nk, norb1, norb2, r);
+      for (long i = 0; i < nk; ++i) {
+        for (long a = 0; a < norb1; ++a) {
           for (int l = 0; l < r; ++l) {
-            tmp2(k, _, l, _) = fc(k, _, _) * hilb_v(k, l); // diag(fc) * hilb
+            for (long b = 0; b < norb2; ++b) { fconv_rs(i, a, l, b) = beta * fconvp4(i, a, b, l); }
           }
-          tmp2(k, _, k, _) += tmp1(k, _, _); // diag(fc)*hilb + diag(hilb*fc)
         }
-        fconv_rs += arraymult(cf2it, tmp2);
+      }
 
-        // Then precompose with DLR grid values to DLR coefficients matrix
+      return fconv;
+    }
 
-        // Transpose last two indices to put make column DLR index the last
-        // index
-        auto fconvtmp    = nda::matrix<S>(r * norb1 * norb2, r);
-        auto fconvtmp_rs = nda::reshape(fconvtmp, r, norb1, norb2, r);
-        for (int i = 0; i < norb2; ++i) {
-          for (int k = 0; k < r; ++k) { fconvtmp_rs(_, _, i, k) = fconv_rs(_, _, k, i); }
-        }
+    /**
+    * @brief Transform values of a block-diagonal matrix-valued Green's
+    * function at DLR imaginary time nodes to DLR expansion coefficients, block
+    * by block
+    *
+    * @param[in] g List of diagonal blocks of Green's function values, e.g. as
+    * obtained by split_blocks
+    * @param[in] transpose Flag as in imtime_ops::vals2coefs
+    *
+    * @return List of DLR coefficients of the diagonal blocks
+    */
+    template <nda::MemoryArray T> std::vector<typename T::regular_type> vals2coefs(std::vector<T> const &g, bool transpose = false) const {
 
-        // Do the solve
-        if constexpr (nda::is_complex_v<S>) {                            // getrs requires matrix and rhs to have same value type
-          nda::lapack::getrs(transpose(it2cf.zlu), fconvtmp, it2cf.piv); // Note: lapack effectively tranposes fconv by fortran reordering here
-        } else {
-          // getrs requires matrix and rhs to have same value type
-          nda::lapack::getrs(transpose(it2cf.lu), fconvtmp, it2cf.piv);
-        }
+      auto gc = std::vector<typename T::regular_type>();
+      gc.reserve(g.size());
+      for (auto const &gb : g) { gc.push_back(vals2coefs(gb, transpose)); }
 
-        // Transpose back
-        for (int i = 0; i < norb2; ++i) {
-          for (int k = 0; k < r; ++k) { fconv_rs(_, _, k, i) = fconvtmp_rs(_, _, i, k); }
-        }
+      return gc;
+    }
 
-        return beta * fconv;
+    /**
+    * @brief Transform DLR coefficients of a block-diagonal matrix-valued
+    * Green's function to values at DLR imaginary time nodes, block by block
+    *
+    * @param[in] gc List of DLR coefficients of the diagonal blocks
+    *
+    * @return List of values of the diagonal blocks at DLR imaginary time nodes
+    */
+    template <nda::MemoryArray T> std::vector<typename T::regular_type> coefs2vals(std::vector<T> const &gc) const {
 
-      } else {
-        throw std::runtime_error("Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
-      }
+      auto g = std::vector<typename T::regular_type>();
+      g.reserve(gc.size());
+      for (auto const &gcb : gc) { g.push_back(coefs2vals(gcb)); }
+
+      return g;
+    }
+
+    /**
+    * @brief Compute convolution of two block-diagonal matrix-valued imaginary
+    * time Green's functions with the same block structure, block by block
+    *
+    * The convolution of block-diagonal Green's functions is block-diagonal, so
+    * the cost is a sum over blocks of the cost of imtime_ops::convolve.
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc List of DLR coefficients of the diagonal blocks of f
+    * @param[in] gc List of DLR coefficients of the diagonal blocks of g
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return List of values of the diagonal blocks of the convolution at DLR
+    * imaginary time nodes
+    */
+    template <nda::MemoryArray T>
+    std::vector<typename T::regular_type> convolve(double beta, statistic_t statistic, std::vector<T> const &fc, std::vector<T> const &gc,
+                                                   bool time_order = false) const {
+
+      if (fc.size() != gc.size()) throw std::runtime_error("Input lists of blocks must have the same length.");
+
+      auto h = std::vector<typename T::regular_type>();
+      h.reserve(fc.size());
+      for (size_t i = 0; i < fc.size(); ++i) { h.push_back(convolve(beta, statistic, fc[i], gc[i], time_order)); }
+
+      return h;
+    }
+
+    /**
+    * @brief Compute matrices of convolution by the diagonal blocks of a
+    * block-diagonal matrix-valued imaginary time Green's function
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc List of DLR coefficients of the diagonal blocks of f
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return List of matrices of convolution by the diagonal blocks of f, the
+    * ith of size r*n_i x r*n_i, with n_i the size of the ith block
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    std::vector<nda::matrix<S>> convmat(double beta, statistic_t statistic, std::vector<T> const &fc, bool time_order = false) const {
+
+      auto fconv = std::vector<nda::matrix<S>>();
+      fconv.reserve(fc.size());
+      for (auto const &fcb : fc) { fconv.push_back(convmat(beta, statistic, fcb, time_order)); }
+
+      return fconv;
     }
 
     /** 
@@ -577,20 +1176,36 @@ namespace cppdlr {
     * */
     template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> S innerprod(T const &fc, T const &gc) const {
 
+      CPPDLR_PROBE("imtime_ops::innerprod", fc.size() * sizeof(S), instrument::fma_flops<S> * r * fc.size());
+
       if (r != fc.shape(0) || r != gc.shape(0)) throw std::runtime_error("First dim of input arrays must be equal to DLR rank r.");
       if (fc.shape() != gc.shape()) throw std::runtime_error("Input arrays must have the same shape.");
 
       // Initialize inner product matrix, if it hasn't been done already
-      if (ipmat.empty()) { innerprod_init(); }
+      innerprod_init();
 
       S ip = 0;
       if constexpr (T::rank == 1) { // Scalar-valued Green's function
-        ip = nda::blas::dotc(fc, matvecmul(ipmat, gc));
+        ip = nda::blas::dotc(fc, matvecmul(basis->ipmat, gc));
       } else if (T::rank == 3) { // Matrix-valued Green's function
-        int norb = fc.shape(1);
-        // Compute inner product
-        for (int i = 0; i < norb; ++i) {
-          for (int j = 0; j < norb; ++j) { ip += nda::blas::dotc(fc(_, i, j), matvecmul(ipmat, gc(_, i, j))); }
+        int n1 = fc.shape(1), n2 = fc.shape(2);
+
+        // Apply inner product matrix to all orbital components at once
+        auto gcm = nda::matrix<S>(nda::reshape(nda::array<S, 3>(gc), r, n1 * n2));
+        auto mg  = nda::matrix<S>(r, n1 * n2);
+        realgemm(1.0, basis->ipmat, gcm, 0.0, mg);
+
+        // Contract with conj(f)
+        for (int k = 0; k < r; ++k) {
+          for (int i = 0; i < n1; ++i) {
+            for (int j = 0; j < n2; ++j) {
+              if constexpr (nda::is_complex_v<S>) {
+                ip += std::conj(fc(k, i, j)) * mg(k, i * n2 + j);
+              } else {
+                ip += fc(k, i, j) * mg(k, i * n2 + j);
+              }
+            }
+          }
         }
       } else {
         throw std::runtime_error("Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
@@ -599,13 +1214,64 @@ namespace cppdlr {
       return ip;
     }
 
+    /**
+    * @brief Compute matrix of inner products of a list of imaginary time Green's
+    * functions
+    *
+    * Given Green's functions f_1, ..., f_n, this method returns the Gram matrix
+    * with entries (f_a, f_b), with the inner product of imtime_ops::innerprod.
+    * The inner product matrix is applied to all Green's functions and orbital
+    * components by a single matrix-matrix product, and the Gram matrix is
+    * obtained by a second one.
+    *
+    * @param[in] fc List of DLR coefficients of f_1, ..., f_n, all of the same
+    * shape
+    *
+    * @return n x n Gram matrix G, with G(a, b) = (f_a, f_b)
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> nda::matrix<S> innerprod_matrix(std::vector<T> const &fc) const {
+
+      static_assert(T::rank == 1 || T::rank == 3,
+                    "Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+
+      int n = fc.size();
+      if (n == 0) return nda::matrix<S>(0, 0);
+
+      for (auto const &f : fc) {
+        if (r != f.shape(0)) throw std::runtime_error("First dim of input arrays must be equal to DLR rank r.");
+        if (f.shape() != fc[0].shape()) throw std::runtime_error("Input arrays must have the same shape.");
+      }
+
+      int m = fc[0].size() / r; // Number of orbital components
+
+      CPPDLR_PROBE("imtime_ops::innerprod_matrix", n * fc[0].size() * sizeof(S), instrument::fma_flops<S> * (r + n) * n * fc[0].size());
+
+      // Initialize inner product matrix, if it hasn't been done already
+      innerprod_init();
+
+      // Gather Green's functions into array x, with x(k, c, a) the kth DLR
+      // coefficient of orbital component c of f_a
+      auto x = nda::array<S, 3>(r, m, n);
+      for (int a = 0; a < n; ++a) { x(_, _, a) = nda::reshape(nda::array<S, T::rank>(fc[a]), r, m); }
+
+      // Apply inner product matrix
+      auto y = nda::array<S, 3>(r, m, n);
+      realgemm(1.0, basis->ipmat, nda::reshape(x, r, m * n), 0.0, nda::reshape(y, r, m * n));
+
+      // Contract with conj(x) over DLR and orbital indices
+      auto xh = nda::matrix<S>(nda::transpose(nda::reshape(x, r * m, n)));
+      if constexpr (nda::is_complex_v<S>) { xh = nda::conj(xh); }
+
+      return nda::matrix<S>(nda::matmul(xh, nda::reshape(y, r * m, n)));
+    }
+
     /** 
     * @brief Get DLR imaginary time nodes
     *
     * @return DLR imaginary time nodes
     */
-    nda::vector_const_view<double> get_itnodes() const { return dlr_it; };
-    double get_itnodes(int i) const { return dlr_it(i); };
+    nda::vector_const_view<double> get_itnodes() const { return basis->dlr_it; };
+    double get_itnodes(int i) const { return basis->dlr_it(i); };
 
     /** Access DLR imaginary real frequency nodes*/
     /**
@@ -613,37 +1279,57 @@ namespace cppdlr {
     *
     * @return DLR real frequency nodes
     */
-    nda::vector_const_view<double> get_rfnodes() const { return dlr_rf; };
-    double get_rfnodes(int i) const { return dlr_rf(i); };
+    nda::vector_const_view<double> get_rfnodes() const { return basis->dlr_rf; };
+    double get_rfnodes(int i) const { return basis->dlr_rf(i); };
 
     /**
     * @brief Get transformation matrix from DLR coefficients to values at DLR imaginary time nodes
     *
     * @return Transformation matrix
     */
-    nda::matrix_const_view<double> get_cf2it() const { return cf2it; };
+    nda::matrix_const_view<double> get_cf2it() const { return basis->cf2it; };
 
     /**
     * @brief Get LU factors of transformation matrix from DLR imaginary time values to coefficients
     *
     * @return LU factors
     */
-    nda::matrix_const_view<double> get_it2cf_lu() const { return it2cf.lu; };
+    nda::matrix_const_view<double> get_it2cf_lu() const { return basis->it2cf.lu; };
 
     /**
     * @brief Get LU factors of transformation matrix from DLR imaginary time
     * values to coefficients, cast to complex
     *
     * @return LU factors
+    *
+    * \note The complex copy is no longer stored, since complex right hand
+    * sides are solved using the real LU factors; it is built on each call.
     */
-    nda::matrix_const_view<dcomplex> get_it2cf_zlu() const { return it2cf.zlu; };
+    nda::matrix<dcomplex> get_it2cf_zlu() const { return basis->it2cf.lu; };
 
     /**
     * @brief Get LU pivots of transformation matrix from DLR imaginary time values to coefficients
     *
     * @return LU pivots
     */
-    nda::vector_const_view<int> get_it2cf_piv() const { return it2cf.piv; };
+    nda::vector_const_view<int> get_it2cf_piv() const { return basis->it2cf.piv; };
+
+    /**
+    * @brief Get "discrete Hilbert transform" matrix and matrix of diagonal
+    * contribution used by the convolution methods, initializing them if
+    * necessary
+    *
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return Pair of views of the Hilbert transform matrix and the diagonal
+    * contribution matrix
+    */
+    std::pair<nda::matrix_const_view<double>, nda::matrix_const_view<double>> get_convolve_mats(statistic_t statistic,
+                                                                                                 bool time_order = false) const {
+      return convolve_mats(statistic, time_order);
+    }
 
     /** 
     * @brief Get DLR rank
@@ -664,8 +1350,33 @@ namespace cppdlr {
     * @return Inner product matrix
     */
     nda::matrix_const_view<double> get_ipmat() const {
-      if (ipmat.empty()) { innerprod_init(); }
-      return ipmat;
+      innerprod_init();
+      return basis->ipmat;
+    }
+
+    /**
+    * Options for imtime_ops::precompute, which may be combined with bitwise or
+    */
+    static constexpr int CONVOLVE = 1, TCONVOLVE = 2, INNERPROD = 4, REFLECT = 8, BCONVOLVE = 16, ALL = 31;
+
+    /**
+    * @brief Eagerly initialize matrices used by convolution, inner product and
+    * reflection methods
+    *
+    * After this call, the selected methods perform no further initialization,
+    * so that a single const imtime_ops object can be shared by many threads
+    * without any first-call overhead. Lazy initialization is in any case
+    * thread-safe.
+    *
+    * @param[in] flags Combination of CONVOLVE, BCONVOLVE (bosonic
+    * convolution), TCONVOLVE, INNERPROD and REFLECT, or ALL (default)
+    */
+    void precompute(int flags = ALL) const {
+      if (flags & CONVOLVE) { convolve_init(); }
+      if (flags & BCONVOLVE) { bconvolve_init(); }
+      if (flags & TCONVOLVE) { tconvolve_init(); }
+      if (flags & INNERPROD) { innerprod_init(); }
+      if (flags & REFLECT) { reflect_init(); }
     }
 
     /**
@@ -674,37 +1385,103 @@ namespace cppdlr {
     * Initialize matrices required for the convolution methods. This method is
     * called automatically the first time one of the relevant convolution
     * methods is called, but it may also be called manually to avoid the
-    * additional overhead in the first convolution call.
+    * additional overhead in the first convolution call. It is thread-safe, and
+    * does nothing if the initialization has already been done.
     */
     void convolve_init() const {
 
-      hilb   = nda::matrix<double>(r, r);
-      tcf2it = nda::matrix<double>(r, r);
+      basis->hilb_once.call_once([this] {
+        CPPDLR_PROBE("imtime_ops::convolve_init", 2 * r * r * sizeof(double), 10.0 * r * r);
+
+        basis->hilb   = nda::matrix<double>(r, r);
+        basis->tcf2it = nda::matrix<double>(r, r);
+
+        // "Discrete Hilbert transform" matrix -(1-delta_jk)/(dlr_rf(j) -
+        // dlr_rf(k)), scaled by beta
+        for (int j = 0; j < r; ++j) {
+          for (int k = 0; k < r; ++k) {
+            if (j == k) {
+              basis->hilb(j, k) = 0;
+            } else {
+              basis->hilb(j, k) = 1.0 / (basis->dlr_rf(j) - basis->dlr_rf(k));
+            }
+          }
+        }
 
-      // "Discrete Hilbert transform" matrix -(1-delta_jk)/(dlr_rf(j) -
-      // dlr_rf(k)), scaled by beta
-      for (int j = 0; j < r; ++j) {
-        for (int k = 0; k < r; ++k) {
-          if (j == k) {
-            hilb(j, k) = 0;
-          } else {
-            hilb(j, k) = 1.0 / (dlr_rf(j) - dlr_rf(k));
+        // Matrix which applies DLR coefficients to imaginary time grid values
+        // transformation matrix, and then multiplies the result by tau, the
+        // imaginary time variable
+        auto k0 = build_k_it(0.0, basis->dlr_rf);
+        auto k1 = build_k_it(1.0, basis->dlr_rf);
+        for (int j = 0; j < r; ++j) {
+          for (int k = 0; k < r; ++k) {
+            if (basis->dlr_it(j) > 0) {
+              basis->tcf2it(j, k) = -(basis->dlr_it(j) + k1(k)) * basis->cf2it(j, k);
+            } else {
+              basis->tcf2it(j, k) = -(basis->dlr_it(j) - k0(k)) * basis->cf2it(j, k);
+            }
           }
         }
-      }
+      });
+    }
 
-      // Matrix which applies DLR coefficients to imaginary time grid values
-      // transformation matrix, and then multiplies the result by tau, the
-      // imaginary time variable
-      for (int j = 0; j < r; ++j) {
-        for (int k = 0; k < r; ++k) {
-          if (dlr_it(j) > 0) {
-            tcf2it(j, k) = -(dlr_it(j) + k_it(1.0, dlr_rf(k))) * cf2it(j, k);
-          } else {
-            tcf2it(j, k) = -(dlr_it(j) - k_it(0.0, dlr_rf(k))) * cf2it(j, k);
+    /**
+    * @brief Initialization for bosonic convolution methods
+    *
+    * Initialize matrices required for the convolution methods in the bosonic
+    * case. This method is called automatically the first time one of the
+    * relevant convolution methods is called with a bosonic statistic, but it
+    * may also be called manually to avoid the additional overhead in the first
+    * convolution call. It is thread-safe, and does nothing if the
+    * initialization has already been done.
+    *
+    * \note The bosonic convolution has the same structure as the fermionic
+    * one, with K(t,om) extended periodically rather than antiperiodically to t
+    * < 0. The "discrete Hilbert transform" matrix acquires a factor
+    * tanh(dlr_rf(k)/2) on its columns, and the diagonal contribution becomes
+    * -(t tanh(om/2) - K(1,om)) K(t,om) for t > 0 (relative format), and -(t
+    * tanh(om/2) - K(0,om)) K(t,om) for t < 0. These are regular at om = 0, so
+    * no special treatment of a zero frequency is required.
+    */
+    void bconvolve_init() const {
+
+      basis->bhilb_once.call_once([this] {
+        CPPDLR_PROBE("imtime_ops::bconvolve_init", 2 * r * r * sizeof(double), 10.0 * r * r);
+
+        basis->bhilb   = nda::matrix<double>(r, r);
+        basis->btcf2it = nda::matrix<double>(r, r);
+
+        auto tau = nda::vector<double>(r); // tanh(dlr_rf(k)/2)
+        for (int k = 0; k < r; ++k) { tau(k) = std::tanh(basis->dlr_rf(k) / 2); }
+
+        // "Discrete Hilbert transform" matrix
+        // -(1-delta_jk)*tanh(dlr_rf(k)/2)/(dlr_rf(j) - dlr_rf(k)) for bosonic
+        // convolution, scaled by beta
+        for (int j = 0; j < r; ++j) {
+          for (int k = 0; k < r; ++k) {
+            if (j == k) {
+              basis->bhilb(j, k) = 0;
+            } else {
+              basis->bhilb(j, k) = tau(k) / (basis->dlr_rf(j) - basis->dlr_rf(k));
+            }
           }
         }
-      }
+
+        // Matrix which applies DLR coefficients to imaginary time grid values
+        // transformation matrix, and then multiplies the result by the
+        // diagonal factor of the bosonic convolution
+        auto k0 = build_k_it(0.0, basis->dlr_rf);
+        auto k1 = build_k_it(1.0, basis->dlr_rf);
+        for (int j = 0; j < r; ++j) {
+          for (int k = 0; k < r; ++k) {
+            if (basis->dlr_it(j) > 0) {
+              basis->btcf2it(j, k) = -(basis->dlr_it(j) * tau(k) - k1(k)) * basis->cf2it(j, k);
+            } else {
+              basis->btcf2it(j, k) = -(basis->dlr_it(j) * tau(k) - k0(k)) * basis->cf2it(j, k);
+            }
+          }
+        }
+      });
     }
 
     /**
@@ -714,38 +1491,45 @@ namespace cppdlr {
     * This method is called automatically the first time one of the relevant
     * time-ordered convolution methods is called, but it may also be called
     * manually to avoid the additional overhead in the first time-ordered
-    * convolution call. 
+    * convolution call. It is thread-safe, and does nothing if the
+    * initialization has already been done.
     */
     void tconvolve_init() const {
 
-      thilb   = nda::matrix<double>(r, r);
-      ttcf2it = nda::matrix<double>(r, r);
+      basis->thilb_once.call_once([this] {
+        CPPDLR_PROBE("imtime_ops::tconvolve_init", 2 * r * r * sizeof(double), 10.0 * r * r);
 
-      // "Discrete Hilbert transform" matrix
-      // -(1-delta_jk)*K(0,dlr_rf(k))/(dlr_rf(j) - dlr_rf(k)) for time-ordered
-      // convolution, scaled by beta
-      for (int j = 0; j < r; ++j) {
-        for (int k = 0; k < r; ++k) {
-          if (j == k) {
-            thilb(j, k) = 0;
-          } else {
-            thilb(j, k) = k_it(0.0, dlr_rf(k)) / (dlr_rf(k) - dlr_rf(j));
+        basis->thilb   = nda::matrix<double>(r, r);
+        basis->ttcf2it = nda::matrix<double>(r, r);
+
+        auto k0 = build_k_it(0.0, basis->dlr_rf);
+
+        // "Discrete Hilbert transform" matrix
+        // -(1-delta_jk)*K(0,dlr_rf(k))/(dlr_rf(j) - dlr_rf(k)) for time-ordered
+        // convolution, scaled by beta
+        for (int j = 0; j < r; ++j) {
+          for (int k = 0; k < r; ++k) {
+            if (j == k) {
+              basis->thilb(j, k) = 0;
+            } else {
+              basis->thilb(j, k) = k0(k) / (basis->dlr_rf(k) - basis->dlr_rf(j));
+            }
           }
         }
-      }
 
-      // Matrix which applies K(0,dlr_rf(j)) multiplication, then DLR
-      // coefficients to imaginary time grid values transformation matrix, and
-      // then multiplies the result by tau, the imaginary time variable
-      for (int j = 0; j < r; ++j) {
-        for (int k = 0; k < r; ++k) {
-          if (dlr_it(j) > 0) {
-            ttcf2it(j, k) = dlr_it(j) * cf2it(j, k) * k_it(0.0, dlr_rf(k));
-          } else {
-            ttcf2it(j, k) = (1 + dlr_it(j)) * cf2it(j, k) * k_it(0.0, dlr_rf(k));
+        // Matrix which applies K(0,dlr_rf(j)) multiplication, then DLR
+        // coefficients to imaginary time grid values transformation matrix, and
+        // then multiplies the result by tau, the imaginary time variable
+        for (int j = 0; j < r; ++j) {
+          for (int k = 0; k < r; ++k) {
+            if (basis->dlr_it(j) > 0) {
+              basis->ttcf2it(j, k) = basis->dlr_it(j) * basis->cf2it(j, k) * k0(k);
+            } else {
+              basis->ttcf2it(j, k) = (1 + basis->dlr_it(j)) * basis->cf2it(j, k) * k0(k);
+            }
           }
         }
-      }
+      });
     }
 
     /**
@@ -753,26 +1537,33 @@ namespace cppdlr {
     *
     * This method is called automatically the first time the innerprod method is
     * called, but it may also be called manually to avoid the additional
-    * overhead in the first inner product call.
+    * overhead in the first inner product call. It is thread-safe, and does
+    * nothing if the initialization has already been done.
     */
     void innerprod_init() const {
 
-      ipmat = nda::matrix<double>(r, r);
-
-      // Matrix of inner product of two DLR expansions
-      double ssum = 0;
-      for (int k = 0; k < r; ++k) {
-        for (int l = 0; l < r; ++l) {
-          ssum = dlr_rf(k) + dlr_rf(l);
-          if (ssum == 0) {
-            ipmat(k, l) = k_it(0.0, dlr_rf(k)) * k_it(0.0, dlr_rf(l));
-          } else if (std::abs(ssum) < 1) {
-            ipmat(k, l) = -k_it(0.0, dlr_rf(k)) * k_it(0.0, dlr_rf(l)) * std::expm1(-ssum) / ssum;
-          } else {
-            ipmat(k, l) = (k_it(0.0, dlr_rf(k)) * k_it(0.0, dlr_rf(l)) - k_it(1.0, dlr_rf(k)) * k_it(1.0, dlr_rf(l))) / ssum;
+      basis->ipmat_once.call_once([this] {
+        CPPDLR_PROBE("imtime_ops::innerprod_init", 1 * r * r * sizeof(double), 10.0 * r * r);
+
+        basis->ipmat = nda::matrix<double>(r, r);
+
+        // Matrix of inner product of two DLR expansions
+        auto k0     = build_k_it(0.0, basis->dlr_rf);
+        auto k1     = build_k_it(1.0, basis->dlr_rf);
+        double ssum = 0;
+        for (int k = 0; k < r; ++k) {
+          for (int l = 0; l < r; ++l) {
+            ssum = basis->dlr_rf(k) + basis->dlr_rf(l);
+            if (ssum == 0) {
+              basis->ipmat(k, l) = k0(k) * k0(l);
+            } else if (std::abs(ssum) < 1) {
+              basis->ipmat(k, l) = -k0(k) * k0(l) * std::expm1(-ssum) / ssum;
+            } else {
+              basis->ipmat(k, l) = (k0(k) * k0(l) - k1(k) * k1(l)) / ssum;
+            }
           }
         }
-      }
+      });
     }
 
     /**
@@ -783,50 +1574,210 @@ namespace cppdlr {
     * matrix is required for the reflect method. It is called automatically the
     * first time the reflect method is called, but it may also be called
     * manually to avoid the additional overhead of the first call to reflect.
+    * It is thread-safe, and does nothing if the initialization has already been
+    * done.
     */
     void reflect_init() const {
 
-      refl = nda::matrix<double>(r, r);
+      basis->refl_once.call_once([this] {
+        CPPDLR_PROBE("imtime_ops::reflect_init", 1 * r * r * sizeof(double), 10.0 * r * r);
 
-      // Matrix of reflection acting on DLR coefficients and returning values at
-      // DLR nodes
-      for (int i = 0; i < r; ++i) {
-        for (int j = 0; j < r; ++j) { refl(i, j) = k_it(-dlr_it(i), dlr_rf(j)); }
-      }
+        // Matrix of reflection acting on DLR coefficients and returning values at
+        // DLR nodes
+        basis->refl = build_k_it(nda::vector<double>(-basis->dlr_it), basis->dlr_rf);
 
-      // Precompose with DLR values to coefficients matrix
-      nda::lapack::getrs(transpose(it2cf.lu), refl, it2cf.piv); // Lapack effectively transposes refl by fortran reordering here
+        // Precompose with DLR values to coefficients matrix
+        // Lapack effectively transposes refl by fortran reordering here
+        nda::lapack::getrs(transpose(basis->it2cf.lu), basis->refl, basis->it2cf.piv);
+      });
     }
 
     private:
-    double lambda_;
-    int r;                      ///< DLR rank
-    nda::vector<double> dlr_rf; ///< DLR frequencies
-    nda::vector<double> dlr_it; ///< DLR imaginary time nodes
-    nda::matrix<double> cf2it;  ///< Transformation matrix from DLR coefficients to values at DLR imaginary time nodes
+    static constexpr int evalblk = 1024; ///< Block size (# evaluation points) used by coefs2eval on a grid
 
     /**
-    * @brief Struct for transformation from DLR imaginary time values to coefficients
+    * @brief Solve linear system with matrix cf2it, or its transpose, in place
+    * for multiple right hand sides, using the real LU factors of cf2it
+    *
+    * @param[in,out] b Right hand sides, as r x m matrix in Fortran layout;
+    * overwritten by solutions
+    * @param[in] transpose Solve with transpose of cf2it
+    * @param[in] ws Workspace, used only if @p b is complex
+    *
+    * \note For complex @p b, the real and imaginary parts are solved together
+    * as a real r x 2m right hand side, which avoids storing a complex copy of
+    * the LU factors and is cheaper than a complex solve.
     */
-    struct {
-      nda::matrix<double> lu;    ///< LU factors (LAPACK format) of imaginary time vals -> coefs matrix
-      nda::matrix<dcomplex> zlu; ///< Same as lu, cast to complex (for use with lapack::getrs w/ cmplx input)
-      nda::vector<int> piv;      ///< LU pivots (LAPACK format) of imaginary time vals -> coefs matrix
-    } it2cf;
+    template <nda::MemoryMatrix M> void it2cf_solve(M &&b, bool transpose, imtime_workspace &ws) const {
+
+      auto const &lu  = basis->it2cf.lu;
+      auto const &piv = basis->it2cf.piv;
+
+      if constexpr (nda::is_complex_v<nda::get_value_t<M>>) {
+        long m                       = b.extent(1);
+        auto bri                     = ws.matrix<double, F_layout>(0, r, 2 * m);
+        bri(_, nda::range(m))        = nda::real(b);
+        bri(_, nda::range(m, 2 * m)) = nda::imag(b);
+        transpose ? nda::lapack::getrs(nda::transpose(lu), bri, piv) : nda::lapack::getrs(lu, bri, piv);
+        b = bri(_, nda::range(m)) + 1i * bri(_, nda::range(m, 2 * m));
+      } else {
+        transpose ? nda::lapack::getrs(nda::transpose(lu), b, piv) : nda::lapack::getrs(lu, b, piv);
+      }
+    }
 
-    // Arrays used for dlr_imtime::convolve
-    mutable nda::matrix<double> hilb;   ///< "Discrete Hilbert transform" matrix
-    mutable nda::matrix<double> tcf2it; ///< A matrix required for convolution
+    /**
+    * @brief Get views of "discrete Hilbert transform" matrix and matrix of
+    * diagonal contribution for convolution with given statistic and
+    * time-ordering, initializing them if necessary
+    */
+    std::pair<nda::matrix_const_view<double>, nda::matrix_const_view<double>> convolve_mats(statistic_t statistic, bool time_order) const {
+
+      if (time_order) { // Time-ordered convolution does not involve values at t < 0, so is independent of statistic
+        tconvolve_init();
+        return {basis->thilb, basis->ttcf2it};
+      } else if (statistic == Fermion) {
+        convolve_init();
+        return {basis->hilb, basis->tcf2it};
+      } else {
+        bconvolve_init();
+        return {basis->bhilb, basis->btcf2it};
+      }
+    }
 
-    // Arrays used for dlr_imtime::tconvolve
-    mutable nda::matrix<double> thilb;   ///< "Discrete Hilbert transform" matrix, modified for time-ordered convolution
-    mutable nda::matrix<double> ttcf2it; ///< A matrix required for time-ordered convolution
+    /**
+    * @brief Get views of "discrete Hilbert transform" matrix, matrix of
+    * diagonal contribution for convolution and cf2it, in the precision of
+    * Green's functions with scalar type S, initializing them if necessary
+    */
+    template <nda::Scalar S> auto convolve_mats_prec(statistic_t statistic, bool time_order) const {
+
+      auto mats = convolve_mats(statistic, time_order);
+
+      if constexpr (is_single_v<S>) {
+        int i = (time_order ? 2 : (statistic == Fermion ? 0 : 1));
+        basis->conv_single_once[i].call_once([&] {
+          basis->hilb_s[i]   = to_single(mats.first);
+          basis->tcf2it_s[i] = to_single(mats.second);
+        });
+        using V = nda::matrix_const_view<float>;
+        return std::tuple<V, V, V>{basis->hilb_s[i], basis->tcf2it_s[i], single_mats().first};
+      } else {
+        using V = nda::matrix_const_view<double>;
+        return std::tuple<V, V, V>{mats.first, mats.second, basis->cf2it};
+      }
+    }
 
-    // Array used for dlr_imtime::innerprod
-    mutable nda::matrix<double> ipmat; ///< Inner product matrix
+    /**
+    * @brief Get single precision copies of cf2it and of the explicit values ->
+    * coefficients matrix, initializing them if necessary
+    *
+    * \note The values -> coefficients matrix is obtained once in double
+    * precision from the LU factors of cf2it, and then rounded, so that single
+    * precision transformations are products with r x r matrices.
+    */
+    std::pair<nda::matrix<float> const &, nda::matrix<float> const &> single_mats() const {
+
+      basis->single_once.call_once([this] {
+        auto it2cf = nda::matrix<double, F_layout>(nda::eye<double>(r));
+        auto ws    = imtime_workspace();
+        it2cf_solve(it2cf, false, ws);
+        basis->cf2it_s = to_single(basis->cf2it);
+        basis->it2cf_s = to_single(it2cf);
+      });
+
+      return {basis->cf2it_s, basis->it2cf_s};
+    }
+
+    /**
+    * @brief Gather array with leading batch dimension and second dimension r
+    * into r x (# batch * # remaining entries) matrix
+    */
+    template <typename Layout, nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> nda::matrix<S, Layout> batch_gather(T const &g) const {
+
+      long nb  = g.shape(0);
+      long m   = (nb == 0 ? 0 : g.size() / (nb * r));
+      auto buf = nda::matrix<S, Layout>(r, nb * m);
+      for (long b = 0; b < nb; ++b) { buf(_, nda::range(b * m, (b + 1) * m)) = nda::reshape(g(b, nda::ellipsis{}), r, m); }
+
+      return buf;
+    }
+
+    /**
+    * @brief Scatter r x (# batch * # remaining entries) matrix into array with
+    * leading batch dimension and second dimension r (inverse of batch_gather)
+    */
+    template <nda::MemoryMatrix M, nda::MemoryArray T> void batch_scatter(M const &buf, T &g) const {
+
+      long nb = g.shape(0);
+      long m  = (nb == 0 ? 0 : g.size() / (nb * r));
+      for (long b = 0; b < nb; ++b) { nda::reshape(g(b, nda::ellipsis{}), r, m) = buf(_, nda::range(b * m, (b + 1) * m)); }
+    }
+
+    /**
+    * @brief Build rows i0, ..., i1-1 of evaluation matrix on equispaced grid
+    * eqptsrel(n) by exponential recurrence
+    */
+    nda::matrix<double> build_evalmat_eqpts(int n, int i0, int i1) const;
+
+    /**
+    * @brief DLR imaginary time basis data, shared between copies of an
+    * imtime_ops object
+    *
+    * The DLR nodes and transformation matrices are set at construction and
+    * never modified afterwards. The matrices required only by particular
+    * operations are built lazily, and thread-safely, on first use by any copy.
+    */
+    struct basis_data {
+      nda::vector<double> dlr_rf; ///< DLR frequencies
+      nda::vector<double> dlr_it; ///< DLR imaginary time nodes
+      nda::matrix<double> cf2it;  ///< Transformation matrix from DLR coefficients to values at DLR imaginary time nodes
+
+      /**
+      * @brief Struct for transformation from DLR imaginary time values to coefficients
+      */
+      struct {
+        nda::matrix<double> lu; ///< LU factors (LAPACK format) of imaginary time vals -> coefs matrix
+        nda::vector<int> piv;   ///< LU pivots (LAPACK format) of imaginary time vals -> coefs matrix
+      } it2cf;
+
+      // Arrays used for dlr_imtime::convolve
+      mutable nda::matrix<double> hilb;   ///< "Discrete Hilbert transform" matrix
+      mutable nda::matrix<double> tcf2it; ///< A matrix required for convolution
+
+      // Arrays used for dlr_imtime::convolve in bosonic case
+      mutable nda::matrix<double> bhilb;   ///< "Discrete Hilbert transform" matrix, modified for bosonic convolution
+      mutable nda::matrix<double> btcf2it; ///< A matrix required for bosonic convolution
+
+      // Arrays used for dlr_imtime::tconvolve
+      mutable nda::matrix<double> thilb;   ///< "Discrete Hilbert transform" matrix, modified for time-ordered convolution
+      mutable nda::matrix<double> ttcf2it; ///< A matrix required for time-ordered convolution
+
+      // Array used for dlr_imtime::innerprod
+      mutable nda::matrix<double> ipmat; ///< Inner product matrix
+
+      // Array used for dlr_imtime::reflect
+      mutable nda::matrix<double> refl; ///< Matrix of reflection
+
+      // Single precision copies used for float and complex<float> Green's
+      // functions
+      mutable nda::matrix<float> cf2it_s;                 ///< cf2it
+      mutable nda::matrix<float> it2cf_s;                 ///< Explicit values -> coefficients matrix
+      mutable std::array<nda::matrix<float>, 3> hilb_s;   ///< hilb, bhilb, thilb
+      mutable std::array<nda::matrix<float>, 3> tcf2it_s; ///< tcf2it, btcf2it, ttcf2it
+
+      // Flags for thread-safe lazy initialization of the arrays above
+      mutable init_flag hilb_once;                       ///< Initialization of hilb, tcf2it
+      mutable init_flag bhilb_once;                      ///< Initialization of bhilb, btcf2it
+      mutable init_flag thilb_once;                      ///< Initialization of thilb, ttcf2it
+      mutable init_flag ipmat_once;                      ///< Initialization of ipmat
+      mutable init_flag refl_once;                       ///< Initialization of refl
+      mutable init_flag single_once;                     ///< Initialization of cf2it_s, it2cf_s
+      mutable std::array<init_flag, 3> conv_single_once; ///< Initialization of hilb_s, tcf2it_s
+    };
 
-    // Array used for dlr_imtime::reflect
-    mutable nda::matrix<double> refl; ///< Matrix of reflection
+    double lambda_;
+    int r;                                                                    ///< DLR rank
+    std::shared_ptr<basis_data const> basis = std::make_shared<basis_data>(); ///< DLR basis data, shared between copies
 
     // -------------------- hdf5 -------------------
 
@@ -843,7 +1794,6 @@ namespace cppdlr {
       h5::write(gr, "it", m.get_itnodes());
       h5::write(gr, "cf2it", m.get_cf2it());
       h5::write(gr, "it2cf_lu", m.get_it2cf_lu());
-      h5::write(gr, "it2cf_zlu", m.get_it2cf_zlu());
       h5::write(gr, "it2cf_piv", m.get_it2cf_piv());
     }
 
@@ -852,15 +1802,16 @@ namespace cppdlr {
       h5::group gr = fg.open_group(subgroup_name);
       assert_hdf5_format(gr, m);
 
+      // Files written by earlier versions also contain a complex copy
+      // "it2cf_zlu" of the LU factors, which is not needed
       auto lambda    = h5::read<double>(gr, "lambda");
       auto rf        = h5::read<nda::vector<double>>(gr, "rf");
       auto it        = h5::read<nda::vector<double>>(gr, "it");
       auto cf2it_    = h5::read<nda::matrix<double>>(gr, "cf2it");
       auto it2cf_lu  = h5::read<nda::matrix<double>>(gr, "it2cf_lu");
-      auto it2cf_zlu = h5::read<nda::matrix<dcomplex>>(gr, "it2cf_zlu");
       auto it2cf_piv = h5::read<nda::vector<int>>(gr, "it2cf_piv");
 
-      m = imtime_ops(lambda, rf, it, cf2it_, it2cf_lu, it2cf_zlu, it2cf_piv);
+      m = imtime_ops(lambda, rf, it, cf2it_, it2cf_lu, it2cf_piv);
     }
   };
 
@@ -16,6 +16,9 @@
 
 #include "dlr_kernels.hpp"
 #include <numbers>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 using namespace std;
 using namespace std::numbers;
@@ -61,4 +64,55 @@ namespace cppdlr {
 
   std::complex<double> k_if(int n, double om, statistic_t statistic, double beta) { return beta * k_if(n, beta * om, statistic); }
 
+  void k_it(std::span<const double> t, std::span<const double> om, std::span<double> out) {
+
+    std::size_t nt = t.size(), nom = om.size();
+    if (out.size() < nt * nom) { throw std::runtime_error("Output buffer too small."); }
+
+    // Frequency-dependent factors: -1/(1+exp(-|om|)), and min(om,0) and
+    // min(-om,0) for positive and negative times, respectively
+    auto d    = std::vector<double>(nom);
+    auto mpos = std::vector<double>(nom);
+    auto mneg = std::vector<double>(nom);
+    for (std::size_t j = 0; j < nom; ++j) {
+      d[j]    = -1.0 / (1.0 + exp(-abs(om[j])));
+      mpos[j] = std::min(om[j], 0.0);
+      mneg[j] = std::min(-om[j], 0.0);
+    }
+
+    for (std::size_t i = 0; i < nt; ++i) {
+      double ti         = t[i];
+      double const *m   = (ti >= 0 ? mpos.data() : mneg.data());
+      double const *omp = om.data();
+      double const *dp  = d.data();
+      double *o         = out.data() + i * nom;
+      for (std::size_t j = 0; j < nom; ++j) { o[j] = dp[j] * exp(m[j] - ti * omp[j]); }
+    }
+  }
+
+  void k_if(std::span<const int> n, std::span<const double> om, statistic_t statistic, std::span<std::complex<double>> out) {
+
+    std::size_t nn = n.size(), nom = om.size();
+    if (out.size() < nn * nom) { throw std::runtime_error("Output buffer too small."); }
+
+    // Numerator factor: 1 (fermionic) or tanh(om/2) (bosonic)
+    auto tau = std::vector<double>(nom, 1.0);
+    if (statistic == Boson) {
+      for (std::size_t j = 0; j < nom; ++j) { tau[j] = std::tanh(0.5 * om[j]); }
+    }
+
+    // K(i nu, om) = tau / (i nu - om) = -tau * (om + i nu) / (om^2 + nu^2);
+    // complex output is accessed as interleaved real and imaginary parts
+    for (std::size_t i = 0; i < nn; ++i) {
+      double nu = (statistic == Fermion ? 2 * n[i] + 1 : 2 * n[i]) * pi;
+      auto *o   = reinterpret_cast<double *>(out.data() + i * nom);
+      for (std::size_t j = 0; j < nom; ++j) {
+        double den   = om[j] * om[j] + nu * nu;
+        double c     = (den > 0 ? -tau[j] / den : 0.0);
+        o[2 * j]     = (den > 0 ? c * om[j] : -0.5); // Bosonic kernel at n = 0, om = 0 is -1/2
+        o[2 * j + 1] = c * nu;
+      }
+    }
+  }
+
 } // namespace cppdlr
@@ -16,6 +16,7 @@
 
 #pragma once
 #include <complex>
+#include <span>
 
 namespace cppdlr {
 
@@ -129,4 +130,37 @@ namespace cppdlr {
   */
   std::complex<double> k_if(int n, double om, statistic_t statistic, double beta);
 
+  /**
+  * @brief Evaluate analytic continuation kernel in imaginary time (relative
+  * time format) on a tensor product grid, using dimensionless variables (beta
+  * = 1)
+  *
+  * @param[in] t Imaginary time values (relative format)
+  * @param[in] om Real frequency values
+  * @param[out] out Kernel values K(t_i, om_j), in row-major order:
+  * out[i * om.size() + j] = K(t_i, om_j)
+  *
+  * \note This is the batched version of k_it(double, double). The kernel is
+  * written as K(t,om) = -exp(-t * om + min(s * om, 0)) / (1 + exp(-|om|)),
+  * with s the sign of t, so that the inner loop over frequencies contains no
+  * branches and a single call to exp, and can be vectorized by the compiler.
+  */
+  void k_it(std::span<const double> t, std::span<const double> om, std::span<double> out);
+
+  /**
+  * @brief Evaluate analytic continuation kernel in imaginary frequency on a
+  * tensor product grid, using dimensionless variables (beta = 1)
+  *
+  * @param[in] n Imaginary frequency indices
+  * @param[in] om Real frequency values
+  * @param[in] statistic Particle Statistic: Boson or Fermion
+  * @param[out] out Kernel values K(i nu_n, om_j), in row-major order:
+  * out[i * om.size() + j] = K(i nu_{n_i}, om_j)
+  *
+  * \note This is the batched version of k_if(int, double, statistic_t). It is
+  * evaluated using real arithmetic, and in the bosonic case tanh(om/2) is
+  * computed once per frequency.
+  */
+  void k_if(std::span<const int> n, std::span<const double> om, statistic_t statistic, std::span<std::complex<double>> out);
+
 } // namespace cppdlr
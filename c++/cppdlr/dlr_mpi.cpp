@@ -0,0 +1,166 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#include "dlr_mpi.hpp"
+
+#ifdef CPPDLR_USE_MPI
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+using nda::dcomplex;
+
+// BLACS and ScaLAPACK routines. Character arguments of Fortran routines are
+// followed by their hidden string lengths.
+extern "C" {
+int Csys2blacs_handle(MPI_Comm comm);
+void Cfree_blacs_system_handle(int handle);
+void Cblacs_gridinit(int *ctxt, char *order, int nprow, int npcol);
+void Cblacs_gridinfo(int ctxt, int *nprow, int *npcol, int *myrow, int *mycol);
+void Cblacs_gridexit(int ctxt);
+
+int numroc_(int const *n, int const *nb, int const *iproc, int const *isrcproc, int const *nprocs);
+void descinit_(int *desc, int const *m, int const *n, int const *mb, int const *nb, int const *irsrc, int const *icsrc, int const *ctxt,
+               int const *lld, int *info);
+
+void pdgemm_(char const *transa, char const *transb, int const *m, int const *n, int const *k, double const *alpha, double const *a, int const *ia,
+             int const *ja, int const *desca, double const *b, int const *ib, int const *jb, int const *descb, double const *beta, double *c,
+             int const *ic, int const *jc, int const *descc, std::size_t transa_len, std::size_t transb_len);
+void pzgemm_(char const *transa, char const *transb, int const *m, int const *n, int const *k, dcomplex const *alpha, dcomplex const *a,
+             int const *ia, int const *ja, int const *desca, dcomplex const *b, int const *ib, int const *jb, int const *descb, dcomplex const *beta,
+             dcomplex *c, int const *ic, int const *jc, int const *descc, std::size_t transa_len, std::size_t transb_len);
+
+void pdgesv_(int const *n, int const *nrhs, double *a, int const *ia, int const *ja, int const *desca, int *ipiv, double *b, int const *ib,
+             int const *jb, int const *descb, int *info);
+void pzgesv_(int const *n, int const *nrhs, dcomplex *a, int const *ia, int const *ja, int const *desca, int *ipiv, dcomplex *b, int const *ib,
+             int const *jb, int const *descb, int *info);
+}
+
+namespace cppdlr {
+
+  namespace {
+
+    int const one  = 1; // Index of first row or column of (sub)matrix, in Fortran convention
+    int const zero = 0; // Process row and column holding first block
+
+    // Check that local blocks of a distributed matrix have the expected shape
+    template <typename M> void check_local(blacs_grid const &grid, M const &a, long m, long n) {
+      if (a.extent(0) != grid.local_rows(m) || a.extent(1) != grid.local_cols(n)) {
+        throw std::runtime_error("Local blocks of distributed matrix have wrong dimensions.");
+      }
+    }
+
+    // Distributed product, for either scalar type
+    template <typename S, typename F>
+    void pgemm_impl(F f, blacs_grid const &grid, long m, long n, long k, S alpha, nda::matrix_const_view<S, nda::F_layout> a,
+                    nda::matrix_const_view<S, nda::F_layout> b, S beta, nda::matrix_view<S, nda::F_layout> c) {
+
+      check_local(grid, a, m, k);
+      check_local(grid, b, k, n);
+      check_local(grid, c, m, n);
+
+      auto desca = grid.descriptor(m, k);
+      auto descb = grid.descriptor(k, n);
+      auto descc = grid.descriptor(m, n);
+      int mi     = m, ni = n, ki = k;
+      char trans = 'N';
+      f(&trans, &trans, &mi, &ni, &ki, &alpha, a.data(), &one, &one, desca.data(), b.data(), &one, &one, descb.data(), &beta, c.data(), &one, &one,
+        descc.data(), 1, 1);
+    }
+
+    // Distributed solve, for either scalar type
+    template <typename S, typename F>
+    void pgesv_impl(F f, blacs_grid const &grid, long n, long nrhs, nda::matrix_view<S, nda::F_layout> a, nda::matrix_view<S, nda::F_layout> b) {
+
+      check_local(grid, a, n, n);
+      check_local(grid, b, n, nrhs);
+
+      auto desca = grid.descriptor(n, n);
+      auto descb = grid.descriptor(n, nrhs);
+      auto ipiv  = nda::vector<int>(grid.local_rows(n) + grid.block_size());
+      int ni     = n, nrhsi = nrhs, info = 0;
+      f(&ni, &nrhsi, a.data(), &one, &one, desca.data(), ipiv.data(), b.data(), &one, &one, descb.data(), &info);
+      if (info != 0) throw std::runtime_error("Distributed LU solve failed.");
+    }
+
+  } // namespace
+
+  blacs_grid::blacs_grid(MPI_Comm comm, int nb) : nb(nb) {
+
+    if (nb < 1) throw std::runtime_error("Block size must be positive.");
+
+    // Most nearly square process grid, with nprow <= npcol
+    int size = 0;
+    MPI_Comm_size(comm, &size);
+    nprow = std::max(1, int(std::sqrt(double(size))));
+    while (size % nprow != 0) { --nprow; }
+    npcol = size / nprow;
+
+    hsys         = Csys2blacs_handle(comm);
+    ctxt         = hsys;
+    char order[] = "Row";
+    Cblacs_gridinit(&ctxt, order, nprow, npcol);
+    Cblacs_gridinfo(ctxt, &nprow, &npcol, &myrow, &mycol);
+  }
+
+  blacs_grid::~blacs_grid() {
+    Cblacs_gridexit(ctxt);
+    Cfree_blacs_system_handle(hsys);
+  }
+
+  long blacs_grid::local_rows(long m) const {
+    int mi = m;
+    return numroc_(&mi, &nb, &myrow, &zero, &nprow);
+  }
+
+  long blacs_grid::local_cols(long n) const {
+    int ni = n;
+    return numroc_(&ni, &nb, &mycol, &zero, &npcol);
+  }
+
+  std::array<int, 9> blacs_grid::descriptor(long m, long n) const {
+
+    auto desc = std::array<int, 9>{};
+    int mi = m, ni = n, lld = std::max(1L, local_rows(m)), info = 0;
+    descinit_(desc.data(), &mi, &ni, &nb, &nb, &zero, &zero, &ctxt, &lld, &info);
+    if (info != 0) throw std::runtime_error("Invalid ScaLAPACK array descriptor.");
+
+    return desc;
+  }
+
+  void pgemm(blacs_grid const &grid, long m, long n, long k, double alpha, nda::matrix_const_view<double, nda::F_layout> a,
+             nda::matrix_const_view<double, nda::F_layout> b, double beta, nda::matrix_view<double, nda::F_layout> c) {
+    pgemm_impl<double>(pdgemm_, grid, m, n, k, alpha, a, b, beta, c);
+  }
+
+  void pgemm(blacs_grid const &grid, long m, long n, long k, dcomplex alpha, nda::matrix_const_view<dcomplex, nda::F_layout> a,
+             nda::matrix_const_view<dcomplex, nda::F_layout> b, dcomplex beta, nda::matrix_view<dcomplex, nda::F_layout> c) {
+    pgemm_impl<dcomplex>(pzgemm_, grid, m, n, k, alpha, a, b, beta, c);
+  }
+
+  void pgesv(blacs_grid const &grid, long n, long nrhs, nda::matrix_view<double, nda::F_layout> a, nda::matrix_view<double, nda::F_layout> b) {
+    pgesv_impl<double>(pdgesv_, grid, n, nrhs, a, b);
+  }
+
+  void pgesv(blacs_grid const &grid, long n, long nrhs, nda::matrix_view<dcomplex, nda::F_layout> a, nda::matrix_view<dcomplex, nda::F_layout> b) {
+    pgesv_impl<dcomplex>(pzgesv_, grid, n, nrhs, a, b);
+  }
+
+} // namespace cppdlr
+
+#endif // CPPDLR_USE_MPI
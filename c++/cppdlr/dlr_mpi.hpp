@@ -0,0 +1,143 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+
+// Distributed linear algebra is only available if cppdlr is built with
+// Use_MPI=ON
+#ifdef CPPDLR_USE_MPI
+
+#include <nda/nda.hpp>
+#include <mpi.h>
+
+#include <array>
+
+namespace cppdlr {
+
+  /**
+  * @class blacs_grid
+  * @brief Two-dimensional ScaLAPACK (BLACS) process grid over the ranks of an
+  * MPI communicator, with square blocks of a 2D block-cyclic matrix layout
+  *
+  * The ranks are arranged in a row-major nprow x npcol grid, with nprow <=
+  * npcol as close as possible to sqrt(# ranks). A global m x n matrix is
+  * stored in blocks of size nb x nb, dealt out cyclically over the rows and
+  * columns of the grid starting at process (0, 0). Each rank stores its
+  * local blocks as a local_rows(m) x local_cols(n) matrix in Fortran layout.
+  *
+  * \note A blacs_grid must be created and destroyed collectively by all
+  * ranks of the communicator, and is not copyable.
+  */
+  class blacs_grid {
+
+    public:
+    /**
+    * @brief Constructor for blacs_grid
+    *
+    * @param[in] comm MPI communicator
+    * @param[in] nb   Block size of block-cyclic layout
+    */
+    blacs_grid(MPI_Comm comm, int nb);
+
+    ~blacs_grid();
+
+    blacs_grid(blacs_grid const &)            = delete;
+    blacs_grid &operator=(blacs_grid const &) = delete;
+
+    /**
+    * @brief Get BLACS context
+    */
+    int context() const { return ctxt; }
+
+    /**
+    * @brief Get block size
+    */
+    int block_size() const { return nb; }
+
+    /**
+    * @brief Get number of local rows of a distributed matrix with @p m rows
+    */
+    long local_rows(long m) const;
+
+    /**
+    * @brief Get number of local columns of a distributed matrix with @p n
+    * columns
+    */
+    long local_cols(long n) const;
+
+    /**
+    * @brief Get global index of local row @p i
+    */
+    long global_row(long i) const { return ((i / nb) * nprow + myrow) * nb + i % nb; }
+
+    /**
+    * @brief Get global index of local column @p j
+    */
+    long global_col(long j) const { return ((j / nb) * npcol + mycol) * nb + j % nb; }
+
+    /**
+    * @brief Get ScaLAPACK array descriptor of a distributed m x n matrix
+    */
+    std::array<int, 9> descriptor(long m, long n) const;
+
+    private:
+    int hsys;  ///< BLACS system handle of communicator
+    int ctxt;  ///< BLACS context
+    int nb;    ///< Block size
+    int nprow; ///< Number of process rows
+    int npcol; ///< Number of process columns
+    int myrow; ///< Process row of this rank
+    int mycol; ///< Process column of this rank
+  };
+
+  /**
+  * @brief Distributed matrix-matrix product c = alpha * a * b + beta * c, by
+  * ScaLAPACK p?gemm
+  *
+  * @param[in] grid Process grid
+  * @param[in] m Global number of rows of a and c
+  * @param[in] n Global number of columns of b and c
+  * @param[in] k Global number of columns of a and rows of b
+  * @param[in] alpha Scalar factor of product
+  * @param[in] a Local blocks of a
+  * @param[in] b Local blocks of b
+  * @param[in] beta Scalar factor of output
+  * @param[in,out] c Local blocks of c
+  */
+  void pgemm(blacs_grid const &grid, long m, long n, long k, double alpha, nda::matrix_const_view<double, nda::F_layout> a,
+             nda::matrix_const_view<double, nda::F_layout> b, double beta, nda::matrix_view<double, nda::F_layout> c);
+  void pgemm(blacs_grid const &grid, long m, long n, long k, nda::dcomplex alpha, nda::matrix_const_view<nda::dcomplex, nda::F_layout> a,
+             nda::matrix_const_view<nda::dcomplex, nda::F_layout> b, nda::dcomplex beta, nda::matrix_view<nda::dcomplex, nda::F_layout> c);
+
+  /**
+  * @brief Distributed solve of linear system a x = b by LU factorization with
+  * partial pivoting, by ScaLAPACK p?gesv
+  *
+  * @param[in] grid Process grid
+  * @param[in] n Global dimension of a
+  * @param[in] nrhs Global number of right hand sides
+  * @param[in,out] a Local blocks of n x n matrix a; overwritten by its LU
+  * factors
+  * @param[in,out] b Local blocks of n x nrhs matrix b; overwritten by the
+  * solution
+  */
+  void pgesv(blacs_grid const &grid, long n, long nrhs, nda::matrix_view<double, nda::F_layout> a, nda::matrix_view<double, nda::F_layout> b);
+  void pgesv(blacs_grid const &grid, long n, long nrhs, nda::matrix_view<nda::dcomplex, nda::F_layout> a,
+             nda::matrix_view<nda::dcomplex, nda::F_layout> b);
+
+} // namespace cppdlr
+
+#endif // CPPDLR_USE_MPI
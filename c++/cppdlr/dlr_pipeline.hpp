@@ -0,0 +1,285 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "dlr_imtime.hpp"
+#include "utils.hpp"
+
+#include <vector>
+
+namespace cppdlr {
+
+  /**
+  * @class imtime_pipeline
+  * @brief Chain of linear imaginary time DLR operations, fused into a single
+  * matrix
+  *
+  * A pipeline records a sequence of operations of imtime_ops which are linear
+  * in the Green's function they act on: vals2coefs, coefs2vals, reflect,
+  * convolution with a fixed scalar-valued function f, and inner product with a
+  * fixed scalar-valued function f. Recording an operation does no work; on the
+  * first application, the whole chain is folded into a single fused matrix,
+  * which is cached in the pipeline, so that every application is a single
+  * matrix product, with no intermediate temporaries or redundant changes of
+  * representation. A vals2coefs immediately followed by a coefs2vals, or
+  * vice versa, is removed when it is recorded.
+  *
+  * The pipeline keeps track of the representation (values on the DLR
+  * imaginary time grid, or DLR coefficients) of the Green's function at each
+  * stage, and an operation applied to the wrong representation throws.
+  *
+  * Example: for G given by its values g on the DLR grid, the values of the
+  * reflection of f * G on the DLR grid are given by
+  *
+  * auto p = imtime_pipeline<>(itops);
+  * p.convolve(beta, Fermion, fc).reflect();
+  * auto h = p(g);
+  *
+  * \note Operations act on the first (DLR) index only, so a pipeline may be
+  * applied to matrix-valued Green's functions, acting on each orbital
+  * component separately. Recording an operation after the first application
+  * discards the fused matrix; this must not be done while the pipeline is
+  * being applied by another thread.
+  *
+  * @tparam S Scalar type of the fused matrix (double or dcomplex); must be
+  * dcomplex if a complex function f is used in convolve or innerprod
+  */
+  template <nda::Scalar S = double> class imtime_pipeline {
+
+    public:
+    /**
+    * Representation of the Green's function at a stage of the pipeline
+    */
+    enum rep_t {
+      VALS,  ///< Values on the DLR imaginary time grid
+      COEFS, ///< DLR coefficients
+      IP     ///< Inner product (pipeline is terminated)
+    };
+
+    /**
+    * @brief Constructor for imtime_pipeline
+    *
+    * @param[in] itops DLR imaginary time object
+    * @param[in] input Representation of the input of the pipeline: VALS
+    * (default) or COEFS
+    */
+    imtime_pipeline(imtime_ops const &itops, rep_t input = VALS) : itops_(itops), input_(input), output_(input) {
+      if (input == IP) throw std::runtime_error("Pipeline input must be VALS or COEFS.");
+    }
+
+    /**
+    * @brief Append transformation from values on the DLR imaginary time grid to
+    * DLR coefficients (imtime_ops::vals2coefs)
+    */
+    imtime_pipeline &vals2coefs() {
+      expect(VALS);
+      if (!steps.empty() && steps.back().kind == C2V) {
+        pop(COEFS);
+      } else {
+        push({V2C, {}}, COEFS);
+      }
+      return *this;
+    }
+
+    /**
+    * @brief Append transformation from DLR coefficients to values on the DLR
+    * imaginary time grid (imtime_ops::coefs2vals)
+    */
+    imtime_pipeline &coefs2vals() {
+      expect(COEFS);
+      if (!steps.empty() && steps.back().kind == V2C) {
+        pop(VALS);
+      } else {
+        push({C2V, {}}, VALS);
+      }
+      return *this;
+    }
+
+    /**
+    * @brief Append reflection G(t) -> G(beta - t) (imtime_ops::reflect)
+    */
+    imtime_pipeline &reflect() {
+      expect(VALS);
+      push({REFL, {}}, VALS);
+      return *this;
+    }
+
+    /**
+    * @brief Append convolution by a fixed scalar-valued function f, acting on
+    * values on the DLR imaginary time grid (imtime_ops::convmat)
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc DLR coefficients of f
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    */
+    imtime_pipeline &convolve(double beta, statistic_t statistic, nda::vector_const_view<S> fc, bool time_order = false) {
+      expect(VALS);
+      push({CONV, itops_.convmat(beta, statistic, fc, time_order)}, VALS);
+      return *this;
+    }
+
+    /**
+    * @brief Append inner product with a fixed scalar-valued function f
+    * (imtime_ops::innerprod), terminating the pipeline
+    *
+    * @param[in] fc DLR coefficients of f
+    *
+    * \note The pipeline then returns the inner products <f, G> for each
+    * orbital component of G, in an array with first dimension 1; for a
+    * matrix-valued G, the inner product of imtime_ops::innerprod is their sum.
+    */
+    imtime_pipeline &innerprod(nda::vector_const_view<S> fc) {
+      expect(COEFS);
+      if (fc.size() != itops_.rank()) throw std::runtime_error("First dim of fc != DLR rank r.");
+      // Row vector conj(fc)^T * ipmat
+      int r      = itops_.rank();
+      auto ipmat = itops_.get_ipmat();
+      auto row   = nda::matrix<S>(1, r);
+      for (int l = 0; l < r; ++l) {
+        S s = 0;
+        for (int k = 0; k < r; ++k) {
+          if constexpr (nda::is_complex_v<S>) {
+            s += std::conj(fc(k)) * ipmat(k, l);
+          } else {
+            s += fc(k) * ipmat(k, l);
+          }
+        }
+        row(0, l) = s;
+      }
+      push({IPROD, row}, IP);
+      return *this;
+    }
+
+    /**
+    * @brief Get number of recorded operations, after removal of redundant
+    * transformations
+    */
+    int nsteps() const { return steps.size(); }
+
+    /**
+    * @brief Get representation of the input of the pipeline
+    */
+    rep_t input() const { return input_; }
+
+    /**
+    * @brief Get representation of the output of the pipeline
+    */
+    rep_t output() const { return output_; }
+
+    /**
+    * @brief Get fused matrix of the pipeline, computing it if necessary
+    *
+    * @return Fused matrix, r x r (or 1 x r if the pipeline is terminated by an
+    * inner product)
+    */
+    nda::matrix_const_view<S> matrix() const {
+
+      fused_once.call_once([this] {
+        int r = itops_.rank();
+
+        CPPDLR_PROBE("imtime_pipeline::fuse", r * r * sizeof(S), instrument::fma_flops<S> * r * r * r * steps.size());
+
+        auto a = nda::matrix<S>(nda::eye<S>(r));
+        for (auto const &s : steps) {
+          switch (s.kind) {
+            case V2C: a = itops_.vals2coefs(a); break;
+            case C2V: a = itops_.coefs2vals(a); break;
+            case REFL: a = itops_.reflect(a); break;
+            case CONV:
+            case IPROD: a = nda::matrix<S>(s.mat * a); break;
+          }
+        }
+        fused = std::move(a);
+      });
+
+      return fused;
+    }
+
+    /**
+    * @brief Apply pipeline to a Green's function
+    *
+    * @param[in] g Green's function G in the input representation of the
+    * pipeline; first dimension must be the DLR rank r
+    *
+    * @return G in the output representation of the pipeline
+    */
+    template <nda::MemoryArray T, nda::Scalar Sg = nda::get_value_t<T>> auto operator()(T const &g) const {
+
+      if (itops_.rank() != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+
+      auto a = matrix();
+
+      CPPDLR_PROBE("imtime_pipeline::apply", g.size() * sizeof(Sg), instrument::fma_flops<Sg> * a.extent(0) * g.size());
+
+      return arraymult(a, g);
+    }
+
+    private:
+    /**
+    * Kinds of recorded operations
+    */
+    enum step_t { V2C, C2V, REFL, CONV, IPROD };
+
+    /**
+    * Recorded operation
+    */
+    struct step {
+      step_t kind;        ///< Kind of operation
+      nda::matrix<S> mat; ///< Matrix of operation, for CONV and IPROD
+    };
+
+    imtime_ops itops_;            ///< DLR imaginary time object
+    rep_t input_;                 ///< Representation of input
+    rep_t output_;                ///< Representation of output
+    std::vector<step> steps;      ///< Recorded operations
+    mutable nda::matrix<S> fused; ///< Fused matrix of recorded operations
+    mutable init_flag fused_once; ///< Computation of fused
+
+    /**
+    * @brief Check that output of pipeline is in representation @p rep
+    */
+    void expect(rep_t rep) const {
+      if (output_ == IP) throw std::runtime_error("Pipeline has been terminated by an inner product.");
+      if (output_ != rep) {
+        throw std::runtime_error(rep == VALS ? "Operation acts on DLR imaginary time grid values, but pipeline output is DLR coefficients."
+                                             : "Operation acts on DLR coefficients, but pipeline output is DLR imaginary time grid values.");
+      }
+    }
+
+    /**
+    * @brief Record operation with output representation @p rep
+    */
+    void push(step s, rep_t rep) {
+      steps.push_back(std::move(s));
+      output_    = rep;
+      fused_once = init_flag();
+    }
+
+    /**
+    * @brief Remove last recorded operation, leaving output in representation
+    * @p rep
+    */
+    void pop(rep_t rep) {
+      steps.pop_back();
+      output_    = rep;
+      fused_once = init_flag();
+    }
+  };
+
+} // namespace cppdlr
@@ -0,0 +1,317 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "dlr_imtime.hpp"
+#include "utils.hpp"
+
+#include <array>
+#include <memory>
+
+namespace cppdlr {
+
+  inline constexpr int static_rank_min = 16; ///< Smallest DLR rank instantiated by default in dispatch_rank
+  inline constexpr int static_rank_max = 48; ///< Largest DLR rank instantiated by default in dispatch_rank
+
+  /**
+  * @class static_imtime_ops
+  * @brief Imaginary time DLR operations with DLR rank fixed at compile time
+  *
+  * This class implements the transformations between DLR coefficients and
+  * values on the DLR imaginary time grid, and the imaginary time convolution,
+  * of imtime_ops, for a DLR rank R known at compile time. All transformation
+  * matrices are stored in fixed-size arrays inside the object, and are applied
+  * by loop kernels with compile-time trip count over the DLR index, which the
+  * compiler can fully unroll and vectorize. For small R, this avoids the call
+  * overhead of the dynamic-size reshapes, matrix products and LAPACK solves in
+  * imtime_ops, which is comparable to the arithmetic itself.
+  *
+  * The values -> coefficients transformation is applied as an explicit
+  * matrix, computed once from the LU factors held by imtime_ops.
+  *
+  * \note The methods have the same signatures as those of imtime_ops, so that
+  * generic code may be written for either; see dispatch_rank. The object
+  * holds 8 R x R matrices, so for the larger ranks it should not be placed on
+  * the stack of a thread with limited stack size.
+  *
+  * @tparam R DLR rank
+  */
+  template <int R> class static_imtime_ops {
+
+    static_assert(R > 0, "DLR rank must be positive.");
+
+    using mat_t = std::array<double, R * R>; ///< R x R matrix, row-major
+
+    public:
+    /**
+    * @brief Constructor for static_imtime_ops
+    *
+    * @param[in] itops DLR imaginary time object, with DLR rank R
+    *
+    * \note All convolution matrices of @p itops are initialized, if they have
+    * not been already.
+    */
+    explicit static_imtime_ops(imtime_ops const &itops) {
+
+      if (itops.rank() != R) throw std::runtime_error("DLR rank of imtime_ops object != R.");
+
+      copy(itops.get_cf2it(), cf2it);
+      copy(itops.vals2coefs(nda::matrix<double>(nda::eye<double>(R))), it2cf);
+
+      copy_mats(itops, Fermion, false, 0);
+      copy_mats(itops, Boson, false, 1);
+      copy_mats(itops, Fermion, true, 2);
+    }
+
+    /**
+    * @brief Get DLR rank
+    *
+    * @return DLR rank
+    */
+    static constexpr int rank() { return R; }
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary time grid to
+    * DLR coefficients
+    *
+    * @param[in] g Values of G on DLR imaginary time grid
+    * @param[in] transpose Transpose values -> coefficients transformation
+    * (default is false)
+    *
+    * @return DLR coefficients of G
+    *
+    * \note See imtime_ops::vals2coefs
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::array<S, nda::get_rank<T>> vals2coefs(T const &g, bool transpose = false) const {
+
+      CPPDLR_PROBE("static_imtime_ops::vals2coefs", g.size() * sizeof(S), instrument::fma_flops<S> * R * g.size());
+
+      if (R != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+
+      auto gc = nda::array<S, nda::get_rank<T>>(g.shape());
+      transpose ? apply_to<true>(it2cf, g, gc.data()) : apply_to<false>(it2cf, g, gc.data());
+
+      return gc;
+    }
+
+    /**
+    * @brief Transform DLR coefficients of Green's function G to values on DLR
+    * imaginary time grid
+    *
+    * @param[in] gc DLR coefficients of G
+    *
+    * @return Values of G on DLR imaginary time grid
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> nda::array<S, nda::get_rank<T>> coefs2vals(T const &gc) const {
+
+      CPPDLR_PROBE("static_imtime_ops::coefs2vals", gc.size() * sizeof(S), instrument::fma_flops<S> * R * gc.size());
+
+      if (R != gc.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+
+      auto g = nda::array<S, nda::get_rank<T>>(gc.shape());
+      apply_to<false>(cf2it, gc, g.data());
+
+      return g;
+    }
+
+    /**
+    * @brief Compute convolution of two imaginary time Green's functions
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] statistic Fermionic ("Fermion" or 0) or bosonic ("Boson" or 1)
+    * @param[in] fc DLR coefficients of f
+    * @param[in] gc DLR coefficients of g
+    * @param[in] time_order Flag for ordinary (false or ORDINARY, default) or
+    * time-ordered (true or TIME_ORDERED) convolution
+    *
+    * @return Values of h = f * g on DLR imaginary time grid
+    *
+    * \note See imtime_ops::convolve
+    */
+    template <nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>>
+    nda::array<S, nda::get_rank<T>> convolve(double beta, statistic_t statistic, T const &fc, T const &gc, bool time_order = false) const {
+
+      CPPDLR_PROBE("static_imtime_ops::convolve", 4 * fc.size() * sizeof(S),
+                   instrument::fma_flops<S> * (4.0 * R * fc.size() + fc.size() * std::sqrt(fc.size() / R)));
+
+      if (R != fc.shape(0) || R != gc.shape(0)) throw std::runtime_error("First dim of input arrays must be equal to DLR rank r.");
+      if (fc.shape() != gc.shape()) throw std::runtime_error("Input arrays must have the same shape.");
+
+      int i            = (time_order ? 2 : (statistic == Fermion ? 0 : 1));
+      auto const &hilb = hilbs[i];
+      auto const &tcf  = tcf2its[i];
+
+      auto h = nda::array<S, nda::get_rank<T>>(fc.shape());
+
+      if constexpr (nda::get_rank<T> == 1) { // Scalar-valued Green's function
+
+        std::array<S, R> f, g, fg, p, hf, hg;
+        for (int k = 0; k < R; ++k) {
+          f[k]  = fc(k);
+          g[k]  = gc(k);
+          fg[k] = f[k] * g[k];
+        }
+
+        // Off-diagonal contribution
+        apply<false>(hilb, f.data(), hf.data());
+        apply<false>(hilb, g.data(), hg.data());
+        for (int k = 0; k < R; ++k) { p[k] = f[k] * hg[k] + g[k] * hf[k]; }
+
+        // Diagonal contribution plus off-diagonal contribution
+        apply<false>(tcf, fg.data(), h.data());
+        apply<false, true>(cf2it, p.data(), h.data());
+
+      } else if constexpr (nda::get_rank<T> == 3) { // Matrix-valued Green's function
+
+        long m = fc.size() / R;
+
+        auto fca = nda::array<S, 3>(fc);
+        auto gca = nda::array<S, 3>(gc);
+        auto hf  = nda::array<S, 3>(fc.shape());
+        auto hg  = nda::array<S, 3>(fc.shape());
+        apply<false>(hilb, fca.data(), hf.data(), m);
+        apply<false>(hilb, gca.data(), hg.data(), m);
+
+        // Diagonal contribution
+        auto fg = nda::array<S, 3>(fc.shape());
+        gemm_batch(1.0, fca, gca, 0.0, fg);
+        apply<false>(tcf, fg.data(), h.data(), m);
+
+        // Off-diagonal contribution (products written into fg, which is no
+        // longer needed)
+        gemm_batch(1.0, hf, gca, 0.0, fg);
+        gemm_batch(1.0, fca, hg, 1.0, fg);
+        apply<false, true>(cf2it, fg.data(), h.data(), m);
+
+      } else {
+        throw std::runtime_error("Input arrays must be rank 1 (scalar-valued Green's function) or 3 (matrix-valued Green's function).");
+      }
+
+      h *= beta;
+      return h;
+    }
+
+    private:
+    mat_t cf2it;                  ///< Transformation from DLR coefficients to values at DLR imaginary time nodes
+    mat_t it2cf;                  ///< Transformation from values at DLR imaginary time nodes to DLR coefficients
+    std::array<mat_t, 3> hilbs;   ///< "Discrete Hilbert transform" matrices: fermionic, bosonic, time-ordered
+    std::array<mat_t, 3> tcf2its; ///< Diagonal contribution matrices: fermionic, bosonic, time-ordered
+
+    /**
+    * @brief Copy R x R matrix into fixed-size storage
+    */
+    template <nda::MemoryMatrix M> static void copy(M const &a, mat_t &b) {
+      for (int i = 0; i < R; ++i) {
+        for (int k = 0; k < R; ++k) { b[i * R + k] = a(i, k); }
+      }
+    }
+
+    /**
+    * @brief Copy convolution matrices of imtime_ops object into slot @p i
+    */
+    void copy_mats(imtime_ops const &itops, statistic_t statistic, bool time_order, int i) {
+      auto [hilb_v, tcf2it_v] = itops.get_convolve_mats(statistic, time_order);
+      copy(hilb_v, hilbs[i]);
+      copy(tcf2it_v, tcf2its[i]);
+    }
+
+    /**
+    * @brief Apply R x R matrix (or its transpose) to R x m row-major array x,
+    * writing into (or, if Acc = true, adding to) R x m row-major array y
+    *
+    * \note The loop over the DLR index has compile-time trip count; for m = 1
+    * the inner products are fully unrolled.
+    */
+    template <bool Tr, bool Acc = false, typename S> static void apply(mat_t const &a, S const *x, S *y, long m = 1) {
+
+      auto aik = [&a](int i, int k) { return Tr ? a[k * R + i] : a[i * R + k]; };
+
+      if (m == 1) {
+        for (int i = 0; i < R; ++i) {
+          S s = 0;
+          for (int k = 0; k < R; ++k) { s += aik(i, k) * x[k]; }
+          y[i] = (Acc ? y[i] + s : s);
+        }
+      } else {
+        for (int i = 0; i < R; ++i) {
+          S *yi = y + i * m;
+          if constexpr (!Acc) {
+            for (long j = 0; j < m; ++j) { yi[j] = 0; }
+          }
+          for (int k = 0; k < R; ++k) {
+            double c    = aik(i, k);
+            S const *xk = x + k * m;
+            for (long j = 0; j < m; ++j) { yi[j] += c * xk[j]; }
+          }
+        }
+      }
+    }
+
+    /**
+    * @brief Apply R x R matrix (or its transpose) to array with first
+    * dimension R, writing into contiguous row-major storage y
+    *
+    * \note The data of @p x is used in place if it is contiguous with C stride
+    * order, and copied otherwise.
+    */
+    template <bool Tr, nda::MemoryArray T, nda::Scalar S = nda::get_value_t<T>> static void apply_to(mat_t const &a, T const &x, S *y) {
+      long m = x.size() / R;
+      if (x.indexmap().is_contiguous() && x.indexmap().is_stride_order_C()) {
+        apply<Tr>(a, x.data(), y, m);
+      } else {
+        auto xc = nda::array<S, nda::get_rank<T>>(x);
+        apply<Tr>(a, xc.data(), y, m);
+      }
+    }
+  };
+
+  /**
+  * @brief Call a function with the fixed-rank imaginary time DLR object
+  * matching the rank of a given imtime_ops object
+  *
+  * If Rmin <= r <= Rmax, where r is the DLR rank of @p itops, a
+  * static_imtime_ops<r> object is built from @p itops and @p f is called with
+  * it; otherwise @p f is called with @p itops itself. The function @p f should
+  * therefore be generic (e.g. a lambda with an auto parameter), and use only
+  * the methods common to both classes, and return the same type for both.
+  *
+  * @param[in] itops DLR imaginary time object
+  * @param[in] f Function to call with DLR imaginary time object
+  *
+  * @return Return value of @p f
+  *
+  * \note The static_imtime_ops object is built on each call, at a cost of
+  * O(r^3) operations, so the whole computation using it should be done within
+  * @p f, rather than calling dispatch_rank for each operation.
+  *
+  * @tparam Rmin Smallest instantiated DLR rank
+  * @tparam Rmax Largest instantiated DLR rank
+  */
+  template <int Rmin = static_rank_min, int Rmax = static_rank_max, typename F> auto dispatch_rank(imtime_ops const &itops, F &&f) {
+    if constexpr (Rmin > Rmax) {
+      return f(itops);
+    } else {
+      if (itops.rank() == Rmin) {
+        auto ops = std::make_unique<static_imtime_ops<Rmin> const>(itops);
+        return f(*ops);
+      }
+      return dispatch_rank<Rmin + 1, Rmax>(itops, std::forward<F>(f));
+    }
+  }
+
+} // namespace cppdlr
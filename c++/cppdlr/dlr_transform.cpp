@@ -0,0 +1,37 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#include "dlr_transform.hpp"
+
+using namespace nda;
+
+namespace cppdlr {
+
+  dlr_transform::dlr_transform(double beta, imtime_ops const &itops, imfreq_ops const &ifops)
+     : r(itops.rank()), niom(ifops.get_ifnodes().size()) {
+
+    if (ifops.rank() != r || max_element(abs(itops.get_rfnodes() - ifops.get_rfnodes())) != 0) {
+      throw std::runtime_error("imtime_ops and imfreq_ops must have the same DLR frequencies.");
+    }
+
+    // Apply vals -> coefs -> vals maps to identity matrices. In the symmetrized
+    // bosonic case, imaginary frequency vals -> coefs is a least squares fit,
+    // so if2it is the corresponding pseudoinverse.
+    it2if_mat = ifops.coefs2vals(beta, itops.vals2coefs(nda::eye<double>(r)));
+    if2it_mat = itops.coefs2vals(ifops.vals2coefs(beta, nda::eye<dcomplex>(niom)));
+  }
+
+} // namespace cppdlr
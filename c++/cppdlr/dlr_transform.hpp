@@ -0,0 +1,174 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#pragma once
+#include <nda/nda.hpp>
+#include "dlr_imtime.hpp"
+#include "dlr_imfreq.hpp"
+#include "instrument.hpp"
+#include "utils.hpp"
+
+namespace cppdlr {
+
+  /**
+  * @class dlr_transform
+  * @brief Direct transformation of Green's functions between DLR imaginary
+  * time and DLR imaginary frequency grids
+  *
+  * Transforming the values of a Green's function G on the DLR imaginary time
+  * grid to its values on the DLR imaginary frequency grid, or vice versa, is
+  * usually done by first obtaining its DLR coefficients from one set of values
+  * and then evaluating them on the other grid. This class precomputes the
+  * fused transformation matrices
+  *
+  * it2if = beta * cf2if * it2cf,  if2it = 1/beta * cf2it * if2cf,
+  *
+  * so that each transformation is a single matrix-matrix product.
+  *
+  * \note First dimension of all Green's function arrays must be the number of
+  * nodes of the corresponding DLR grid; remaining dimensions are arbitrary.
+  */
+  class dlr_transform {
+
+    public:
+    /**
+    * @brief Constructor for dlr_transform
+    *
+    * @param[in] beta Inverse temperature
+    * @param[in] itops DLR imaginary time object
+    * @param[in] ifops DLR imaginary frequency object, with the same DLR
+    * frequencies as @p itops
+    */
+    dlr_transform(double beta, imtime_ops const &itops, imfreq_ops const &ifops);
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary time grid
+    * to values on DLR imaginary frequency grid
+    *
+    * @param[in] g Values of G on DLR imaginary time grid
+    *
+    * @return Values of G on DLR imaginary frequency grid
+    */
+    template <nda::MemoryArray T> nda::array<dcomplex, nda::get_rank<T>> it2if(T const &g) const {
+      auto shape = g.shape();
+      shape[0]   = niom;
+      auto gif   = nda::array<dcomplex, nda::get_rank<T>>(shape);
+      auto ws    = workspace();
+      it2if_into(g, gif, ws);
+      return gif;
+    }
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary time grid
+    * to values on DLR imaginary frequency grid, writing into a preallocated
+    * array
+    *
+    * @param[in] g Values of G on DLR imaginary time grid
+    * @param[out] gif Values of G on DLR imaginary frequency grid; first
+    * dimension must be # DLR imaginary frequency nodes, other dimensions same
+    * as @p g
+    * @param[in] ws Workspace, used only if @p g is real
+    */
+    template <nda::MemoryArray Tg, nda::MemoryArray Tout, nda::Scalar S = nda::get_value_t<Tg>>
+    void it2if_into(Tg const &g, Tout &&gif, workspace &ws) const {
+
+      CPPDLR_PROBE("dlr_transform::it2if", (g.size() + gif.size()) * sizeof(dcomplex), instrument::fma_flops<dcomplex> * niom * g.size());
+
+      if (r != g.shape(0)) throw std::runtime_error("First dim of g != DLR rank r.");
+      if (niom != gif.shape(0) || g.size() / r != gif.size() / niom) throw std::runtime_error("Output array has incompatible shape.");
+
+      long m      = g.size() / r;
+      auto gif_rs = nda::reshape(gif, niom, m);
+
+      if constexpr (nda::is_complex_v<S>) {
+        nda::blas::gemm(1.0, it2if_mat, nda::reshape(g, r, m), 0.0, gif_rs);
+      } else {
+        auto buf = ws.matrix<dcomplex>(0, r, m);
+        buf      = nda::reshape(g, r, m);
+        nda::blas::gemm(1.0, it2if_mat, buf, 0.0, gif_rs);
+      }
+    }
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary frequency
+    * grid to values on DLR imaginary time grid
+    *
+    * @param[in] g Values of G on DLR imaginary frequency grid
+    *
+    * @return Values of G on DLR imaginary time grid
+    */
+    template <nda::MemoryArray T> nda::array<dcomplex, nda::get_rank<T>> if2it(T const &g) const {
+      auto shape = g.shape();
+      shape[0]   = r;
+      auto git   = nda::array<dcomplex, nda::get_rank<T>>(shape);
+      auto ws    = workspace();
+      if2it_into(g, git, ws);
+      return git;
+    }
+
+    /**
+    * @brief Transform values of Green's function G on DLR imaginary frequency
+    * grid to values on DLR imaginary time grid, writing into a preallocated
+    * array
+    *
+    * @param[in] g Values of G on DLR imaginary frequency grid
+    * @param[out] git Values of G on DLR imaginary time grid; first dimension
+    * must be DLR rank r, other dimensions same as @p g
+    * @param[in] ws Workspace, used only if @p git is real
+    *
+    * \note If @p git is real, the imaginary part of the result is discarded.
+    * This is appropriate for Green's functions which are real in imaginary
+    * time, i.e. satisfy G(i nu_n)^* = G(-i nu_n) elementwise.
+    */
+    template <nda::MemoryArray Tg, nda::MemoryArray Tout> void if2it_into(Tg const &g, Tout &&git, workspace &ws) const {
+
+      CPPDLR_PROBE("dlr_transform::if2it", (g.size() + git.size()) * sizeof(dcomplex), instrument::fma_flops<dcomplex> * r * g.size());
+
+      if (niom != g.shape(0)) throw std::runtime_error("First dim of g != # DLR imaginary frequency nodes.");
+      if (r != git.shape(0) || g.size() / niom != git.size() / r) throw std::runtime_error("Output array has incompatible shape.");
+
+      long m      = g.size() / niom;
+      auto git_rs = nda::reshape(git, r, m);
+
+      if constexpr (nda::is_complex_v<nda::get_value_t<Tout>>) {
+        nda::blas::gemm(1.0, if2it_mat, nda::reshape(g, niom, m), 0.0, git_rs);
+      } else {
+        auto buf = ws.matrix<dcomplex>(0, r, m);
+        nda::blas::gemm(1.0, if2it_mat, nda::reshape(g, niom, m), 0.0, buf);
+        git_rs = real(buf);
+      }
+    }
+
+    /**
+    * @brief Get fused transformation matrix from values on DLR imaginary time
+    * grid to values on DLR imaginary frequency grid
+    */
+    nda::matrix_const_view<dcomplex> get_it2if() const { return it2if_mat; }
+
+    /**
+    * @brief Get fused transformation matrix from values on DLR imaginary
+    * frequency grid to values on DLR imaginary time grid
+    */
+    nda::matrix_const_view<dcomplex> get_if2it() const { return if2it_mat; }
+
+    private:
+    int r;                           ///< DLR rank
+    int niom;                        ///< # DLR imaginary frequency nodes
+    nda::matrix<dcomplex> it2if_mat; ///< Imaginary time values -> imaginary frequency values
+    nda::matrix<dcomplex> if2it_mat; ///< Imaginary frequency values -> imaginary time values
+  };
+
+} // namespace cppdlr
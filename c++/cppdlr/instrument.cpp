@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+#include "instrument.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace cppdlr::instrument {
+
+  registry &registry::instance() {
+    static registry reg;
+    return reg;
+  }
+
+  op_counters &registry::counters(std::string const &name) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return ops[name]; // std::map never invalidates references on insertion
+  }
+
+  std::map<std::string, op_stats> registry::snapshot() const {
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    auto stats = std::map<std::string, op_stats>();
+    for (auto const &[name, c] : ops) {
+      if (c.calls.load() == 0) continue;
+      stats[name] = op_stats{c.calls.load(), c.seconds.load(), c.bytes.load(), c.flops.load()};
+    }
+
+    return stats;
+  }
+
+  void registry::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto &[name, c] : ops) {
+      c.calls   = 0;
+      c.seconds = 0;
+      c.bytes   = 0;
+      c.flops   = 0;
+    }
+  }
+
+  void registry::write_json(std::ostream &os) const {
+
+    auto stats = snapshot();
+
+    os << "{";
+    bool first = true;
+    for (auto const &[name, s] : stats) {
+      os << (first ? "\n" : ",\n") << "  \"" << name << "\": {\"calls\": " << s.calls << ", \"seconds\": " << std::setprecision(17) << s.seconds
+         << ", \"bytes\": " << s.bytes << ", \"flops\": " << s.flops << "}";
+      first = false;
+    }
+    os << "\n}\n";
+  }
+
+  void registry::write_json(std::string const &fname) const {
+    std::ofstream f(fname);
+    if (!f) throw std::runtime_error("Cannot open file " + fname + " for writing.");
+    write_json(f);
+  }
+
+  void h5_write(h5::group fg, std::string const &subgroup_name, registry const &reg) {
+
+    h5::group gr = fg.create_group(subgroup_name);
+    for (auto const &[name, s] : reg.snapshot()) {
+      h5::group og = gr.create_group(name);
+      h5::write(og, "calls", s.calls);
+      h5::write(og, "seconds", s.seconds);
+      h5::write(og, "bytes", s.bytes);
+      h5::write(og, "flops", s.flops);
+    }
+  }
+
+} // namespace cppdlr::instrument
@@ -0,0 +1,231 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file instrument.hpp
+*
+* @brief Opt-in instrumentation of DLR operations
+*
+* If cppdlr is compiled with CPPDLR_INSTRUMENT defined (CMake option
+* -DInstrumentation=ON), each call of an instrumented operation records its
+* wall time, together with estimates of the number of bytes it allocates and
+* the number of floating point operations it performs, in a global registry.
+* The registry can be written to JSON or HDF5. If CPPDLR_USE_NVTX or
+* CPPDLR_USE_ITT is also defined, each call is additionally marked as a
+* named range for NVIDIA Nsight or Intel VTune, respectively.
+*
+* If CPPDLR_INSTRUMENT is not defined, the probes expand to nothing, and
+* their arguments are not evaluated.
+*/
+
+#pragma once
+#include <h5/h5.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#ifdef CPPDLR_USE_NVTX
+#include <nvtx3/nvToolsExt.h>
+#endif
+#ifdef CPPDLR_USE_ITT
+#include <ittnotify.h>
+#endif
+
+namespace cppdlr::instrument {
+
+#ifdef CPPDLR_INSTRUMENT
+  static constexpr bool enabled = true; ///< Whether instrumentation is compiled in
+#else
+  static constexpr bool enabled = false; ///< Whether instrumentation is compiled in
+#endif
+
+  /**
+  * @brief Number of floating point operations in a multiply-add of scalars of
+  * type S, used in flop estimates
+  */
+  template <typename S>
+  inline constexpr double fma_flops = std::is_same_v<S, std::complex<double>> || std::is_same_v<S, std::complex<float>> ? 8.0 : 2.0;
+
+  /**
+  * @brief Statistics of an instrumented operation
+  */
+  struct op_stats {
+    long calls     = 0; ///< Number of calls
+    double seconds = 0; ///< Cumulative wall time (s)
+    double bytes   = 0; ///< Cumulative estimated bytes allocated
+    double flops   = 0; ///< Cumulative estimated floating point operations (0 if not estimated)
+  };
+
+  /**
+  * @brief Thread-safe accumulator of statistics of an instrumented operation
+  */
+  struct op_counters {
+    std::atomic<long> calls     = 0;
+    std::atomic<double> seconds = 0;
+    std::atomic<double> bytes   = 0;
+    std::atomic<double> flops   = 0;
+
+    void add(double s, double b, double f) {
+      calls.fetch_add(1, std::memory_order_relaxed);
+      seconds.fetch_add(s, std::memory_order_relaxed);
+      bytes.fetch_add(b, std::memory_order_relaxed);
+      flops.fetch_add(f, std::memory_order_relaxed);
+    }
+  };
+
+  /**
+  * @class registry
+  * @brief Global registry of statistics of instrumented operations, indexed
+  * by operation name
+  */
+  class registry {
+
+    public:
+    /**
+    * @brief Get global registry
+    */
+    static registry &instance();
+
+    /**
+    * @brief Get accumulator for given operation, creating it if necessary
+    *
+    * \note The returned reference remains valid for the lifetime of the
+    * program; reset() zeroes accumulators but does not remove them.
+    */
+    op_counters &counters(std::string const &name);
+
+    /**
+    * @brief Get copy of statistics of all operations called so far
+    */
+    std::map<std::string, op_stats> snapshot() const;
+
+    /**
+    * @brief Zero statistics of all operations
+    */
+    void reset();
+
+    /**
+    * @brief Write statistics of all operations as a JSON object, with one
+    * member per operation
+    */
+    void write_json(std::ostream &os) const;
+
+    /**
+    * @brief Write statistics of all operations as JSON to file
+    */
+    void write_json(std::string const &fname) const;
+
+    /**
+    * @brief Write statistics of all operations to HDF5, with one subgroup per
+    * operation
+    */
+    friend void h5_write(h5::group fg, std::string const &subgroup_name, registry const &reg);
+
+    private:
+    registry() = default;
+
+    mutable std::mutex mtx;                  ///< Guards insertion into ops
+    std::map<std::string, op_counters> ops; ///< Accumulators by operation name
+  };
+
+  /**
+  * @brief Instrumentation site: name of an operation, and handles associated
+  * with it, set up once per call site
+  */
+  struct site {
+    char const *name;     ///< Operation name
+    op_counters *ctr;     ///< Accumulator in global registry
+#ifdef CPPDLR_USE_ITT
+    __itt_string_handle *itt_name; ///< ITT name handle
+#endif
+
+    explicit site(char const *name) : name(name), ctr(&registry::instance().counters(name)) {
+#ifdef CPPDLR_USE_ITT
+      itt_name = __itt_string_handle_create(name);
+#endif
+    }
+  };
+
+#ifdef CPPDLR_USE_ITT
+  /**
+  * @brief ITT domain of cppdlr
+  */
+  inline __itt_domain *itt_domain() {
+    static __itt_domain *d = __itt_domain_create("cppdlr");
+    return d;
+  }
+#endif
+
+  /**
+  * @class probe
+  * @brief Scoped timer which records a call of an operation on destruction
+  */
+  class probe {
+
+    public:
+    probe(site const &s, double bytes, double flops) : s(s), bytes(bytes), flops(flops), start(std::chrono::steady_clock::now()) {
+#ifdef CPPDLR_USE_NVTX
+      nvtxRangePushA(s.name);
+#endif
+#ifdef CPPDLR_USE_ITT
+      __itt_task_begin(itt_domain(), __itt_null, __itt_null, s.itt_name);
+#endif
+    }
+
+    ~probe() {
+#ifdef CPPDLR_USE_ITT
+      __itt_task_end(itt_domain());
+#endif
+#ifdef CPPDLR_USE_NVTX
+      nvtxRangePop();
+#endif
+      s.ctr->add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), bytes, flops);
+    }
+
+    probe(probe const &)            = delete;
+    probe &operator=(probe const &) = delete;
+
+    private:
+    site const &s;
+    double bytes, flops;
+    std::chrono::steady_clock::time_point start;
+  };
+
+} // namespace cppdlr::instrument
+
+#define CPPDLR_PROBE_CAT_(a, b) a##b
+#define CPPDLR_PROBE_CAT(a, b) CPPDLR_PROBE_CAT_(a, b)
+
+/**
+* @brief Record call of operation @p name, with estimated bytes allocated and
+* floating point operations, until the end of the enclosing scope
+*
+* Does nothing, and does not evaluate its arguments, unless CPPDLR_INSTRUMENT
+* is defined.
+*/
+#ifdef CPPDLR_INSTRUMENT
+#define CPPDLR_PROBE(name, bytes, flops)                                                                                                             \
+  static ::cppdlr::instrument::site const CPPDLR_PROBE_CAT(cppdlr_site_, __LINE__){name};                                                           \
+  ::cppdlr::instrument::probe const CPPDLR_PROBE_CAT(cppdlr_probe_, __LINE__){CPPDLR_PROBE_CAT(cppdlr_site_, __LINE__), double(bytes), double(flops)}
+#else
+#define CPPDLR_PROBE(name, bytes, flops) static_cast<void>(0)
+#endif
@@ -21,8 +21,85 @@
 using namespace nda;
 using std::numbers::pi;
 
+// Single precision BLAS and LAPACK routines, which are not wrapped by nda.
+// Character arguments are followed by their hidden Fortran string lengths.
+extern "C" {
+void sgemm_(char const *transa, char const *transb, int const *m, int const *n, int const *k, float const *alpha, float const *a, int const *lda,
+            float const *b, int const *ldb, float const *beta, float *c, int const *ldc, std::size_t transa_len, std::size_t transb_len);
+void sgetrf_(int const *m, int const *n, float *a, int const *lda, int *ipiv, int *info);
+void cgetrf_(int const *m, int const *n, std::complex<float> *a, int const *lda, int *ipiv, int *info);
+void sgetrs_(char const *trans, int const *n, int const *nrhs, float const *a, int const *lda, int const *ipiv, float *b, int const *ldb, int *info,
+             std::size_t trans_len);
+void cgetrs_(char const *trans, int const *n, int const *nrhs, std::complex<float> const *a, int const *lda, int const *ipiv, std::complex<float> *b,
+             int const *ldb, int *info, std::size_t trans_len);
+}
+
 namespace cppdlr {
 
+  template <nda::Scalar S> lu_single<S>::lu_single(nda::matrix_const_view<S> a) : lu(a.extent(0), a.extent(1)), piv(a.extent(0)) {
+
+    if (a.extent(0) != a.extent(1)) throw std::runtime_error("Matrix must be square.");
+
+    int n = a.extent(0), lda = std::max(n, 1), info = 0;
+    for (int j = 0; j < n; ++j) {
+      for (int i = 0; i < n; ++i) { lu(i, j) = single_t(a(i, j)); }
+    }
+
+    if constexpr (nda::is_complex_v<S>) {
+      cgetrf_(&n, &n, lu.data(), &lda, piv.data(), &info);
+    } else {
+      sgetrf_(&n, &n, lu.data(), &lda, piv.data(), &info);
+    }
+    if (info != 0) throw std::runtime_error("Single precision LU factorization failed.");
+  }
+
+  template <nda::Scalar S> void lu_single<S>::solve(nda::matrix_view<S> b) const {
+
+    int n = lu.extent(0), nrhs = b.extent(1), ldb = std::max(n, 1), info = 0;
+    if (b.extent(0) != n) throw std::runtime_error("First dim of b != dimension of factorized matrix.");
+
+    // Solve in single precision, in Fortran layout as required by LAPACK
+    auto bs = nda::matrix<single_t, nda::F_layout>(n, nrhs);
+    for (int j = 0; j < nrhs; ++j) {
+      for (int i = 0; i < n; ++i) { bs(i, j) = single_t(b(i, j)); }
+    }
+
+    char trans = 'N';
+    if constexpr (nda::is_complex_v<S>) {
+      cgetrs_(&trans, &n, &nrhs, lu.data(), &ldb, piv.data(), bs.data(), &ldb, &info, 1);
+    } else {
+      sgetrs_(&trans, &n, &nrhs, lu.data(), &ldb, piv.data(), bs.data(), &ldb, &info, 1);
+    }
+    if (info != 0) throw std::runtime_error("Single precision LU solve failed.");
+
+    for (int j = 0; j < nrhs; ++j) {
+      for (int i = 0; i < n; ++i) { b(i, j) = S(bs(i, j)); }
+    }
+  }
+
+  template class lu_single<double>;
+  template class lu_single<dcomplex>;
+
+  void gemm_single(long m, long n, long k, float alpha, float const *a, std::array<long, 2> as, float const *b, std::array<long, 2> bs, float beta,
+                   float *c, long ldc) {
+
+    if (m == 0 || n == 0) return;
+
+    // The C layout product c = a * b is the Fortran layout product c^T = b^T *
+    // a^T. A matrix with unit stride along rows is seen by BLAS as its
+    // transpose, and one with unit stride along columns as itself.
+    auto op = [](std::array<long, 2> s, long nrow, long ncol) -> std::pair<char, int> {
+      if (s[1] == 1) return {'N', int(std::max({s[0], ncol, 1L}))};
+      if (s[0] == 1) return {'T', int(std::max({s[1], nrow, 1L}))};
+      throw std::runtime_error("Matrix arguments of gemm_single must have unit stride in one dimension.");
+    };
+
+    auto [transa, lda] = op(as, m, k);
+    auto [transb, ldb] = op(bs, k, n);
+    int mi = m, ni = n, ki = k, ldci = std::max({ldc, n, 1L});
+    sgemm_(&transb, &transa, &ni, &mi, &ki, &alpha, b, &ldb, a, &lda, &beta, c, &ldci, 1, 1);
+  }
+
   barycheb::barycheb(int n) : x(n), w(n) {
     for (int i = 0; i < n; i++) {
       auto c       = (2 * i + 1) * pi / (2 * n);
@@ -81,6 +158,22 @@ namespace cppdlr {
     return t;
   }
 
+  bool is_eqptsrel(nda::vector_const_view<double> t) {
+
+    int n = t.size();
+    if (n == 0 || t(n - 1) != 1) { return false; }
+
+    for (int i = 0; i < n - 1; ++i) {
+      if (i <= (n - 1) / 2) {
+        if (t(i) != i * 1.0 / (n - 1)) { return false; }
+      } else {
+        if (t(i) != -(n - 1 - i) * 1.0 / (n - 1)) { return false; }
+      }
+    }
+
+    return true;
+  }
+
   nda::vector<double> rel2abs(nda::vector_const_view<double> t) {
 
     auto t_abs = nda::vector<double>(t.size());
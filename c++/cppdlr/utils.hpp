@@ -18,6 +18,16 @@
 #include "nda/concepts.hpp"
 #include <nda/nda.hpp>
 #include <nda/blas.hpp>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 using namespace nda;
 
@@ -463,6 +473,422 @@ namespace cppdlr {
     return {aa(nda::range(r), _), norms(nda::range(r)), piv(nda::range(r))};
   }
 
+  namespace detail {
+
+    /**
+     * @brief Core of blocked pivoted reorthogonalized Gram-Schmidt
+     *
+     * Rows of @p aa are selected in groups of @p gsz consecutive rows (gsz = 1
+     * for the standard version, gsz = 2 for the symmetrized version, in which
+     * case symmetric rows must be adjacent in @p aa). Rows @p jstrt and beyond
+     * are assumed to be orthogonal to the (orthonormal) rows 0, ..., jstrt-1.
+     *
+     * The update of the remaining rows is deferred: after each selection, only
+     * the inner products of the new basis vector with the remaining rows are
+     * computed (matrix-vector product), and used to downdate the row norms
+     * for pivoting. Once @p nb rows have been selected, the accumulated update
+     * is applied with a single matrix-matrix product and the norms are
+     * recomputed. As in LAPACK's geqp3, the block is ended early if a
+     * downdated norm has lost too much relative accuracy to be used for
+     * pivoting. Each selected row is reorthogonalized against all previously
+     * selected rows, as in the unblocked version.
+     *
+     * @param aa    Matrix to be orthogonalized, overwritten by orthonormal rows
+     * @param norms Squared l2 norms of rows of @p aa
+     * @param piv   Pivots, permuted along with rows of @p aa
+     * @param epssq Squared rank cutoff tolerance
+     * @param rmax  Maximum number of rows to select
+     * @param gsz   Number of rows selected per pivoting step (1 or 2)
+     * @param check Terminate when norm of selected row is below tolerance
+     * @param jstrt Number of rows already selected
+     * @param nb    Block size, at least 1; a block contains a single pivot
+     * group if @p gsz > @p nb
+     *
+     * @return Number of selected rows
+     */
+    template <nda::Scalar S>
+    long pivrgs_blocked_core(nda::matrix<S> &aa, nda::vector<double> &norms, nda::vector<int> &piv, double epssq, long rmax, int gsz, bool check,
+                             long jstrt, int nb) {
+
+      auto _ = nda::range::all;
+
+      if (nb < 1) throw std::runtime_error("Block size nb must be at least 1.");
+
+      long m       = aa.shape(0);
+      double tol3z = std::sqrt(std::numeric_limits<double>::epsilon()); // Relative accuracy threshold for downdated norms
+
+      // A block holds at most nb rows, or a single pivot group if it is larger
+      int nbmax = std::max(nb, gsz);
+
+      auto nref = nda::vector<double>(norms); // Norms at last exact recomputation
+      auto c    = nda::matrix<S>(m, nbmax);   // Inner products of block basis vectors w/ remaining rows
+      auto tmp  = nda::vector<S>(aa.shape(1));
+      auto ctmp = nda::vector<S>(nbmax);
+
+      long j0 = jstrt, nq = 0; // First row and # rows in current block
+      bool refresh = false;    // Flag to end current block early
+      double nrm = 0, s = 0;
+      long jpiv = 0;
+      int jj    = 0;
+
+      for (long j = jstrt; j < rmax; j += gsz) {
+
+        // Find next pivot group
+        jpiv = j;
+        nrm  = 0;
+        for (int g = 0; g < gsz; ++g) { nrm += norms(j + g); }
+        for (long k = j + gsz; k + gsz <= m; k += gsz) {
+          s = 0;
+          for (int g = 0; g < gsz; ++g) { s += norms(k + g); }
+          if (s > nrm) {
+            jpiv = k;
+            nrm  = s;
+          }
+        }
+
+        // Swap current row group with chosen pivot row group
+        if (jpiv != j) {
+          for (int g = 0; g < gsz; ++g) {
+            tmp             = aa(j + g, _);
+            aa(j + g, _)    = aa(jpiv + g, _);
+            aa(jpiv + g, _) = tmp;
+
+            if (nq > 0) {
+              ctmp(nda::range(nq))        = c(j + g, nda::range(nq));
+              c(j + g, nda::range(nq))    = c(jpiv + g, nda::range(nq));
+              c(jpiv + g, nda::range(nq)) = ctmp(nda::range(nq));
+            }
+
+            std::swap(norms(j + g), norms(jpiv + g));
+            std::swap(nref(j + g), nref(jpiv + g));
+
+            jj            = piv(j + g);
+            piv(j + g)    = piv(jpiv + g);
+            piv(jpiv + g) = jj;
+          }
+        }
+
+        for (int g = 0; g < gsz; ++g) {
+
+          long i = j + g;
+          auto v = aa(i, _);
+
+          // Apply pending update from current block to current row
+          if (nq > 0) { v -= matvecmul(transpose(aa(nda::range(j0, j0 + nq), _)), nda::vector<S>(c(i, nda::range(nq)))); }
+
+          // Reorthogonalize current row against all previously chosen rows
+          if (i > 0) {
+            auto q  = aa(nda::range(0, i), _);
+            auto vc = nda::vector<S>(conj(v));
+            auto d  = nda::vector<S>(conj(matvecmul(q, vc)));
+            v -= matvecmul(transpose(q), d);
+          }
+
+          // Get norm of current row
+          nrm = real(blas::dotc(v, v));
+
+          // Terminate if sufficiently small, and return # previously selected
+          // rows (not including current row)
+          if (check && g == 0 && nrm <= epssq) { return i; }
+
+          // Normalize current row
+          norms(i) = nrm;
+          v        = v * (1 / sqrt(nrm));
+
+          // Inner products of current row with remaining rows; since the
+          // current row is orthogonal to all previous ones, the pending
+          // updates of the remaining rows need not be applied first
+          if (i + 1 < m) {
+            auto rows   = nda::range(i + 1, m);
+            auto vc     = nda::vector<S>(conj(v));
+            c(rows, nq) = matvecmul(aa(rows, _), vc);
+
+            // Downdate norms of remaining rows
+            for (long k = i + 1; k < m; ++k) {
+              norms(k) -= std::norm(c(k, nq));
+              if (nref(k) > epssq && norms(k) < tol3z * nref(k)) { refresh = true; }
+            }
+          }
+          nq++;
+        }
+
+        // Apply accumulated block update to remaining rows and recompute their
+        // norms
+        long jl = j + gsz; // First row not yet selected
+        if ((refresh || nq + gsz > nb) && jl < rmax && jl < m) {
+          auto rows = nda::range(jl, m);
+          aa(rows, _) -= c(rows, nda::range(nq)) * aa(nda::range(j0, jl), _);
+          for (long k = jl; k < m; ++k) { norms(k) = real(blas::dotc(aa(k, _), aa(k, _))); }
+          nref(rows) = norms(rows);
+
+          j0      = jl;
+          nq      = 0;
+          refresh = false;
+        }
+      }
+
+      return rmax;
+    }
+
+  } // namespace detail
+
+  /**
+   * @brief Blocked rank-revealing pivoted reorthogonalized Gram-Schmidt
+   *
+   * Drop-in replacement for pivrgs(T const &, double), in which the update of
+   * the remaining rows after each selection is accumulated and applied in
+   * blocks of @p nb rows using matrix-matrix products.
+   *
+   * @param a   Matrix to be orthogonalized
+   * @param eps Rank cutoff tolerance
+   * @param nb  Block size
+   *
+   * @return Tuple of (1) matrix whose rows form orthogonal basis of
+   * row space of @p a to @p eps tolerance, (2) vector with entry n given by the
+   * squared l2 norm of the orthogonal complement of nth selected row with
+   * respect to subspace spanned by first n-1 selected rows, (3) vector of
+   * pivots
+   */
+
+  // Type T must be scalar-valued rank 2 array/array_view or matrix/matrix_view
+  template <nda::MemoryArrayOfRank<2> T, nda::Scalar S = get_value_t<T>>
+  std::tuple<typename T::regular_type, nda::vector<double>, nda::vector<int>> pivrgs_blocked(T const &a, double eps, int nb = 32) {
+
+    auto _ = nda::range::all;
+
+    // Copy input data
+    auto aa = nda::matrix<S>(a);
+
+    // Get matrix dimensions
+    auto [m, n] = aa.shape();
+    long maxrnk = std::min(m, n);
+
+    // Compute norms of rows of input matrix
+    auto norms = nda::vector<double>(m);
+    for (int j = 0; j < m; ++j) { norms(j) = real(blas::dotc(aa(j, _), aa(j, _))); }
+
+    auto piv = nda::vector<int>(m);
+    for (int j = 0; j < m; ++j) { piv(j) = j; }
+
+    long rnk = detail::pivrgs_blocked_core(aa, norms, piv, eps * eps, maxrnk, 1, true, 0, nb);
+
+    return {typename T::regular_type(aa(nda::range(rnk), _)), norms(nda::range(rnk)), piv(nda::range(rnk))};
+  }
+
+  /**
+   * @brief Blocked rank-revealing pivoted reorthogonalized Gram-Schmidt, with
+   * given rows selected first
+   *
+   * Same as pivrgs_blocked, except that the first @p nseed rows of @p a are
+   * selected first, in order and without pivoting, after which the remaining
+   * rows are selected by pivoting as usual. This is used to extend a basis
+   * selected by an earlier run, whose rows are placed first, by rows of a
+   * larger set of candidates.
+   *
+   * @param a     Matrix to be orthogonalized
+   * @param eps   Rank cutoff tolerance
+   * @param nseed Number of leading rows of @p a to select first
+   * @param nb    Block size
+   *
+   * @return Tuple of (1) matrix whose rows form orthogonal basis of
+   * row space of @p a to @p eps tolerance, (2) vector with entry n given by the
+   * squared l2 norm of the orthogonal complement of nth selected row with
+   * respect to subspace spanned by first n-1 selected rows, (3) vector of
+   * pivots, the first @p nseed of which are 0, ..., @p nseed - 1
+   *
+   * \note An exception is thrown if the norm of the orthogonal complement of a
+   * seed row is below @p eps.
+   */
+
+  // Type T must be scalar-valued rank 2 array/array_view or matrix/matrix_view
+  template <nda::MemoryArrayOfRank<2> T, nda::Scalar S = get_value_t<T>>
+  std::tuple<typename T::regular_type, nda::vector<double>, nda::vector<int>> pivrgs_blocked_seeded(T const &a, double eps, long nseed, int nb = 32) {
+
+    auto _ = nda::range::all;
+
+    // Copy input data
+    auto aa = nda::matrix<S>(a);
+
+    // Get matrix dimensions
+    auto [m, n] = aa.shape();
+    long maxrnk = std::min(m, n);
+
+    if (nseed < 0 || nseed > maxrnk) { throw std::runtime_error("Number of seed rows must be between 0 and min(m,n)."); }
+
+    auto norms = nda::vector<double>(m);
+    auto piv   = nda::vector<int>(m);
+    for (int j = 0; j < m; ++j) { piv(j) = j; }
+
+    // Orthonormalize seed rows in order, orthogonalizing twice against
+    // previous seed rows
+    for (long i = 0; i < nseed; ++i) {
+      auto v = aa(i, _);
+      if (i > 0) {
+        auto q = aa(nda::range(0, i), _);
+        for (int pass = 0; pass < 2; ++pass) {
+          auto vc = nda::vector<S>(conj(v));
+          auto d  = nda::vector<S>(conj(matvecmul(q, vc)));
+          v -= matvecmul(transpose(q), d);
+        }
+      }
+
+      double nrm = real(blas::dotc(v, v));
+      if (nrm <= eps * eps) { throw std::runtime_error("Seed rows are linearly dependent to within tolerance."); }
+
+      norms(i) = nrm;
+      v        = v * (1 / sqrt(nrm));
+    }
+
+    // Orthogonalize remaining rows against seed rows, and compute their norms
+    if (nseed < m) {
+      auto rows = nda::range(nseed, m);
+      if (nseed > 0) {
+        auto q = aa(nda::range(nseed), _);
+        aa(rows, _) -= nda::matrix<S>(aa(rows, _) * transpose(conj(q))) * q;
+      }
+      for (long k = nseed; k < m; ++k) { norms(k) = real(blas::dotc(aa(k, _), aa(k, _))); }
+    }
+
+    long rnk = detail::pivrgs_blocked_core(aa, norms, piv, eps * eps, maxrnk, 1, true, nseed, nb);
+
+    return {typename T::regular_type(aa(nda::range(rnk), _)), norms(nda::range(rnk)), piv(nda::range(rnk))};
+  }
+
+  /**
+   * @brief Blocked symmetrized rank-revealing pivoted reorthogonalized Gram-Schmidt
+   *
+   * Drop-in replacement for pivrgs_sym(T const &, double), in which the update
+   * of the remaining rows after each selection is accumulated and applied in
+   * blocks of @p nb rows using matrix-matrix products.
+   *
+   * @param a   Matrix to be orthogonalized
+   * @param eps Rank cutoff tolerance
+   * @param nb  Block size
+   *
+   * @return Tuple of (1) matrix whose rows form orthogonal basis of
+   * row space of @p a to @p eps tolerance, (2) vector with entry n given by the
+   * squared l2 norm of the orthogonal complement of nth selected row with
+   * respect to subspace spanned by first n-1 selected rows, (3) vector of
+   * pivots
+   *
+   * \note The symmetrization condition is that if A(i,:), the ith row of A, is
+   * selected as a pivot, then A(m-i-1,:) is also selected as a pivot. Here, m
+   * is the row dimension of A, and A is zero-indexed. m must be even.
+   */
+
+  // Type T must be scalar-valued rank 2 array/array_view or matrix/matrix_view
+  template <nda::MemoryArrayOfRank<2> T, nda::Scalar S = get_value_t<T>>
+  std::tuple<typename T::regular_type, nda::vector<double>, nda::vector<int>> pivrgs_sym_blocked(T const &a, double eps, int nb = 32) {
+
+    auto _ = nda::range::all;
+
+    // Get matrix dimensions
+    auto [m, n] = a.shape();
+    long maxrnk = std::min(m, n);
+
+    if (m % 2 != 0) { throw std::runtime_error("Input matrix must have even number of rows."); }
+    if (maxrnk % 2 != 0) { maxrnk -= 1; } // If n < m and n is odd, decrease maxrnk to maintain symmetry
+
+    // Copy input data, re-ordering rows to make symmetric rows adjacent.
+    auto aa                    = nda::matrix<S>(m, n);
+    aa(nda::range(0, m, 2), _) = a(nda::range(0, m / 2), _);
+    aa(nda::range(1, m, 2), _) = a(nda::range(m - 1, m / 2 - 1, -1), _);
+
+    // Compute norms of rows of input matrix
+    auto norms = nda::vector<double>(m);
+    for (int j = 0; j < m; ++j) { norms(j) = real(blas::dotc(aa(j, _), aa(j, _))); }
+
+    // Re-order pivots to match re-ordered input matrix
+    auto piv = nda::vector<int>(m);
+    for (int j = 0; j < m / 2; ++j) {
+      piv(2 * j)     = j;
+      piv(2 * j + 1) = m - 1 - j;
+    }
+
+    long rnk = detail::pivrgs_blocked_core(aa, norms, piv, eps * eps, maxrnk, 2, true, 0, nb);
+
+    return {typename T::regular_type(aa(nda::range(rnk), _)), norms(nda::range(rnk)), piv(nda::range(rnk))};
+  }
+
+  /**
+   * @brief Blocked symmetrized pivoted reorthogonalized Gram-Schmidt with specified rank
+   *
+   * Drop-in replacement for pivrgs_sym(T const &, int), in which the update
+   * of the remaining rows after each selection is accumulated and applied in
+   * blocks of @p nb rows using matrix-matrix products.
+   *
+   * @param a   Matrix to be orthogonalized
+   * @param r   Rank cutoff
+   * @param nb  Block size
+   *
+   * @return Tuple of (1) matrix whose rows are leading @p r vectors in
+   * orthogonal basis of row space of @p a, (2) vector with entry n given by the
+   * squared l2 norm of the orthogonal complement of nth selected row with
+   * respect to subspace spanned by first n-1 selected rows, (3) vector of
+   * pivots
+   *
+   * \note See pivrgs_sym(T const &, int) for the symmetrization condition.
+   */
+
+  // Type T must be scalar-valued rank 2 array/array_view or matrix/matrix_view
+  template <nda::MemoryArrayOfRank<2> T, nda::Scalar S = get_value_t<T>>
+  std::tuple<typename T::regular_type, nda::vector<double>, nda::vector<int>> pivrgs_sym_blocked(T const &a, int r, int nb = 32) {
+
+    auto _ = nda::range::all;
+
+    // Get matrix dimensions
+    auto [m, n] = a.shape();
+
+    if (m % 2 == 1 && r % 2 == 0) { throw std::runtime_error("If input matrix has odd number of rows, r must be odd."); }
+    if (r % 2 == 1 && m % 2 == 0) { throw std::runtime_error("If r is odd, input matrix must have odd number of rows."); }
+    if (r > m || r > n + 1) { throw std::runtime_error("r must be less than or equal to min(m,n+1)."); }
+    if (r == n + 1 && (n % 2 == 1 || n > m)) { throw std::runtime_error("If r = n+1, n must be even and less than or equal to m."); }
+
+    // Copy input data, re-ordering rows to make symmetric rows adjacent. If m
+    // odd, put middle row first, and re-order pivots to match.
+    auto aa  = nda::matrix<S>(m, n);
+    auto piv = nda::vector<int>(m);
+    if (m % 2 == 0) {
+      aa(nda::range(0, m, 2), _) = a(nda::range(0, m / 2), _);
+      aa(nda::range(1, m, 2), _) = a(nda::range(m - 1, m / 2 - 1, -1), _);
+      for (int j = 0; j < m / 2; ++j) {
+        piv(2 * j)     = j;
+        piv(2 * j + 1) = m - 1 - j;
+      }
+    } else {
+      aa(0, _)                   = a((m - 1) / 2, _);
+      aa(nda::range(1, m, 2), _) = a(nda::range(0, (m - 1) / 2), _);
+      aa(nda::range(2, m, 2), _) = a(nda::range(m - 1, (m - 1) / 2, -1), _);
+      piv(0)                     = (m - 1) / 2;
+      for (int j = 0; j < (m - 1) / 2; ++j) {
+        piv(2 * j + 1) = j;
+        piv(2 * j + 2) = m - 1 - j;
+      }
+    }
+
+    // Compute norms of rows of input matrix
+    auto norms = nda::vector<double>(m);
+    for (int j = 0; j < m; ++j) { norms(j) = real(blas::dotc(aa(j, _), aa(j, _))); }
+
+    // If m odd, first choose middle row (now first row) as first pivot
+    if (m % 2 == 1) {
+
+      // Normalize
+      double nrm = norms(0);
+      aa(0, _)   = aa(0, _) * (1 / sqrt(nrm));
+
+      // Orthogonalize remaining rows against current row
+      for (int k = 1; k < m; ++k) {
+        aa(k, _) = aa(k, _) - aa(0, _) * blas::dotc(aa(0, _), aa(k, _));
+        norms(k) = real(blas::dotc(aa(k, _), aa(k, _)));
+      }
+    }
+
+    detail::pivrgs_blocked_core(aa, norms, piv, 0.0, r, 2, false, m % 2, nb);
+
+    return {typename T::regular_type(aa(nda::range(r), _)), norms(nda::range(r)), piv(nda::range(r))};
+  }
+
   /**
   * @brief Get grid of equispaced points on [0,1] in relative time format
   *
@@ -472,6 +898,15 @@ namespace cppdlr {
   */
   nda::vector<double> eqptsrel(int n);
 
+  /**
+  * @brief Check whether a grid is the equispaced grid returned by eqptsrel
+  *
+  * @param t  Vector of points on [0,1] in relative time format
+  *
+  * @return True if @p t is identical to eqptsrel(t.size())
+  */
+  bool is_eqptsrel(nda::vector_const_view<double> t);
+
   /**
   * @brief Convert points on [0,1] from relative to absolute time format
   *
@@ -580,90 +1015,732 @@ namespace cppdlr {
   }
 
   /**
-  * @brief Quick and dirty adaptive Gauss quadrature
+  * @brief Find block-diagonal structure of a square matrix
   *
-  * This function implements adaptive Gauss-Legendre quadrature with local error
-  * estimation only, using a stack.
-  * 
-  * @param[in] f  Function to be integrated
-  * @param[in] a  Lower integration limit
-  * @param[in] b  Upper integration limit
-  * @param[in] tol  Absolute error tolerance
-  * @param[in] xgl Gauss-Legendre nodes
-  * @param[in] wgl Gauss-Legendre weights
+  * Obtain the sizes of the finest partition of the indices of @p h into ranges
+  * of consecutive indices, such that @p h is block-diagonal with respect to
+  * this partition.
   *
-  * @return Integral of \p f from \p a to \p b
+  * @param[in] h Square matrix
+  * @param[in] tol Entries of magnitude at most @p tol are treated as zero
+  * (default 0)
   *
-  * \note This is a quick and dirty adaptive integration function, which tries
-  * to achieve an error tolerance \p tol but doesn't guarantee it. A more robust
-  * implementation would use global error estimation. Nevertheless, this works
-  * quite well most of the time.
+  * @return Block sizes, summing to the dimension of @p h
+  *
+  * \note Only blocks of consecutive indices are detected, so symmetry sectors
+  * should be made contiguous by a reordering of the orbitals.
+  */
+  template <nda::MemoryMatrix T> std::vector<int> find_blocks(T const &h, double tol = 0) {
+
+    int n = h.shape(0);
+    if (h.shape(1) != n) throw std::runtime_error("Input matrix must be square.");
+
+    auto blocks = std::vector<int>();
+    int start = 0, end = 0; // Current block is [start, end], with end the largest index coupled to it so far
+    for (int i = 0; i < n; ++i) {
+      for (int j = end + 1; j < n; ++j) {
+        if (std::abs(h(i, j)) > tol || std::abs(h(j, i)) > tol) { end = j; }
+      }
+      if (end == i) {
+        blocks.push_back(end - start + 1);
+        start = end = i + 1;
+      }
+    }
+
+    return blocks;
+  }
+
+  /**
+  * @brief Split block-diagonal matrix-valued Green's function into its
+  * diagonal blocks
+  *
+  * @param[in] g Green's function, with shape (r, norb, norb)
+  * @param[in] blocks Block sizes, summing to norb
+  *
+  * @return List of diagonal blocks of @p g, the ith of shape (r, blocks[i],
+  * blocks[i])
+  */
+  template <nda::MemoryArrayOfRank<3> T, nda::Scalar S = nda::get_value_t<T>>
+  std::vector<nda::array<S, 3>> split_blocks(T const &g, std::vector<int> const &blocks) {
+
+    if (std::accumulate(blocks.begin(), blocks.end(), 0) != g.shape(1) || g.shape(1) != g.shape(2)) {
+      throw std::runtime_error("Block sizes must sum to number of orbital indices.");
+    }
+
+    auto _  = nda::range::all;
+    auto gb = std::vector<nda::array<S, 3>>();
+    gb.reserve(blocks.size());
+    int o = 0; // Offset of current block
+    for (int n : blocks) {
+      gb.emplace_back(g(_, nda::range(o, o + n), nda::range(o, o + n)));
+      o += n;
+    }
+
+    return gb;
+  }
+
+  /**
+  * @brief Assemble block-diagonal matrix-valued Green's function from its
+  * diagonal blocks
+  *
+  * @param[in] gb List of diagonal blocks, the ith of shape (r, n_i, n_i)
+  *
+  * @return Green's function, with shape (r, norb, norb), norb = sum_i n_i,
+  * and zero off-diagonal blocks
   */
+  template <nda::MemoryArrayOfRank<3> T, nda::Scalar S = nda::get_value_t<T>> nda::array<S, 3> join_blocks(std::vector<T> const &gb) {
+
+    if (gb.empty()) throw std::runtime_error("List of blocks must not be empty.");
+
+    long r = gb[0].shape(0), norb = 0;
+    for (auto const &b : gb) { norb += b.shape(1); }
+
+    auto _ = nda::range::all;
+    auto g = nda::array<S, 3>(r, norb, norb);
+    g      = 0;
+    int o  = 0; // Offset of current block
+    for (auto const &b : gb) {
+      int n                                            = b.shape(1);
+      g(_, nda::range(o, o + n), nda::range(o, o + n)) = b;
+      o += n;
+    }
+
+    return g;
+  }
 
+  /**
+  * @brief Whether a scalar type is single precision (float or complex<float>)
+  */
   template <typename S>
-  // TODO: require S is scalar
-  S adapgl(std::function<nda::array<S, 1>(nda::array<double, 1>)> f, double a, double b, double tol, nda::vector<double> xgl,
-           nda::vector<double> wgl) {
+  inline constexpr bool is_single_v = std::is_same_v<std::remove_const_t<S>, float> || std::is_same_v<std::remove_const_t<S>, std::complex<float>>;
+
+  /**
+  * @brief Copy of a real matrix, rounded to single precision
+  *
+  * @param[in] a Real double precision matrix
+  *
+  * @return Single precision copy of @p a
+  */
+  template <nda::MemoryMatrix M> nda::matrix<float> to_single(M const &a) {
+
+    auto as = nda::matrix<float>(a.shape());
+    for (int i = 0; i < a.extent(0); ++i) {
+      for (int j = 0; j < a.extent(1); ++j) { as(i, j) = float(a(i, j)); }
+    }
+
+    return as;
+  }
+
+  /**
+  * @brief Single precision real matrix-matrix product c = alpha * a * b + beta
+  * * c, by BLAS sgemm
+  *
+  * nda::blas::gemm is only available for double precision, so this wraps the
+  * Fortran routine directly, for matrices given by data pointers and strides.
+  *
+  * @param[in] m Number of rows of a and c
+  * @param[in] n Number of columns of b and c
+  * @param[in] k Number of columns of a and rows of b
+  * @param[in] alpha Scalar factor of product
+  * @param[in] a Data of m x k matrix a
+  * @param[in] as Strides of a; one of them must be 1
+  * @param[in] b Data of k x n matrix b
+  * @param[in] bs Strides of b; one of them must be 1
+  * @param[in] beta Scalar factor of output
+  * @param[in,out] c Data of m x n matrix c, with unit stride along rows
+  * @param[in] ldc Stride of c between rows
+  */
+  void gemm_single(long m, long n, long k, float alpha, float const *a, std::array<long, 2> as, float const *b, std::array<long, 2> bs, float beta,
+                   float *c, long ldc);
+
+  /**
+  * @brief Matrix-matrix product of real matrix with real or complex matrix,
+  * written into preallocated output: c = alpha * a * b + beta * c
+  *
+  * @param[in] alpha Scalar factor of product
+  * @param[in] a Real matrix, double precision or (for single precision @p b)
+  * float
+  * @param[in] b Real or complex matrix, in contiguous C layout
+  * @param[in] beta Scalar factor of output
+  * @param[in,out] c Output matrix, in contiguous C layout, with same value type
+  * as @p b
+  *
+  * \note If @p b and @p c are complex, the product is computed as a real
+  * matrix-matrix product on their interleaved real and imaginary parts,
+  * without forming complex copies of @p a.
+  */
+  template <nda::MemoryMatrix A, nda::MemoryMatrix B, nda::MemoryMatrix C>
+  void realgemm(double alpha, A const &a, B const &b, double beta, C &&c) {
+
+    using Sb = std::remove_const_t<nda::get_value_t<B>>;
+
+    if constexpr (nda::is_complex_v<Sb>) {
+
+      using R       = typename Sb::value_type;
+      auto [k, n]   = b.shape();
+      auto [kc, nc] = c.shape();
+      if (b.indexmap().strides() != std::array<long, 2>{n, 1} || c.indexmap().strides() != std::array<long, 2>{nc, 1}) {
+        throw std::runtime_error("Complex arguments of realgemm must be contiguous in C layout.");
+      }
+
+      // View complex matrices as real matrices with twice as many columns
+      auto bd = nda::matrix_const_view<R>(std::array<long, 2>{k, 2 * n}, reinterpret_cast<R const *>(b.data()));
+      auto cd = nda::matrix_view<R>(std::array<long, 2>{kc, 2 * nc}, reinterpret_cast<R *>(c.data()));
+      realgemm(alpha, a, bd, beta, cd);
+
+    } else if constexpr (std::is_same_v<Sb, float>) {
+
+      static_assert(std::is_same_v<std::remove_const_t<nda::get_value_t<A>>, float>, "Real matrix of single precision realgemm must be float.");
+      if (c.indexmap().strides()[1] != 1) throw std::runtime_error("Output of single precision realgemm must have unit stride along rows.");
+      gemm_single(c.extent(0), c.extent(1), a.extent(1), float(alpha), a.data(), a.indexmap().strides(), b.data(), b.indexmap().strides(), float(beta),
+                  c.data(), c.indexmap().strides()[0]);
+
+    } else {
+      nda::blas::gemm(alpha, a, b, beta, c);
+    }
+  }
+
+  inline constexpr long gemm_batch_blas_min = 48; ///< Inner dimension from which gemm_batch calls BLAS
+
+  /**
+  * @brief Batch of matrix-matrix products of small matrices, written into
+  * preallocated output: c(i, _, _) = alpha * a(i, _, _) * b(i, _, _) + beta *
+  * c(i, _, _) for each i
+  *
+  * @param[in] alpha Scalar factor of products
+  * @param[in] a Batch of matrices, with shape (# batch, m, k)
+  * @param[in] b Batch of matrices, with shape (# batch, k, n)
+  * @param[in] beta Scalar factor of output
+  * @param[in,out] c Batch of output matrices, with shape (# batch, m, n)
+  *
+  * \note The arrays may have arbitrary strides. For the small matrix sizes
+  * typical of orbital indices, the products are computed by a loop kernel
+  * which streams through rows of @p b and @p c, avoiding the per-call overhead
+  * of BLAS; for inner dimension at least gemm_batch_blas_min, and double
+  * precision arrays of equal value type with unit stride in the last
+  * dimension, BLAS gemm is called for each matrix in the batch.
+  */
+  template <nda::MemoryArrayOfRank<3> A, nda::MemoryArrayOfRank<3> B, nda::MemoryArrayOfRank<3> C>
+  void gemm_batch(double alpha, A const &a, B const &b, double beta, C &&c) {
+
+    auto [nb, m, k] = a.shape();
+    long n          = b.extent(2);
+    if (b.extent(0) != nb || b.extent(1) != k || c.extent(0) != nb || c.extent(1) != m || c.extent(2) != n) {
+      throw std::runtime_error("Incompatible array dimensions in gemm_batch.");
+    }
+
+    using Sa = std::remove_const_t<nda::get_value_t<A>>;
+    using Sb = std::remove_const_t<nda::get_value_t<B>>;
+    using Sc = nda::get_value_t<C>;
+
+    auto [as0, as1, as2] = a.indexmap().strides();
+    auto [bs0, bs1, bs2] = b.indexmap().strides();
+    auto [cs0, cs1, cs2] = c.indexmap().strides();
+
+    if constexpr (std::is_same_v<Sa, Sc> && std::is_same_v<Sb, Sc> && !is_single_v<Sc>) {
+      if (k >= gemm_batch_blas_min && as2 == 1 && bs2 == 1 && cs2 == 1) {
+        auto _ = nda::range::all;
+        for (long i = 0; i < nb; ++i) { nda::blas::gemm(alpha, a(i, _, _), b(i, _, _), beta, c(i, _, _)); }
+        return;
+      }
+    }
+
+    // Row-oriented kernel: each row of c is accumulated from rows of b, with
+    // the column strides of b and c passed as compile-time constants in the
+    // common unit-stride case so that the inner loop vectorizes
+    auto kernel = [&](auto bsj, auto csj) {
+      for (long i = 0; i < nb; ++i) {
+        Sa const *ai = a.data() + i * as0;
+        Sb const *bi = b.data() + i * bs0;
+        Sc *ci       = c.data() + i * cs0;
+        for (long p = 0; p < m; ++p) {
+          Sc *cp = ci + p * cs1;
+          if (beta == 0) {
+            for (long j = 0; j < n; ++j) { cp[j * csj] = 0; }
+          } else if (beta != 1) {
+            for (long j = 0; j < n; ++j) { cp[j * csj] *= beta; }
+          }
+          for (long q = 0; q < k; ++q) {
+            auto apq     = static_cast<Sa>(alpha) * ai[p * as1 + q * as2];
+            Sb const *bq = bi + q * bs1;
+            for (long j = 0; j < n; ++j) { cp[j * csj] += apq * bq[j * bsj]; }
+          }
+        }
+      }
+    };
+
+    if (bs2 == 1 && cs2 == 1) {
+      kernel(std::integral_constant<long, 1>{}, std::integral_constant<long, 1>{});
+    } else {
+      kernel(bs2, cs2);
+    }
+  }
+
+  /**
+  * @class init_flag
+  * @brief Flag for thread-safe one-time initialization
+  *
+  * This plays the role of std::once_flag for lazily initialized members of a
+  * class, but unlike std::once_flag it is copyable, so that the enclosing class
+  * keeps its value semantics: a copy of a flag records whether the original
+  * had been set.
+  *
+  * \note Copying an object while another thread is initializing it is not
+  * supported.
+  */
+  class init_flag {
+
+    public:
+    init_flag() = default;
+    init_flag(init_flag const &other) : done(other.done.load(std::memory_order_acquire)) {}
+    init_flag &operator=(init_flag const &other) {
+      done.store(other.done.load(std::memory_order_acquire), std::memory_order_release);
+      return *this;
+    }
+
+    /**
+    * @brief Call @p f if the flag has not been set, and set it
+    *
+    * Concurrent callers block until the first one has finished; @p f is called
+    * exactly once unless it throws, in which case the flag remains unset.
+    */
+    template <typename F> void call_once(F &&f) {
+      if (done.load(std::memory_order_acquire)) { return; }
+      std::lock_guard<std::mutex> lock(mtx);
+      if (!done.load(std::memory_order_relaxed)) {
+        f();
+        done.store(true, std::memory_order_release);
+      }
+    }
+
+    /**
+    * @brief Check whether flag has been set
+    */
+    bool is_set() const { return done.load(std::memory_order_acquire); }
+
+    private:
+    std::atomic<bool> done = false;
+    std::mutex mtx;
+  };
+
+  /**
+  * @class workspace
+  * @brief Reusable scratch storage for allocation-free DLR operations
+  *
+  * A workspace holds a few real and complex buffers of each precision, which
+  * are grown on demand and never shrunk. After a first call of an operation using a workspace, a
+  * subsequent call with arrays of the same or smaller sizes therefore
+  * performs no heap allocation.
+  *
+  * \note A view returned by a workspace remains valid until the next request
+  * of a larger buffer for the same slot and scalar type. A workspace must not
+  * be shared between threads.
+  */
+  class workspace {
+
+    public:
+    static constexpr int nslot = 4; ///< Number of buffers of each scalar type
+
+    /**
+    * @brief Get view of m x n matrix stored in a given buffer
+    *
+    * @tparam S Scalar type (double, dcomplex, float or std::complex<float>)
+    * @tparam Layout Memory layout of matrix (nda::C_layout or nda::F_layout)
+    * @param[in] slot Index of buffer
+    * @param[in] m Number of rows
+    * @param[in] n Number of columns
+    *
+    * @return Matrix view; contents are unspecified
+    */
+    template <nda::Scalar S, typename Layout = nda::C_layout> nda::matrix_view<S, Layout> matrix(int slot, long m, long n) {
+
+      auto &b = storage<S>().at(slot);
+      if (b.size() < m * n) { b = nda::vector<S>(m * n); }
+
+      return nda::matrix_view<S, Layout>(std::array<long, 2>{m, n}, b.data());
+    }
+
+    private:
+    std::array<nda::vector<double>, nslot> dbuf;              ///< Real buffers
+    std::array<nda::vector<dcomplex>, nslot> zbuf;            ///< Complex buffers
+    std::array<nda::vector<float>, nslot> sbuf;               ///< Single precision real buffers
+    std::array<nda::vector<std::complex<float>>, nslot> cbuf; ///< Single precision complex buffers
+
+    template <nda::Scalar S> auto &storage() {
+      if constexpr (is_single_v<S> && nda::is_complex_v<S>) {
+        return cbuf;
+      } else if constexpr (is_single_v<S>) {
+        return sbuf;
+      } else if constexpr (nda::is_complex_v<S>) {
+        return zbuf;
+      } else {
+        return dbuf;
+      }
+    }
+  };
+
+  /**
+  * @class lu_single
+  * @brief LU factorization of a real or complex double precision matrix,
+  * computed and stored in single precision
+  *
+  * The factors take half the memory of a double precision factorization, and
+  * are computed at roughly twice the speed. Solves with them are accurate to
+  * single precision (times the condition number), which is sufficient for the
+  * correction steps of mixed-precision iterative refinement.
+  *
+  * @tparam S Scalar type of matrix (double or dcomplex)
+  */
+  template <nda::Scalar S> class lu_single {
+
+    public:
+    using single_t = std::conditional_t<nda::is_complex_v<S>, std::complex<float>, float>; ///< Single precision scalar type
+
+    /**
+    * @brief Constructor for lu_single
+    *
+    * @param[in] a Square matrix to factorize
+    */
+    explicit lu_single(nda::matrix_const_view<S> a);
+
+    lu_single() = default;
+
+    /**
+    * @brief Solve linear system a x = b in place
+    *
+    * @param[in,out] b On input, right hand sides (columns of @p b); on output,
+    * solutions
+    */
+    void solve(nda::matrix_view<S> b) const;
+
+    /**
+    * @brief Get dimension of factorized matrix
+    */
+    long size() const { return lu.extent(0); }
 
-    int maxnde = 100000; // Max nodes in integration tree
-    int maxstk = 1000;   // Max stack size
+    private:
+    nda::matrix<single_t, nda::F_layout> lu; ///< LU factors
+    nda::vector<int> piv;                    ///< LU pivots
+  };
 
-    S sum = 0; // Integral
+  extern template class lu_single<double>;
+  extern template class lu_single<dcomplex>;
 
-    // Initialize stack: there is a stack of interval endpoints associated w/
-    // each node in the integration tree, and a corresponding stack of values
-    // associated w/ each such interval
+  /**
+  * @brief Restarted GMRES with right preconditioning
+  *
+  * Solve the linear system A x = b, given functions applying A and an
+  * approximate inverse M^{-1} of A to a vector. The Krylov basis is
+  * orthogonalized by modified Gram-Schmidt, and the least squares problems are
+  * solved by Givens rotations.
+  *
+  * @tparam S Scalar type (double or dcomplex)
+  * @param[in] apply_a Function taking nda::vector<S> const & and returning
+  * nda::vector<S>, which applies A
+  * @param[in] apply_m Function with the same signature, which applies the
+  * preconditioner M^{-1}
+  * @param[in] b Right hand side
+  * @param[in,out] x On input, initial guess; on output, solution
+  * @param[in] tol Tolerance on relative residual |b - A x| / |b|
+  * @param[in] maxiter Maximum number of iterations (applications of A, not
+  * counting computation of the residual of the initial guess and at restarts)
+  * @param[in] m Restart length (default 30)
+  *
+  * @return Number of iterations and relative residual of returned solution
+  */
+  template <nda::Scalar S, typename FA, typename FM>
+  std::tuple<int, double> gmres(FA const &apply_a, FM const &apply_m, nda::vector_const_view<S> b, nda::vector_view<S> x, double tol, int maxiter,
+                                int m = 30) {
+
+    auto _     = nda::range::all;
+    auto nrm   = [](nda::vector<S> const &v) { return std::sqrt(std::real(nda::blas::dotc(v, v))); };
+    auto cconj = [](S z) -> S {
+      if constexpr (nda::is_complex_v<S>) {
+        return std::conj(z);
+      } else {
+        return z;
+      }
+    };
+    long n     = b.size();
+    double bnr = nrm(nda::vector<S>(b));
 
-    auto endpt = nda::array<double, 2>(maxstk, 2); // Stack of interval endpoints
-    auto sums  = nda::array<S, 1>(maxstk);         // Stack of sums associated w/ each interval
+    if (bnr == 0) {
+      x = 0;
+      return {0, 0.0};
+    }
 
-    int istk = 0; // Stack pointer
-    int nnde = 1; // Number of nodes in integration tree
+    auto v  = nda::matrix<S>(m + 1, n); // Krylov basis, stored by rows
+    auto hh = nda::matrix<S>(m + 1, m); // Hessenberg matrix, reduced to triangular form by Givens rotations
+    auto cs = nda::vector<double>(m);   // Givens rotation cosines
+    auto sn = nda::vector<S>(m);        // Givens rotation sines
+    auto e  = nda::vector<S>(m + 1);    // Rotated right hand side of least squares problem
+    auto y  = nda::vector<S>(m);
+
+    auto res     = nda::vector<S>(b - apply_a(nda::vector<S>(x)));
+    double resnr = nrm(res);
+    int niter    = 0;
+
+    while (resnr / bnr > tol && niter < maxiter) {
+
+      v(0, _) = res / resnr;
+      e       = 0;
+      e(0)    = resnr;
+
+      // Arnoldi process
+      int k = 0;
+      while (k < m && niter < maxiter) {
+        auto w = apply_a(apply_m(nda::vector<S>(v(k, _))));
+        for (int i = 0; i <= k; ++i) {
+          hh(i, k) = nda::blas::dotc(v(i, _), w);
+          w -= hh(i, k) * v(i, _);
+        }
+        double wnr   = nrm(w);
+        hh(k + 1, k) = wnr;
+        if (wnr > 0) { v(k + 1, _) = w / wnr; }
+
+        // Apply previous rotations to new column, and compute new rotation
+        for (int i = 0; i < k; ++i) {
+          S tmp        = cs(i) * hh(i, k) + sn(i) * hh(i + 1, k);
+          hh(i + 1, k) = -cconj(sn(i)) * hh(i, k) + cs(i) * hh(i + 1, k);
+          hh(i, k)     = tmp;
+        }
+        double a = std::abs(hh(k, k)), rr = std::hypot(a, wnr);
+        if (a == 0) {
+          cs(k) = 0;
+          sn(k) = 1;
+        } else {
+          cs(k) = a / rr;
+          sn(k) = hh(k, k) / a * wnr / rr;
+        }
+        hh(k, k)     = cs(k) * hh(k, k) + sn(k) * wnr;
+        hh(k + 1, k) = 0;
+        e(k + 1)     = -cconj(sn(k)) * e(k);
+        e(k)         = cs(k) * e(k);
+
+        ++k;
+        ++niter;
+        if (std::abs(e(k)) / bnr <= tol || wnr == 0) break;
+      }
 
-    endpt(istk, 0) = a; // Root node interval is [a,b]
-    endpt(istk, 1) = b;
+      // Solve triangular least squares system, and update solution
+      for (int i = k - 1; i >= 0; --i) {
+        y(i) = e(i);
+        for (int j = i + 1; j < k; ++j) { y(i) -= hh(i, j) * y(j); }
+        y(i) /= hh(i, i);
+      }
+      auto z = nda::vector<S>(n);
+      z      = 0;
+      for (int i = 0; i < k; ++i) { z += y(i) * v(i, _); }
+      x += apply_m(z);
+
+      // Compute true residual
+      res   = b - apply_a(nda::vector<S>(x));
+      resnr = nrm(res);
+    }
 
-    double h   = (b - a) / 2;                                        // Interval half-width
-    sums(istk) = h * nda::blas::dotc(wgl, f(xgl * h + (a + b) / 2)); // Integral of f on root node interval
+    return {niter, resnr / bnr};
+  }
 
-    double aa = 0, bb = 0, cc = 0; // Interval endpoints, midpoint
-    S sum1 = 0, sum2 = 0;          // Integrals on subintervals
+  namespace detail {
+
+    /**
+    * @brief Serial adaptive Gauss-Legendre quadrature of a batched
+    * vector-valued integrand; see adapgl_batch
+    *
+    * The integration tree is traversed level by level: the nodes of both
+    * halves of every interval which has not yet converged are gathered into a
+    * single call of the integrand. The intervals of the current level and
+    * their integrals are stored in growable arrays.
+    */
+    template <typename S, typename F>
+    nda::vector<S> adapgl_batch_serial(F &f, double a, double b, double tol, nda::vector_const_view<double> xgl,
+                                       nda::vector_const_view<double> wgl, long max_nodes) {
+
+      long ngl  = xgl.size();
+      long nnde = 1; // Number of nodes in integration tree
+
+      // Integral of f on root interval [a,b]
+      double h = (b - a) / 2;
+      auto fx  = nda::matrix<S>(f(nda::vector<double>(xgl * h + (a + b) / 2)));
+      long nc  = fx.extent(1); // Number of components of integrand
+      if (fx.extent(0) != ngl) throw std::runtime_error("Integrand must return one row per evaluation point.");
+
+      auto sum = nda::vector<S>(nc); // Integral
+      sum      = 0;
+
+      // Intervals of current level of integration tree, and integrals of f on
+      // each of them
+      auto endpt = std::vector<double>{a, b};
+      auto sums  = std::vector<S>(nc);
+      for (long k = 0; k < ngl; ++k) {
+        for (long c = 0; c < nc; ++c) { sums[c] += wgl(k) * fx(k, c); }
+      }
+      for (long c = 0; c < nc; ++c) { sums[c] *= h; }
 
-    // Main loop
-    while (true) {
+      auto endpt_next = std::vector<double>();
+      auto sums_next  = std::vector<S>();
+      auto x          = nda::vector<double>();
+      auto hs         = std::vector<S>(); // Integrals on subintervals
 
-      aa = endpt(istk, 0); // Get interval endpoints
-      bb = endpt(istk, 1);
-      cc = (aa + bb) / 2; // Get midpoint
+      while (!endpt.empty()) {
 
-      // Get integral on each subinterval
-      h    = (cc - aa) / 2;
-      sum1 = h * nda::blas::dotc(wgl, f(xgl * h + (aa + cc) / 2));
-      sum2 = h * nda::blas::dotc(wgl, f(xgl * h + (cc + bb) / 2));
+        long nint = endpt.size() / 2; // Number of intervals on current level
 
-      // If error on subintervals is less than tolerance, add to integral and
-      // move to next node
+        // Nodes on both halves of each interval
+        x.resize(2 * nint * ngl);
+        for (long i = 0; i < nint; ++i) {
+          double aa = endpt[2 * i], bb = endpt[2 * i + 1], cc = (aa + bb) / 2;
+          if (!(aa < cc && cc < bb)) throw std::runtime_error("Adaptive quadrature failed to converge: subinterval width underflow.");
 
-      if (std::abs(sum1 + sum2 - sums(istk)) < tol) {
-        sum += sum1 + sum2;           // Add to subintervals to integral
-        istk--;                       // Remove current interval from stack
-        if (istk < 0) { return sum; } // If stack is empty, return integral
-      } else {                        // Integral on current interval not converged
+          x(nda::range(2 * i * ngl, (2 * i + 1) * ngl))       = xgl * ((cc - aa) / 2) + (aa + cc) / 2;
+          x(nda::range((2 * i + 1) * ngl, (2 * i + 2) * ngl)) = xgl * ((bb - cc) / 2) + (cc + bb) / 2;
+        }
 
-        // Remove current interval from stack, and add subintervals
-        endpt(istk, 1)     = cc;
-        endpt(istk + 1, 0) = cc;
-        endpt(istk + 1, 1) = bb;
-        sums(istk)         = sum1;
-        sums(istk + 1)     = sum2;
+        // Evaluate integrand at all nodes at once
+        fx = nda::matrix<S>(f(x));
+        if (fx.extent(0) != x.size() || fx.extent(1) != nc) throw std::runtime_error("Integrand must return one row per evaluation point.");
+
+        // Integrals on subintervals
+        hs.assign(2 * nint * nc, 0);
+        for (long j = 0; j < 2 * nint; ++j) {
+          h = (endpt[2 * (j / 2) + 1] - endpt[2 * (j / 2)]) / 4;
+          for (long k = 0; k < ngl; ++k) {
+            for (long c = 0; c < nc; ++c) { hs[j * nc + c] += wgl(k) * fx(j * ngl + k, c); }
+          }
+          for (long c = 0; c < nc; ++c) { hs[j * nc + c] *= h; }
+        }
 
-        istk++;
-        nnde += 2;
+        // If error on subintervals is less than tolerance, add to integral;
+        // otherwise, replace interval by its subintervals on next level
+        endpt_next.clear();
+        sums_next.clear();
+        for (long i = 0; i < nint; ++i) {
+          double err = 0;
+          for (long c = 0; c < nc; ++c) { err = std::max(err, std::abs(hs[2 * i * nc + c] + hs[(2 * i + 1) * nc + c] - sums[i * nc + c])); }
+
+          if (err < tol) {
+            for (long c = 0; c < nc; ++c) { sum(c) += hs[2 * i * nc + c] + hs[(2 * i + 1) * nc + c]; }
+          } else {
+            double aa = endpt[2 * i], bb = endpt[2 * i + 1], cc = (aa + bb) / 2;
+            endpt_next.insert(endpt_next.end(), {aa, cc, cc, bb});
+            sums_next.insert(sums_next.end(), hs.begin() + 2 * i * nc, hs.begin() + (2 * i + 2) * nc);
+
+            nnde += 2;
+            if (nnde > max_nodes) { throw std::runtime_error("integration tree too large"); }
+          }
+        }
 
-        if (istk > maxstk) { throw std::runtime_error("integration stack too large"); }
-        if (nnde > maxnde) { throw std::runtime_error("integration tree too large"); }
+        std::swap(endpt, endpt_next);
+        std::swap(sums, sums_next);
       }
+
+      return sum;
+    }
+
+  } // namespace detail
+
+  /**
+  * @brief Adaptive Gauss-Legendre quadrature of a batched vector-valued
+  * integrand
+  *
+  * Same method as adapgl, with local error estimation, for an integrand with
+  * several components (e.g. orbital components): an interval is accepted once
+  * the error estimate of every component is below @p tol. All intervals of a
+  * level of the integration tree are treated together, and the integrand is
+  * called once per level, with the nodes of all of them. The integration tree
+  * is stored in growable arrays, and its size is limited only by
+  * @p max_nodes.
+  *
+  * @param[in] f  Integrand; called as f(x) with a vector x of evaluation
+  * points, and must return a matrix of shape (x.size(), # components)
+  * @param[in] a  Lower integration limit
+  * @param[in] b  Upper integration limit
+  * @param[in] tol  Absolute error tolerance
+  * @param[in] xgl Gauss-Legendre nodes
+  * @param[in] wgl Gauss-Legendre weights
+  * @param[in] nthreads Number of threads (default = 1). If greater than 1,
+  * [a,b] is split into @p nthreads equal subintervals, which are integrated
+  * with tolerance @p tol / @p nthreads each; they are integrated concurrently
+  * if cppdlr is built with OpenMP, and one after the other otherwise. The
+  * split is the same in both cases, so the result depends on @p nthreads but
+  * not on whether OpenMP is used
+  * @param[in] max_nodes Maximum number of nodes in the integration tree
+  * (default = 100000), shared equally by the subintervals if @p nthreads is
+  * greater than 1; a std::runtime_error is thrown if it is exceeded
+  *
+  * @return Integral of each component of \p f from \p a to \p b
+  *
+  * \note If @p nthreads is greater than 1, @p f must be safe to call
+  * concurrently.
+  */
+  template <typename S, typename F>
+  nda::vector<S> adapgl_batch(F &&f, double a, double b, double tol, nda::vector_const_view<double> xgl, nda::vector_const_view<double> wgl,
+                              int nthreads = 1, long max_nodes = 100000) {
+
+    if (nthreads <= 1) { return detail::adapgl_batch_serial<S>(f, a, b, tol, xgl, wgl, max_nodes); }
+
+    auto parts = std::vector<nda::vector<S>>(nthreads);
+    auto err   = std::vector<std::exception_ptr>(nthreads);
+    double h   = (b - a) / nthreads;
+
+#ifdef CPPDLR_USE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#endif
+    for (int p = 0; p < nthreads; ++p) {
+      try {
+        parts[p] = detail::adapgl_batch_serial<S>(f, a + p * h, (p + 1 == nthreads ? b : a + (p + 1) * h), tol / nthreads, xgl, wgl,
+                                                  max_nodes / nthreads);
+      } catch (...) { err[p] = std::current_exception(); }
     }
+
+    for (auto const &e : err) {
+      if (e) { std::rethrow_exception(e); }
+    }
+
+    auto sum = nda::vector<S>(parts[0]);
+    for (int p = 1; p < nthreads; ++p) { sum += parts[p]; }
+
+    return sum;
+  }
+
+  /**
+  * @brief Quick and dirty adaptive Gauss quadrature
+  *
+  * This function implements adaptive Gauss-Legendre quadrature with local error
+  * estimation only.
+  * 
+  * @param[in] f  Function to be integrated
+  * @param[in] a  Lower integration limit
+  * @param[in] b  Upper integration limit
+  * @param[in] tol  Absolute error tolerance
+  * @param[in] xgl Gauss-Legendre nodes
+  * @param[in] wgl Gauss-Legendre weights
+  * @param[in] max_nodes Maximum number of nodes in the integration tree
+  * (default = 100000); a std::runtime_error is thrown if it is exceeded
+  *
+  * @return Integral of \p f from \p a to \p b
+  *
+  * \note This is a quick and dirty adaptive integration function, which tries
+  * to achieve an error tolerance \p tol but doesn't guarantee it. A more robust
+  * implementation would use global error estimation. Nevertheless, this works
+  * quite well most of the time.
+  *
+  * \note The integral is computed by adapgl_batch, so @p f is called with the
+  * nodes of many subintervals at once.
+  */
+
+  template <typename S>
+  // TODO: require S is scalar
+  S adapgl(std::function<nda::array<S, 1>(nda::array<double, 1>)> f, double a, double b, double tol, nda::vector<double> xgl,
+           nda::vector<double> wgl, long max_nodes = 100000) {
+
+    auto fb = [&f](nda::vector<double> const &x) {
+      auto fmat                = nda::matrix<S>(x.size(), 1);
+      fmat(nda::range::all, 0) = f(nda::array<double, 1>(x));
+      return fmat;
+    };
+
+    return adapgl_batch<S>(fb, a, b, tol, xgl, wgl, 1, max_nodes)(0);
   }
 
   /**
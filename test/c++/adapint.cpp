@@ -111,3 +111,77 @@ TEST(adapinterp, semicirc) {
   // Compare with exact result
   EXPECT_NEAR(intgrl, std::numbers::pi / 2, tol);
 }
+
+/**
+* @brief Test batched adaptive Gauss quadrature for vector-valued function,
+* serial and split across threads.
+*/
+TEST(adapinterp, adapgl_batch) {
+
+  int n      = 16;      // Quadrature order
+  double tol = 1.0e-14; // Absolute tolerance
+  int nc     = 5;       // Number of components
+
+  // Define integrand: component c is cos((c + 1) * x) + sqrt(x)
+  double a = 0.0, b = 1.0;
+  int ncalls = 0;
+  auto f     = [nc, &ncalls](nda::vector<double> const &x) {
+    ++ncalls;
+    auto fx = nda::matrix<double>(x.size(), nc);
+    for (int i = 0; i < x.size(); ++i) {
+      for (int c = 0; c < nc; ++c) { fx(i, c) = cos((c + 1) * x(i)) + sqrt(x(i)); }
+    }
+    return fx;
+  };
+
+  // Gauss-Legendre nodes and weights
+  auto [xgl, wgl] = gaussquad(n);
+
+  // Compute integral and compare with exact result
+  auto intgrl = adapgl_batch<double>(f, a, b, tol, xgl, wgl);
+  for (int c = 0; c < nc; ++c) { EXPECT_NEAR(intgrl(c), sin(c + 1.0) / (c + 1) + 2.0 / 3, 10 * tol); }
+
+  // Integrand is called once per level of the integration tree
+  EXPECT_LT(ncalls, 64);
+
+  // Split across threads
+  auto g = [nc](nda::vector<double> const &x) {
+    auto fx = nda::matrix<double>(x.size(), nc);
+    for (int i = 0; i < x.size(); ++i) {
+      for (int c = 0; c < nc; ++c) { fx(i, c) = cos((c + 1) * x(i)) + sqrt(x(i)); }
+    }
+    return fx;
+  };
+  auto intgrl3 = adapgl_batch<double>(g, a, b, tol, xgl, wgl, 3);
+  for (int c = 0; c < nc; ++c) { EXPECT_NEAR(intgrl3(c), sin(c + 1.0) / (c + 1) + 2.0 / 3, 10 * tol); }
+}
+
+/**
+* @brief Test that adaptive Gauss quadrature throws if the integration tree
+* exceeds the maximum number of nodes.
+*/
+TEST(adapinterp, max_nodes) {
+
+  int n = 16; // Quadrature order
+
+  // Discontinuous integrand: tolerance cannot be reached near x = 1/3
+  auto f = [](nda::array<double, 1> x) -> nda::array<double, 1> {
+    auto fx = nda::array<double, 1>(x.size());
+    for (int i = 0; i < x.size(); ++i) { fx(i) = (x(i) < 1.0 / 3 ? 0.0 : 1.0); }
+    return fx;
+  };
+
+  auto [xgl, wgl] = gaussquad(n);
+
+  // Converges with default limit, fails with small limit
+  EXPECT_NEAR(adapgl<double>(f, 0.0, 1.0, 1e-8, xgl, wgl), 2.0 / 3, 1e-6);
+  EXPECT_THROW(adapgl<double>(f, 0.0, 1.0, 1e-8, xgl, wgl, 20), std::runtime_error);
+
+  // Tolerance below roundoff: tree grows until the default limit is exceeded
+  auto g = [](nda::vector<double> const &x) {
+    auto gx = nda::matrix<double>(x.size(), 1);
+    for (int i = 0; i < x.size(); ++i) { gx(i, 0) = (x(i) < 1.0 / 3 ? 0.0 : 1.0) + 1e3 * sin(x(i)); }
+    return gx;
+  };
+  EXPECT_THROW(adapgl_batch<double>(g, 0.0, 1.0, 1e-20, xgl, wgl), std::runtime_error);
+}
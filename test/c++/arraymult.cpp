@@ -164,3 +164,63 @@ TEST(arraymult, vector_array) {
   auto c = arraymult(a, b);
   EXPECT_LT(max_element(abs(ctrue - c)), 1e-14);
 }
+
+/**
+ * Test gemm_batch function: small and large matrices, real and complex, with
+ * strided input and output
+ */
+TEST(arraymult, gemm_batch) {
+
+  auto _ = nda::range::all;
+
+  int nb = 7;
+
+  for (int norb : {5, 60}) { // Loop kernel and BLAS paths
+
+    auto a  = nda::array<double, 3>(nb, norb, norb);
+    auto b  = nda::array<dcomplex, 3>(nb, norb, norb);
+    auto bb = nda::array<dcomplex, 3>(nb, norb, 2 * norb); // Storage for strided views
+    auto c  = nda::array<dcomplex, 3>(nb, norb, 2 * norb);
+    for (int i = 0; i < nb; ++i) {
+      for (int j = 0; j < norb; ++j) {
+        for (int k = 0; k < norb; ++k) {
+          a(i, j, k) = sin(10000.0 * (i + j + k));
+          b(i, j, k) = dcomplex(sin(1000.0 * (i + j + k)), cos(1000.0 * (i + j + k)));
+        }
+      }
+    }
+    bb(_, _, nda::range(0, 2 * norb, 2)) = b;
+
+    // Get correct answer
+    auto ctrue = nda::array<dcomplex, 3>(nb, norb, norb);
+    ctrue = 0;
+    for (int i = 0; i < nb; ++i) {
+      for (int j = 0; j < norb; ++j) {
+        for (int k = 0; k < norb; ++k) {
+          for (int l = 0; l < norb; ++l) { ctrue(i, j, k) += a(i, j, l) * b(i, l, k); }
+        }
+      }
+    }
+
+    // Real times complex, contiguous
+    auto c1 = nda::array<dcomplex, 3>(nb, norb, norb);
+    gemm_batch(1.0, a, b, 0.0, c1);
+    EXPECT_LT(max_element(abs(ctrue - c1)), 1e-12);
+
+    // Complex times complex, contiguous (BLAS for large matrices)
+    auto bz = nda::array<dcomplex, 3>(a * dcomplex(1.0));
+    gemm_batch(1.0, bz, b, 0.0, c1);
+    EXPECT_LT(max_element(abs(ctrue - c1)), 1e-12);
+
+    // Complex times complex, strided, accumulating into strided output
+    auto cv = c(_, _, nda::range(1, 2 * norb, 2));
+    cv      = 1.0;
+    gemm_batch(2.0, bz, bb(_, _, nda::range(0, 2 * norb, 2)), 0.5, cv);
+    EXPECT_LT(max_element(abs(2.0 * ctrue + 0.5 - cv)), 1e-12);
+  }
+
+  // Incompatible dimensions
+  auto x = nda::array<double, 3>(2, 3, 4);
+  auto y = nda::array<double, 3>(2, 3, 4);
+  EXPECT_THROW(gemm_batch(1.0, x, y, 0.0, x), std::runtime_error);
+}
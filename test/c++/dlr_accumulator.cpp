@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_accumulator.cpp
+*
+* @brief Tests for imtime_accumulator class.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test that accumulating a Green's function in the span of the DLR basis
+* as a quadrature-weighted sum of delta functions recovers its DLR
+* coefficients, for single samples, batches, and merged accumulators
+*/
+TEST(imtime_accumulator, quadrature) {
+
+  double lambda = 10;    // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 10;    // Inverse temperature
+
+  int nquad = 100; // # Gauss-Legendre quadrature nodes
+  int norb  = 2;   // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Random DLR coefficients of matrix-valued G with unit scale
+  auto gc = nda::array<dcomplex, 3>(r, norb, norb);
+  for (int k = 0; k < r; ++k) { gc(k, _, _) = nda::rand(norb, norb) - 0.5 + 1i * (nda::rand(norb, norb) - 0.5); }
+
+  // Gauss-Legendre quadrature on [0, 1] mapped to relative format, and
+  // samples w_i = beta * wq_i * G(t_i), which integrate like G
+  auto [xgl, wgl] = gaussquad(nquad);
+  auto t          = abs2rel(nda::vector<double>((xgl + 1) / 2));
+  auto w          = itops.coefs2eval(gc, t);
+  for (int i = 0; i < nquad; ++i) { w(i, _, _) *= beta * wgl(i) / 2; }
+
+  // Batched accumulation
+  auto acc = imtime_accumulator<dcomplex, 3>(itops, {norb, norb});
+  acc.accumulate(t, w);
+  EXPECT_EQ(acc.nsamples(), nquad);
+  EXPECT_LT(max_element(abs(acc.coefs(beta) - gc)), 1e-8);
+
+  // Sample-by-sample accumulation into two accumulators, then merge
+  auto acc1 = imtime_accumulator<dcomplex, 3>(itops, {norb, norb});
+  auto acc2 = imtime_accumulator<dcomplex, 3>(itops, {norb, norb});
+  for (int i = 0; i < nquad; ++i) { (i % 2 == 0 ? acc1 : acc2).accumulate(t(i), w(i, _, _)); }
+  acc1 += acc2;
+  EXPECT_EQ(acc1.nsamples(), nquad);
+  EXPECT_LT(max_element(abs(acc1.data() - acc.data())), 1e-12);
+
+  // Scalar-valued G
+  auto acc_s = imtime_accumulator(itops);
+  for (int i = 0; i < nquad; ++i) { acc_s.accumulate(t(i), real(w(i, 0, 1))); }
+  EXPECT_LT(max_element(abs(acc_s.coefs(beta) - real(gc(_, 0, 1)))), 1e-8);
+
+  acc.reset();
+  EXPECT_EQ(acc.nsamples(), 0);
+  EXPECT_EQ(max_element(abs(acc.data())), 0);
+}
+
+/**
+* @brief Test accuracy of accumulated DLR expansion at large DLR cutoff and
+* small tolerance, for which the Gram matrix of the DLR basis is severely
+* ill-conditioned
+*/
+TEST(imtime_accumulator, quadrature_large_lambda) {
+
+  double lambda = 1e4;   // DLR cutoff
+  double eps    = 1e-12; // DLR tolerance
+  double beta   = 1e4;   // Inverse temperature
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  auto dlr_it = itops.get_itnodes();
+  int r       = itops.rank();
+
+  // G is a sum of exponentials, with frequencies spread over [-lambda, lambda]
+  auto om = nda::vector<double>{-0.9 * lambda, -37.0, -0.5, 0.0, 1.3, 420.0, 0.99 * lambda};
+  auto gf = [&om](double t) {
+    double g = 0;
+    for (int j = 0; j < om.size(); ++j) { g += k_it(t, om(j)) / (j + 1); }
+    return g;
+  };
+
+  // Samples at nodes of a composite Gauss-Legendre quadrature which resolves
+  // products of DLR basis functions, with weights beta * wq_i * G(t_i)
+  auto fine     = fineparams(2 * lambda, 32);
+  auto [tq, wq] = build_it_fine(fine); // Square root quadrature weights
+  auto acc      = imtime_accumulator(itops);
+  for (int i = 0; i < tq.size(); ++i) { acc.accumulate(tq(i), beta * wq(i) * wq(i) * gf(tq(i))); }
+
+  // Compare values of projection at DLR nodes with values of G
+  auto g    = itops.coefs2vals(acc.coefs(beta));
+  auto gtru = nda::vector<double>(r);
+  for (int i = 0; i < r; ++i) { gtru(i) = gf(dlr_it(i)); }
+  EXPECT_LT(max_element(abs(g - gtru)), 1e-10 * max_element(abs(gtru)));
+}
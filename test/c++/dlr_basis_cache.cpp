@@ -0,0 +1,75 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_basis_cache.cpp
+*
+* @brief Tests for dlr_basis_cache class.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+#include <filesystem>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test that a basis obtained from the cache is identical to a freshly
+* built one, both on a cache miss and on a cache hit
+*/
+TEST(dlr_basis_cache, get) {
+
+  double lambda  = 1000;                   // DLR cutoff
+  double eps     = 1e-10;                  // DLR tolerance
+  auto statistic = Fermion;                // Fermionic Green's function
+  auto cachedir  = "data_dlr_basis_cache"; // Cache directory
+
+  std::filesystem::remove_all(cachedir);
+  auto cache = dlr_basis_cache(cachedir);
+
+  // Reference basis
+  auto dlr_rf = build_dlr_rf(lambda, eps, SYM);
+  auto itops  = imtime_ops(lambda, dlr_rf, SYM);
+  auto ifops  = imfreq_ops(lambda, dlr_rf, statistic, SYM);
+
+  // Cache miss: basis is built and stored
+  EXPECT_FALSE(cache.contains(lambda, eps, SYM, statistic));
+  auto e1 = cache.get(lambda, eps, SYM, statistic);
+  EXPECT_TRUE(cache.contains(lambda, eps, SYM, statistic));
+
+  // Cache hit: basis is read from file
+  auto e2 = cache.get(lambda, eps, SYM, statistic);
+
+  for (auto const &e : {e1, e2}) {
+    EXPECT_EQ_ARRAY(e.dlr_rf, dlr_rf);
+    EXPECT_EQ(e.itops.rank(), itops.rank());
+    EXPECT_EQ_ARRAY(e.itops.get_itnodes(), itops.get_itnodes());
+    EXPECT_EQ_ARRAY(e.itops.get_cf2it(), itops.get_cf2it());
+    EXPECT_EQ_ARRAY(e.itops.get_it2cf_lu(), itops.get_it2cf_lu());
+    EXPECT_EQ_ARRAY(e.ifops.get_ifnodes(), ifops.get_ifnodes());
+    EXPECT_EQ_ARRAY(e.ifops.get_cf2if(), ifops.get_cf2if());
+  }
+
+  // Different parameters map to different entries
+  EXPECT_NE(cache.filename(lambda, eps, SYM, Fermion), cache.filename(lambda, eps, SYM, Boson));
+  EXPECT_NE(cache.filename(lambda, eps, SYM, Fermion), cache.filename(lambda, eps, NONSYM, Fermion));
+  EXPECT_NE(cache.filename(lambda, eps, SYM, Fermion), cache.filename(lambda, 1.01 * eps, SYM, Fermion));
+  EXPECT_FALSE(cache.contains(lambda, eps, SYM, Boson));
+}
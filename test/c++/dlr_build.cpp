@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 #include <cppdlr/dlr_build.hpp>
 #include <cppdlr/dlr_kernels.hpp>
+#include <cppdlr/dlr_imtime.hpp>
+#include <cppdlr/dlr_imfreq.hpp>
 #include <fmt/format.h>
 
 using namespace cppdlr;
@@ -60,3 +62,102 @@ TEST(dlr_build, get_kfine) {
 
   std::cout << fmt::format("Max imag time err = {:e}, Max freq err = {:e}\n", errt, errom);
 }
+
+/** 
+* @brief Test that kernel matrices and DLR frequencies do not depend on the
+* number of threads used to build them
+*/
+TEST(dlr_build, build_threads) {
+
+  double lambda = 1000;
+  double eps    = 1e-10;
+
+  fineparams fine(lambda);
+
+  auto [t, w] = build_it_fine(fine);
+  auto om     = build_rf_fine(fine);
+
+  // Serial reference
+  set_build_threads(1);
+  EXPECT_EQ(get_build_threads(), 1);
+
+  auto kmat1           = build_k_it(t, w, om);
+  auto kvec1           = build_k_it(t, w, om(3));
+  auto kif1            = build_k_if(fine.nmax, om, Fermion);
+  auto [errt1, errom1] = geterr_k_it(fine, t, om, build_k_it(t, om));
+  auto dlr_rf1         = build_dlr_rf(lambda, eps);
+
+  // Default (parallel if compiled with OpenMP)
+  set_build_threads(0);
+  EXPECT_GE(get_build_threads(), 1);
+
+  EXPECT_EQ(max_element(abs(build_k_it(t, w, om) - kmat1)), 0);
+  EXPECT_EQ(max_element(abs(build_k_it(t, w, om(3)) - kvec1)), 0);
+  EXPECT_EQ(max_element(abs(build_k_if(fine.nmax, om, Fermion) - kif1)), 0);
+
+  auto [errt2, errom2] = geterr_k_it(fine, t, om, build_k_it(t, om));
+  EXPECT_EQ(errt1, errt2);
+  EXPECT_EQ(errom1, errom2);
+
+  EXPECT_EQ(max_element(abs(build_dlr_rf(lambda, eps) - dlr_rf1)), 0);
+
+  EXPECT_THROW(set_build_threads(-1), std::runtime_error);
+}
+
+/**
+* @brief Test extension of DLR basis to larger cutoff and smaller tolerance,
+* together with the imtime_ops and imfreq_ops objects built on it
+*/
+TEST(dlr_build, build_dlr_rf_extend) {
+
+  double lambda0 = 100;   // Previous DLR cutoff
+  double eps0    = 1e-8;  // Previous DLR tolerance
+  double lambda  = 200;   // Extended DLR cutoff
+  double eps     = 1e-10; // Extended DLR tolerance
+
+  auto dlr_rf0 = build_dlr_rf(lambda0, eps0);
+  int r0       = dlr_rf0.size();
+
+  // Extended basis keeps previous frequencies first, and is nearly as small
+  // as one built from scratch
+  auto dlr_rf = build_dlr_rf_extend(lambda, eps, dlr_rf0);
+  int r       = dlr_rf.size();
+  int rs      = build_dlr_rf(lambda, eps).size();
+  EXPECT_GE(r, rs);
+  EXPECT_LE(r, rs + 3);
+  for (int i = 0; i < r0; ++i) { EXPECT_EQ(dlr_rf(i), dlr_rf0(i)); }
+
+  // Extended imtime_ops object keeps previous nodes first
+  auto itops0 = imtime_ops(lambda0, dlr_rf0);
+  auto itops  = itops0.extend(lambda, dlr_rf);
+  EXPECT_EQ(itops.rank(), r);
+  for (int i = 0; i < r0; ++i) { EXPECT_EQ(itops.get_itnodes(i), itops0.get_itnodes(i)); }
+
+  // Extended basis represents function with frequency beyond previous cutoff
+  double om = 150;
+  auto g    = nda::vector<double>(r);
+  for (int i = 0; i < r; ++i) { g(i) = k_it(itops.get_itnodes(i), om); }
+  auto gc    = itops.vals2coefs(g);
+  auto ttst  = eqptsrel(101);
+  double err = 0;
+  for (int i = 0; i < ttst.size(); ++i) { err = std::max(err, std::abs(itops.coefs2eval(gc, ttst(i)) - k_it(ttst(i), om))); }
+  EXPECT_LT(err, 100 * eps);
+
+  // Coefficients in previous basis map to extended basis by padding with
+  // zeros
+  auto g0 = nda::vector<double>(r0);
+  for (int i = 0; i < r0; ++i) { g0(i) = k_it(itops0.get_itnodes(i), 10.0); }
+  auto gc0 = itops0.vals2coefs(g0);
+  auto gce = extend_coefs(gc0, r);
+  EXPECT_LT(nda::max_element(nda::abs(itops.coefs2vals(gce)(nda::range(r0)) - g0)), 1e-13);
+
+  // Extended imfreq_ops object keeps previous nodes first
+  auto ifops0 = imfreq_ops(lambda0, dlr_rf0, Fermion);
+  auto ifops  = ifops0.extend(lambda, dlr_rf);
+  EXPECT_EQ(ifops.rank(), r);
+  for (int i = 0; i < r0; ++i) { EXPECT_EQ(ifops.get_ifnodes(i), ifops0.get_ifnodes(i)); }
+  EXPECT_LT(nda::max_element(nda::abs(ifops.vals2coefs(ifops.coefs2vals(gc)) - gc)), 1e-10);
+
+  // Previous frequencies must lie within new cutoff
+  EXPECT_THROW(build_dlr_rf_extend(lambda0 / 2, eps, dlr_rf0), std::runtime_error);
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_device.cpp
+*
+* @brief Tests for device (GPU) DLR operations.
+*
+* \note The tests are guarded by NDA_HAVE_CUDA: if nda is compiled without
+* CUDA, this file compiles to an empty test executable, and none of the device
+* code is built or run.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+
+using namespace cppdlr;
+using namespace nda;
+
+#ifdef NDA_HAVE_CUDA
+
+/**
+* @brief Test device transformations, convolution and Dyson solve against the
+* host implementations
+*/
+TEST(dlr_device, imtime_ops_dyson) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 1000;  // Inverse temperature
+  int norb      = 3;     // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  auto itopsd = imtime_ops_device(itops);
+  int r       = itops.rank();
+
+  // Random real matrix-valued G, and complex copy
+  auto gc = nda::array<double, 3>(r, norb, norb);
+  for (int k = 0; k < r; ++k) { gc(k, _, _) = nda::rand(norb, norb) - 0.5; }
+  auto g  = itops.coefs2vals(gc);
+  auto gz = nda::array<dcomplex, 3>(g * dcomplex(1, 1));
+
+  auto g_d  = nda::to_device(g);
+  auto gz_d = nda::to_device(gz);
+
+  EXPECT_LT(max_element(abs(nda::to_host(itopsd.vals2coefs(g_d)) - gc)), 1e-10 * max_element(abs(gc)));
+  EXPECT_LT(max_element(abs(nda::to_host(itopsd.coefs2vals(nda::to_device(gc))) - g)), 1e-13 * max_element(abs(g)));
+  EXPECT_LT(max_element(abs(nda::to_host(itopsd.vals2coefs(gz_d)) - itops.vals2coefs(gz))), 1e-10 * max_element(abs(gc)));
+
+  // Convolution by precomputed convolution matrix
+  auto fconv = itopsd.convmat(beta, Fermion, gc);
+  auto h     = nda::to_host(itopsd.convolve(fconv, g_d));
+  EXPECT_LT(max_element(abs(h - itops.convolve(beta, Fermion, gc, gc))), 1e-10 * max_element(abs(h)));
+
+  // Dyson equation with hermitian Hamiltonian and self-energy given by G
+  auto hmat = nda::matrix<double>(norb, norb);
+  for (int i = 0; i < norb; ++i) {
+    for (int j = 0; j < norb; ++j) { hmat(i, j) = (i == j ? 0.1 * i : 0.2); }
+  }
+  auto dys   = dyson_it(beta, itops, hmat);
+  auto dysd  = dyson_it_device<double>(beta, itopsd, nda::array<double, 3>(free_gf(beta, itops, hmat)));
+  auto sig   = nda::array<double, 3>(0.1 * g);
+  auto gdys  = dys.solve(sig);
+  auto gdysd = nda::to_host(dysd.solve(nda::to_device(sig)));
+  EXPECT_LT(max_element(abs(gdysd - gdys)), 1e-10 * max_element(abs(gdys)));
+}
+
+/**
+* @brief Test device imaginary frequency transformations against the host
+* implementations
+*/
+TEST(dlr_device, imfreq_ops) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  int norb      = 3;     // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto ifops  = imfreq_ops(lambda, dlr_rf, Fermion);
+  auto ifopsd = imfreq_ops_device(ifops);
+  int r       = ifops.rank();
+
+  // Random complex matrix-valued G
+  auto gc = nda::array<dcomplex, 3>(r, norb, norb);
+  for (int k = 0; k < r; ++k) { gc(k, _, _) = (nda::rand(norb, norb) - 0.5) * dcomplex(1, 0.5); }
+  auto g = ifops.coefs2vals(gc);
+
+  EXPECT_LT(max_element(abs(nda::to_host(ifopsd.coefs2vals(nda::to_device(gc))) - g)), 1e-13 * max_element(abs(g)));
+  EXPECT_LT(max_element(abs(nda::to_host(ifopsd.vals2coefs(nda::to_device(g))) - gc)), 1e-10 * max_element(abs(gc)));
+}
+
+#endif // NDA_HAVE_CUDA
@@ -0,0 +1,168 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_fitter.cpp
+*
+* @brief Tests for dlr_fitter class.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test that imaginary time fitter agrees with imtime_ops::fitvals2coefs
+* for noisy real and complex matrix-valued data, and that uniform weights do not
+* change the fit
+*/
+TEST(dlr_fitter, imtime) {
+
+  double lambda = 1000; // DLR cutoff
+  double eps    = 1e-8; // DLR tolerance
+
+  double beta  = 1000; // Inverse temperature
+  int nsample  = 2000; // # imag time sampling points
+  double noise = 1e-6; // Noise level
+
+  int norb = 2; // Orbital dimensions
+
+  // Get DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Sample sum of exponentials at equispaced points and add noise
+  auto t = eqptsrel(nsample);
+  auto g = nda::array<double, 3>(nsample, norb, norb);
+  for (int i = 0; i < nsample; ++i) {
+    for (int a = 0; a < norb; ++a) {
+      for (int b = 0; b < norb; ++b) { g(i, a, b) = k_it(t(i), sin(1000.0 * (a + 2 * b + 1)), beta) + noise * (2 * nda::rand() - 1); }
+    }
+  }
+  auto gz = nda::array<dcomplex, 3>(g + 1i * g);
+
+  auto fitter = dlr_fitter(itops, t);
+  EXPECT_EQ(fitter.size(), nsample);
+  EXPECT_EQ(fitter.rank(), r);
+
+  // Compare against SVD-based fit
+  auto gc = fitter.fit(g);
+  EXPECT_EQ(gc.shape(), (std::array<long, 3>{r, norb, norb}));
+  EXPECT_LT(max_element(abs(gc - itops.fitvals2coefs(t, g))), 1e-10 * max_element(abs(gc)));
+
+  auto gcz = fitter.fit(gz);
+  EXPECT_LT(max_element(abs(gcz - itops.fitvals2coefs(t, gz))), 1e-10 * max_element(abs(gcz)));
+
+  // Uniform weights give same fit
+  auto w       = nda::vector<double>(nsample);
+  w            = 2.0;
+  auto wfitter = dlr_fitter(itops, t, w);
+  EXPECT_LT(max_element(abs(wfitter.fit(g) - gc)), 1e-10 * max_element(abs(gc)));
+}
+
+/**
+* @brief Test that imaginary frequency fitter recovers DLR coefficients from
+* values on a scattered Matsubara frequency grid
+*/
+TEST(dlr_fitter, imfreq) {
+
+  double lambda  = 1000;    // DLR cutoff
+  double eps     = 1e-10;   // DLR tolerance
+  auto statistic = Fermion; // Fermionic Green's function
+
+  double beta = 1000; // Inverse temperature
+  int norb    = 2;    // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto ifops  = imfreq_ops(lambda, dlr_rf, statistic);
+  int r       = ifops.rank();
+
+  // Random DLR coefficients
+  auto gc = nda::array<dcomplex, 3>(r, norb, norb);
+  for (int k = 0; k < r; ++k) { gc(k, _, _) = nda::rand(norb, norb) - 0.5; }
+
+  // Grid: DLR Matsubara frequency nodes plus every tenth frequency up to Lambda
+  auto n = nda::vector<int>(r + 2 * int(lambda / 10));
+  for (int k = 0; k < r; ++k) { n(k) = ifops.get_ifnodes(k); }
+  for (int k = 0; k < int(lambda / 10); ++k) {
+    n(r + 2 * k)     = 10 * k + 1;
+    n(r + 2 * k + 1) = -10 * k - 3;
+  }
+
+  // Values of G on grid
+  auto g = nda::array<dcomplex, 3>(n.size(), norb, norb);
+  for (int i = 0; i < n.size(); ++i) { g(i, _, _) = ifops.coefs2eval(beta, gc, n(i)); }
+
+  auto fitter = dlr_fitter(ifops, n);
+  EXPECT_LT(max_element(abs(fitter.fit(beta, g) - gc)), 1e-8 * max_element(abs(gc)));
+}
+
+/**
+* @brief Test imaginary time fitter with non-uniform weights against a weighted
+* least squares fit by SVD
+*/
+TEST(dlr_fitter, imtime_weighted) {
+
+  double lambda = 1000; // DLR cutoff
+  double eps    = 1e-8; // DLR tolerance
+
+  double beta = 1000; // Inverse temperature
+  int nsample = 500;  // # imag time sampling points
+
+  int norb = 2; // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Sample sum of exponentials at equispaced points, with noise of standard
+  // deviation growing toward tau = beta/2, and weights 1/sigma
+  auto t     = eqptsrel(nsample);
+  auto sigma = nda::vector<double>(nsample);
+  auto g     = nda::array<double, 3>(nsample, norb, norb);
+  for (int i = 0; i < nsample; ++i) {
+    sigma(i) = 1e-6 * (1 + 18 * (0.5 - std::abs(rel2abs(t(i)) - 0.5)));
+    for (int a = 0; a < norb; ++a) {
+      for (int b = 0; b < norb; ++b) { g(i, a, b) = k_it(t(i), sin(1000.0 * (a + 2 * b + 1)), beta) + sigma(i) * (2 * nda::rand() - 1); }
+    }
+  }
+  auto w = nda::vector<double>(1.0 / sigma);
+
+  auto gc = dlr_fitter(itops, t, w).fit(g);
+
+  // Reference: minimize |diag(w) (A gc - g)| with SVD-based solver
+  auto a  = nda::matrix<double, F_layout>(itops.build_evalmat(t));
+  auto gw = nda::matrix<double, F_layout>(nda::reshape(g, nsample, norb * norb));
+  for (int i = 0; i < nsample; ++i) {
+    a(i, _) *= w(i);
+    gw(i, _) *= w(i);
+  }
+  auto s       = nda::vector<double>(r);
+  double rcond = 0;
+  int rank     = 0;
+  nda::lapack::gelss(a, gw, s, rcond, rank);
+  auto gcref = nda::array<double, 3>(nda::reshape(nda::matrix<double>(gw(nda::range(r), _)), r, norb, norb));
+
+  EXPECT_LT(max_element(abs(gc - gcref)), 1e-10 * max_element(abs(gcref)));
+
+  // Weighted fit differs from unweighted fit
+  EXPECT_GT(max_element(abs(gc - dlr_fitter(itops, t).fit(g))), 1e-9 * max_element(abs(gcref)));
+}
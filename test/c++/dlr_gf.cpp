@@ -0,0 +1,121 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_gf.cpp
+*
+* @brief Tests for dlr_gf class.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test evaluation of a block Green's function from its DLR coefficients
+* against evaluation with imtime_ops
+*/
+TEST(dlr_gf, eval) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 1000;  // Inverse temperature
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Two blocks of different sizes with random DLR coefficients
+  auto blocks = std::vector<nda::array<dcomplex, 3>>{nda::array<dcomplex, 3>(r, 2, 2), nda::array<dcomplex, 3>(r, 3, 3)};
+  for (auto &gc : blocks) {
+    for (int k = 0; k < r; ++k) {
+      gc(k, _, _) = nda::rand(gc.shape(1), gc.shape(2)) - 0.5 + 1i * (nda::rand(gc.shape(1), gc.shape(2)) - 0.5);
+    }
+  }
+
+  auto g = dlr_gf<dcomplex>(itops, beta, blocks);
+  EXPECT_EQ(g.nblocks(), 2);
+  EXPECT_EQ(g.rank(), r);
+
+  auto t = eqptsrel(11);
+  for (int b = 0; b < 2; ++b) {
+    auto gt = g(b, t);
+    EXPECT_EQ(max_element(abs(gt - itops.coefs2eval(blocks[b], t))), 0);
+    EXPECT_LT(max_element(abs(g(b, t(3)) - gt(3, _, _))), 1e-14 * max_element(abs(gt)));
+  }
+
+  // First dimension of blocks must be the DLR rank
+  auto bad = std::vector{nda::array<double, 3>(r + 1, 1, 1)};
+  EXPECT_THROW(dlr_gf<double>(itops, beta, bad), std::runtime_error);
+}
+
+/**
+* @brief Test HDF5 write and full/partial read of a block Green's function
+*/
+TEST(dlr_gf, h5_rw) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 100;   // Inverse temperature
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  auto blocks = std::vector<nda::array<double, 3>>{};
+  for (int b = 0; b < 3; ++b) {
+    auto gc = nda::array<double, 3>(r, b + 1, b + 1);
+    for (int k = 0; k < r; ++k) { gc(k, _, _) = nda::rand(b + 1, b + 1) - 0.5; }
+    blocks.push_back(gc);
+  }
+  auto g = dlr_gf<double>(itops, beta, blocks);
+
+  auto filename = "data_dlr_gf_h5_rw.h5";
+  auto name     = "g";
+
+  {
+    h5::file file(filename, 'w');
+    h5::write(file, name, g);
+  }
+
+  // Read all blocks
+  dlr_gf<double> g_ref;
+  {
+    h5::file file(filename, 'r');
+    h5::read(file, name, g_ref);
+  }
+
+  EXPECT_EQ(g_ref.beta(), beta);
+  EXPECT_EQ(g_ref.nblocks(), 3);
+  EXPECT_EQ_ARRAY(g_ref.itops().get_rfnodes(), itops.get_rfnodes());
+  for (int b = 0; b < 3; ++b) { EXPECT_EQ_ARRAY(g_ref.block(b), blocks[b]); }
+
+  // Read single block, and subset of blocks
+  {
+    h5::file file(filename, 'r');
+    EXPECT_EQ_ARRAY(dlr_gf<double>::h5_read_block(file, name, 1), blocks[1]);
+    EXPECT_THROW(dlr_gf<double>::h5_read_block(file, name, 3), std::runtime_error);
+
+    auto g_sub = dlr_gf<double>::h5_read_blocks(file, name, {2, 0});
+    EXPECT_EQ(g_sub.nblocks(), 2);
+    EXPECT_EQ_ARRAY(g_sub.block(0), blocks[2]);
+    EXPECT_EQ_ARRAY(g_sub.block(1), blocks[0]);
+  }
+}
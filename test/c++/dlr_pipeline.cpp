@@ -0,0 +1,112 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_pipeline.cpp
+*
+* @brief Tests for imtime_pipeline class.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test fused pipeline convolve -> reflect -> vals2coefs -> innerprod
+* against the step-by-step imtime_ops operations
+*/
+TEST(imtime_pipeline, chain) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 1000;  // Inverse temperature
+  int norb      = 2;     // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Random DLR coefficients of scalar-valued f and u, and values of
+  // matrix-valued G
+  auto fc = nda::vector<double>(nda::rand(r) - 0.5);
+  auto uc = nda::vector<double>(nda::rand(r) - 0.5);
+  auto g  = nda::array<double, 3>(r, norb, norb);
+  for (int k = 0; k < r; ++k) { g(k, _, _) = nda::rand(norb, norb) - 0.5; }
+
+  // Step-by-step result, for each orbital component
+  auto h = nda::array<double, 3>(r, norb, norb);
+  for (int i = 0; i < norb; ++i) {
+    for (int j = 0; j < norb; ++j) {
+      auto gc    = itops.vals2coefs(nda::vector<double>(g(_, i, j)));
+      h(_, i, j) = itops.vals2coefs(itops.reflect(itops.convolve(beta, Fermion, fc, gc)));
+    }
+  }
+
+  // Fused pipeline
+  auto p = imtime_pipeline<>(itops);
+  p.convolve(beta, Fermion, fc).reflect().vals2coefs();
+  EXPECT_EQ(p.nsteps(), 3);
+  EXPECT_EQ(p.output(), imtime_pipeline<>::COEFS);
+  EXPECT_LT(max_element(abs(p(g) - h)), 1e-10 * beta);
+
+  // Terminate by inner product
+  p.innerprod(uc);
+  EXPECT_EQ(p.output(), imtime_pipeline<>::IP);
+  auto ip = p(g);
+  EXPECT_EQ(ip.shape(0), 1);
+  for (int i = 0; i < norb; ++i) {
+    for (int j = 0; j < norb; ++j) {
+      auto hij = nda::vector<double>(h(_, i, j));
+      EXPECT_LT(std::abs(ip(0, i, j) - itops.innerprod(uc, hij)), 1e-10 * beta);
+    }
+  }
+
+  // No further operations after inner product
+  EXPECT_THROW(p.coefs2vals(), std::runtime_error);
+}
+
+/**
+* @brief Test removal of redundant transformations, and checks of
+* representation
+*/
+TEST(imtime_pipeline, fold) {
+
+  double lambda = 100;   // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  auto g = nda::vector<dcomplex>(nda::rand(r) - 0.5 + 1i * (nda::rand(r) - 0.5));
+
+  // vals2coefs followed by coefs2vals is removed
+  auto p = imtime_pipeline<dcomplex>(itops);
+  p.vals2coefs().coefs2vals().reflect().vals2coefs().coefs2vals();
+  EXPECT_EQ(p.nsteps(), 1);
+  EXPECT_EQ(p.output(), imtime_pipeline<dcomplex>::VALS);
+  EXPECT_LT(max_element(abs(p(g) - itops.reflect(g))), 1e-13);
+
+  // Operations applied to the wrong representation
+  EXPECT_THROW(p.coefs2vals(), std::runtime_error);
+  auto q = imtime_pipeline<dcomplex>(itops, imtime_pipeline<dcomplex>::COEFS);
+  EXPECT_THROW(q.reflect(), std::runtime_error);
+  EXPECT_LT(max_element(abs(q.coefs2vals()(g) - itops.coefs2vals(g))), 1e-13);
+}
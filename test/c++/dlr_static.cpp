@@ -0,0 +1,108 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_static.cpp
+*
+* @brief Tests for static_imtime_ops class and dispatch_rank.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+#include <type_traits>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test fixed-rank transformations and convolutions against imtime_ops
+*/
+TEST(static_imtime_ops, transform_convolve) {
+
+  double lambda = 100;   // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 100;   // Inverse temperature
+  int norb      = 2;     // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Random scalar- and matrix-valued DLR coefficients
+  auto fc = nda::vector<double>(nda::rand(r) - 0.5);
+  auto gc = nda::vector<double>(nda::rand(r) - 0.5);
+  auto Fc = nda::array<dcomplex, 3>(r, norb, norb);
+  auto Gc = nda::array<dcomplex, 3>(r, norb, norb);
+  for (int k = 0; k < r; ++k) {
+    Fc(k, _, _) = nda::rand(norb, norb) - 0.5 + 1i * (nda::rand(norb, norb) - 0.5);
+    Gc(k, _, _) = nda::rand(norb, norb) - 0.5 + 1i * (nda::rand(norb, norb) - 0.5);
+  }
+
+  bool is_static = dispatch_rank(itops, [&](auto const &ops) {
+    EXPECT_EQ(ops.rank(), r);
+
+    // Transformations
+    auto f = itops.coefs2vals(fc);
+    auto F = itops.coefs2vals(Fc);
+    EXPECT_LT(max_element(abs(ops.coefs2vals(fc) - f)), 1e-13);
+    EXPECT_LT(max_element(abs(ops.coefs2vals(Fc) - F)), 1e-13);
+    EXPECT_LT(max_element(abs(ops.vals2coefs(f) - fc)), 1e-10);
+    EXPECT_LT(max_element(abs(ops.vals2coefs(F) - Fc)), 1e-10);
+    EXPECT_LT(max_element(abs(ops.vals2coefs(f, true) - itops.vals2coefs(f, true))), 1e-10);
+
+    // Non-contiguous input
+    auto Fb                  = nda::array<dcomplex, 3>(r, norb, norb + 1);
+    Fb(_, _, range(0, norb)) = F;
+    EXPECT_LT(max_element(abs(ops.vals2coefs(Fb(_, _, range(0, norb))) - Fc)), 1e-10);
+
+    // Convolutions
+    for (auto time_order : {false, true}) {
+      for (auto statistic : {Fermion, Boson}) {
+        auto h = itops.convolve(beta, statistic, fc, gc, time_order);
+        auto H = itops.convolve(beta, statistic, Fc, Gc, time_order);
+        EXPECT_LT(max_element(abs(ops.convolve(beta, statistic, fc, gc, time_order) - h)), 1e-11 * beta);
+        EXPECT_LT(max_element(abs(ops.convolve(beta, statistic, Fc, Gc, time_order) - H)), 1e-11 * beta);
+      }
+    }
+
+    return !std::is_same_v<std::decay_t<decltype(ops)>, imtime_ops>;
+  });
+
+  EXPECT_EQ(is_static, r >= static_rank_min && r <= static_rank_max);
+}
+
+/**
+* @brief Test fallback of dispatch_rank to imtime_ops, and rank mismatch
+*/
+TEST(static_imtime_ops, dispatch) {
+
+  double lambda = 100;   // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Rank outside of instantiated range
+  bool is_static = dispatch_rank<1, 2>(itops, [](auto const &ops) { return !std::is_same_v<std::decay_t<decltype(ops)>, imtime_ops>; });
+  EXPECT_FALSE(is_static);
+  EXPECT_TRUE(r > 2);
+
+  EXPECT_THROW(static_imtime_ops<2>{itops}, std::runtime_error);
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dlr_transform.cpp
+*
+* @brief Tests for dlr_transform class.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <nda/gtest_tools.hpp>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Test that fused transforms agree with going through DLR coefficients,
+* for scalar- and matrix-valued Green's functions, including the symmetrized
+* bosonic case
+*/
+TEST(dlr_transform, it2if_if2it) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000; // Inverse temperature
+  int norb    = 2;    // Orbital dimensions
+
+  auto ws = workspace();
+
+  for (auto [statistic, symmetrize] : {std::pair{Fermion, NONSYM}, std::pair{Boson, SYM}}) {
+
+    auto dlr_rf = build_dlr_rf(lambda, eps, symmetrize);
+    auto itops  = imtime_ops(lambda, dlr_rf, symmetrize);
+    auto ifops  = imfreq_ops(lambda, dlr_rf, statistic, symmetrize);
+    auto tr     = dlr_transform(beta, itops, ifops);
+
+    int r    = itops.rank();
+    int niom = ifops.get_ifnodes().size();
+
+    // Real matrix-valued G given by random DLR coefficients
+    auto gc = nda::array<double, 3>(r, norb, norb);
+    for (int k = 0; k < r; ++k) { gc(k, _, _) = nda::rand(norb, norb) - 0.5; }
+    auto git = itops.coefs2vals(gc);
+
+    // Imaginary time -> imaginary frequency
+    auto gif = tr.it2if(git);
+    EXPECT_LT(max_element(abs(gif - ifops.coefs2vals(beta, itops.vals2coefs(git)))), 1e-10 * max_element(abs(gif)));
+
+    auto gif_s = tr.it2if(nda::vector<double>(git(_, 0, 1)));
+    EXPECT_LT(max_element(abs(gif_s - gif(_, 0, 1))), 1e-14 * max_element(abs(gif)));
+
+    // Imaginary frequency -> imaginary time, into complex and real arrays
+    auto git_z = nda::array<dcomplex, 3>(r, norb, norb);
+    auto git_r = nda::array<double, 3>(r, norb, norb);
+    tr.if2it_into(gif, git_z, ws);
+    tr.if2it_into(gif, git_r, ws);
+    EXPECT_LT(max_element(abs(git_z - itops.coefs2vals(ifops.vals2coefs(beta, gif)))), 1e-10 * max_element(abs(git)));
+    EXPECT_LT(max_element(abs(git_r - git)), 1e-10 * max_element(abs(git)));
+
+    EXPECT_EQ(tr.get_it2if().shape(), (std::array<long, 2>{niom, r}));
+  }
+}
@@ -384,3 +384,247 @@ TEST(dyson_it, dyson_bethe_fpi) {
   EXPECT_LT(errl2, eps);
   std::cout << fmt::format("L^2 err = {:e}, L^inf err = {:e}\n", errl2, errlinf);
 }
+
+/**
+* @brief Compare iterative solution of Dyson equation by GMRES with direct
+* solution, with and without a preconditioner, for a matrix-valued Green's
+* function
+*
+* The problem is the same as in dyson_vs_ed_real. A preconditioner is formed
+* from a perturbed self-energy, to mimic reuse of a factorization from a
+* previous iteration of a self-consistent loop.
+*/
+TEST(dyson_it, dyson_iterative) {
+
+  // Set problem parameters
+  double beta = 100; // Inverse temperature
+  int n       = 3;   // Number of sites for original Hamiltonian
+  int norb    = 2;   // Number of sites for reduced Hamiltonian
+
+  // Set DLR parameters
+  double lambda = 100;
+  double eps    = 1.0e-14;
+
+  // Get random nxn Hamiltonian w/ eigenvalues in [-1 1]
+  auto a         = nda::matrix<double>(nda::rand<double>(std::array<int, 2>({n, n}))); // Random matrix
+  a              = (a + transpose(a)) / 2;                                             // Make symmetric
+  auto [eval, u] = nda::linalg::eigenelements(a);                                      // Random orthogonal matrix
+  eval           = -1 + 2 * nda::rand<double>(std::array<int, 1>({n}));                // Random eigenvalues in [-1,1]
+  auto h         = matmul(matmul(u, nda::diag(eval)), transpose(conj(u)));             // Random symmetric matrix
+
+  // Get DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Get self-energy
+  auto sig = nda::array<double, 3>(r, norb, norb);
+  auto g33 = free_gf(beta, itops, real(h(n - 1, n - 1)));
+  for (int i = 0; i < r; i++) {
+    for (int j = 0; j < norb; j++) {
+      for (int k = 0; k < norb; k++) { sig(i, j, k) = h(j, n - 1) * g33(i) * h(k, n - 1); }
+    }
+  }
+
+  auto dys = dyson_it(beta, itops, h(range(norb), range(norb)));
+  auto g   = dys.solve(sig); // Direct solution
+
+  // Unpreconditioned solve, w/ free Green's function as initial guess
+  auto [g1, niter1, resid1] = dys.solve_iterative(sig, 1e-13);
+  EXPECT_LT(resid1, 1e-13);
+  EXPECT_LT(max_element(abs(g1 - g)), 1e-12);
+
+  // Preconditioned solve w/ stale preconditioner
+  dys.set_preconditioner(make_regular(0.9 * sig));
+  auto [g2, niter2, resid2] = dys.solve_iterative(sig, 1e-13);
+  EXPECT_LT(resid2, 1e-13);
+  EXPECT_LT(max_element(abs(g2 - g)), 1e-12);
+  EXPECT_LT(niter2, niter1);
+
+  // Warm start from converged solution
+  auto [g3, niter3, resid3] = dys.solve_iterative(sig, g2, 1e-13);
+  EXPECT_LE(niter3, 1);
+  EXPECT_LT(max_element(abs(g3 - g)), 1e-12);
+
+  // Complex self-energy with real preconditioner
+  auto sigz                 = nda::array<dcomplex, 3>(sig);
+  auto [g4, niter4, resid4] = dys.solve_iterative(sigz, 1e-13);
+  EXPECT_LT(max_element(abs(g4 - g)), 1e-12);
+
+  std::cout << fmt::format("GMRES iterations: {} (unpreconditioned), {} (preconditioned)\n", niter1, niter2);
+}
+
+/**
+* @brief Compare mixed-precision solution of Dyson equation with direct
+* solution, for a matrix-valued Green's function
+*
+* The problem is the same as in dyson_vs_ed_real.
+*/
+TEST(dyson_it, dyson_mixed) {
+
+  // Set problem parameters
+  double beta = 100; // Inverse temperature
+  int n       = 3;   // Number of sites for original Hamiltonian
+  int norb    = 2;   // Number of sites for reduced Hamiltonian
+
+  // Set DLR parameters
+  double lambda = 100;
+  double eps    = 1.0e-14;
+
+  // Get random nxn Hamiltonian w/ eigenvalues in [-1 1]
+  auto a         = nda::matrix<double>(nda::rand<double>(std::array<int, 2>({n, n}))); // Random matrix
+  a              = (a + transpose(a)) / 2;                                             // Make symmetric
+  auto [eval, u] = nda::linalg::eigenelements(a);                                      // Random orthogonal matrix
+  eval           = -1 + 2 * nda::rand<double>(std::array<int, 1>({n}));                // Random eigenvalues in [-1,1]
+  auto h         = matmul(matmul(u, nda::diag(eval)), transpose(conj(u)));             // Random symmetric matrix
+
+  // Get DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Get self-energy
+  auto sig = nda::array<double, 3>(r, norb, norb);
+  auto g33 = free_gf(beta, itops, real(h(n - 1, n - 1)));
+  for (int i = 0; i < r; i++) {
+    for (int j = 0; j < norb; j++) {
+      for (int k = 0; k < norb; k++) { sig(i, j, k) = h(j, n - 1) * g33(i) * h(k, n - 1); }
+    }
+  }
+
+  auto dys = dyson_it(beta, itops, h(range(norb), range(norb)));
+  auto g   = dys.solve(sig); // Direct solution
+
+  // Mixed-precision solve
+  auto [g1, niter1, resid1] = dys.solve_mixed(sig, 1e-13);
+  EXPECT_LT(resid1, 1e-13);
+  EXPECT_LT(max_element(abs(g1 - g)), 1e-12);
+
+  // Complex self-energy
+  auto sigz                 = nda::array<dcomplex, 3>(sig);
+  auto [g2, niter2, resid2] = dys.solve_mixed(sigz, 1e-13);
+  EXPECT_LT(resid2, 1e-13);
+  EXPECT_LT(max_element(abs(g2 - g)), 1e-12);
+
+  // Single refinement step only reaches roughly single precision accuracy
+  auto [g3, niter3, resid3] = dys.solve_mixed(sig, 1e-13, 1);
+  EXPECT_EQ(niter3, 1);
+  EXPECT_GT(resid3, 1e-13);
+
+  std::cout << fmt::format("Mixed-precision refinement steps: {}\n", niter1);
+}
+
+/**
+* @brief Compare block-by-block solution of Dyson equation for block-diagonal
+* Hamiltonian and self-energy with dense solution
+*/
+TEST(dyson_it, dyson_block) {
+
+  // Set problem parameters
+  double beta = 100; // Inverse temperature
+  auto blocks = std::vector<int>{2, 1, 3};
+  int norb    = 6;
+
+  // Set DLR parameters
+  double lambda = 100;
+  double eps    = 1.0e-14;
+
+  // Get random block-diagonal symmetric Hamiltonian
+  auto h = nda::matrix<double>(norb, norb);
+  h      = 0;
+  int o  = 0;
+  for (int n : blocks) {
+    auto a                              = nda::matrix<double>(-1 + 2 * nda::rand<double>(std::array<int, 2>({n, n})));
+    h(range(o, o + n), range(o, o + n)) = (a + transpose(a)) / 4;
+    o += n;
+  }
+  EXPECT_EQ(find_blocks(h), blocks);
+
+  // Get DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  // Block-diagonal self-energy, given by a multiple of the free Green's
+  // function, and its blocks
+  auto sig  = make_regular(0.1 * free_gf(beta, itops, h));
+  auto sigb = split_blocks(sig, blocks);
+  EXPECT_LT(max_element(abs(sig - 0.1 * join_blocks(free_gf(beta, itops, h, blocks)))), 1e-14);
+
+  // Blockwise convolution agrees with dense convolution
+  auto sigc = itops.vals2coefs(sig);
+  auto h1   = join_blocks(itops.convolve(beta, Fermion, itops.vals2coefs(sigb), itops.vals2coefs(sigb)));
+  EXPECT_LT(max_element(abs(h1 - itops.convolve(beta, Fermion, sigc, sigc))), 1e-14);
+
+  // Blockwise Dyson solution agrees with dense solution
+  auto g  = dyson_it(beta, itops, h).solve(sig);
+  auto db = dyson_it_block(beta, itops, h);
+  EXPECT_EQ(db.get_blocks(), blocks);
+  EXPECT_LT(max_element(abs(db.solve(sig) - g)), 1e-13);
+
+  auto gb = db.solve(sigb);
+  EXPECT_LT(max_element(abs(join_blocks(gb) - g)), 1e-13);
+
+  // Blocks solved concurrently
+  EXPECT_LT(max_element(abs(join_blocks(db.solve(sigb, 3)) - join_blocks(gb))), 1e-15);
+}
+
+/**
+* @brief Compare solution of Dyson equation in imaginary frequency with
+* solution in imaginary time, for the 3x3 Hamiltonian problem of
+* dyson_vs_ed_real and for the Bethe lattice
+*/
+TEST(dyson_if, dyson_vs_dyson_it) {
+
+  // Set problem parameters
+  double beta = 100;     // Inverse temperature
+  double c    = 1.0 / 2; // Quarter-bandwidth (Bethe lattice)
+  int n       = 3;       // Number of sites for original Hamiltonian
+  int norb    = 2;       // Number of sites for reduced Hamiltonian
+
+  // Set DLR parameters
+  double lambda = 100;
+  double eps    = 1.0e-14;
+
+  // Get random nxn Hamiltonian w/ eigenvalues in [-1 1]
+  auto a         = nda::matrix<double>(nda::rand<double>(std::array<int, 2>({n, n}))); // Random matrix
+  a              = (a + transpose(a)) / 2;                                             // Make symmetric
+  auto [eval, u] = nda::linalg::eigenelements(a);                                      // Random orthogonal matrix
+  eval           = -1 + 2 * nda::rand<double>(std::array<int, 1>({n}));                // Random eigenvalues in [-1,1]
+  auto h         = matmul(matmul(u, nda::diag(eval)), transpose(conj(u)));             // Random symmetric matrix
+
+  // Get DLR imaginary time and imaginary frequency objects
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  auto ifops  = imfreq_ops(lambda, dlr_rf, Fermion);
+  int r       = itops.rank();
+
+  // Get self-energy
+  auto sig = nda::array<double, 3>(r, norb, norb);
+  auto g33 = free_gf(beta, itops, real(h(n - 1, n - 1)));
+  for (int i = 0; i < r; i++) {
+    for (int j = 0; j < norb; j++) {
+      for (int k = 0; k < norb; k++) { sig(i, j, k) = h(j, n - 1) * g33(i) * h(k, n - 1); }
+    }
+  }
+
+  // Matrix-valued Dyson equation
+  auto hred = nda::matrix<double>(h(range(norb), range(norb)));
+  auto g    = dyson_it(beta, itops, hred).solve(sig);
+  auto dysf = dyson_if(beta, ifops, hred);
+  auto gf   = dysf.solve_it(itops, sig, 2);
+  EXPECT_LT(max_element(abs(gf - g)), 1e-12);
+
+  // Solution in imaginary frequency agrees with transformed solution
+  auto gif = dysf.solve(dysf.it2if(itops, sig));
+  EXPECT_LT(max_element(abs(gif - dysf.it2if(itops, g))), 1e-12);
+
+  // Scalar-valued Dyson equation for Bethe lattice
+  auto gbethe = g_bethe(c, beta, itops.get_itnodes());
+  auto sigb   = nda::vector<double>(c * c * gbethe);
+  auto gb     = dyson_if(beta, ifops, 0.0).solve_it(itops, sigb);
+  EXPECT_LT(max_element(abs(gb - gbethe)), 1e-12);
+
+  // Bosonic imfreq_ops object is rejected
+  auto ifops_b = imfreq_ops(lambda, dlr_rf, Boson);
+  EXPECT_THROW((void)dyson_if(beta, ifops_b, hred), std::runtime_error);
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file dyson_mpi.cpp
+*
+* @brief Tests for distributed solution of Dyson equation in imaginary time.
+* Only built with Use_MPI=ON, and run on several MPI ranks.
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+#include <mpi.h>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Compare distributed and single-node Dyson solves for matrix-valued
+* real and complex self-energies, and for a scalar Hamiltonian
+*/
+TEST(dyson_it, solve_mpi) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 1000;  // Inverse temperature
+  int norb      = 3;     // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  // Hermitian Hamiltonian, and self-energy given by free Green's function of
+  // another Hamiltonian
+  auto h  = nda::matrix<double>(norb, norb);
+  auto h2 = nda::matrix<double>(norb, norb);
+  for (int i = 0; i < norb; ++i) {
+    for (int j = 0; j < norb; ++j) {
+      h(i, j)  = (i == j ? 0.1 * i : 0.2);
+      h2(i, j) = (i == j ? -0.3 * i : 0.1);
+    }
+  }
+  auto sig  = nda::array<double, 3>(0.1 * free_gf(beta, itops, h2));
+  auto sigz = nda::array<dcomplex, 3>((1.0 + 0.5i) * sig);
+
+  auto dys = dyson_it(beta, itops, h);
+
+  // Block size smaller than matrix dimension, so that blocks are distributed
+  // cyclically over the process grid
+  auto g  = dys.solve(sig, MPI_COMM_WORLD, 4);
+  auto gz = dys.solve(sigz, MPI_COMM_WORLD, 4);
+  EXPECT_LT(max_element(abs(g - dys.solve(sig))), 1e-12 * max_element(abs(g)));
+  EXPECT_LT(max_element(abs(gz - dys.solve(sigz))), 1e-12 * max_element(abs(gz)));
+
+  // Default block size, larger than matrix dimension
+  EXPECT_LT(max_element(abs(dys.solve(sig, MPI_COMM_WORLD) - dys.solve(sig))), 1e-12 * max_element(abs(g)));
+
+  // Scalar Hamiltonian
+  auto dyss = dyson_it(beta, itops, 0.3);
+  auto sigs = nda::vector<double>(sig(_, 0, 0));
+  auto gs   = dyss.solve(sigs, MPI_COMM_WORLD, 8);
+  EXPECT_LT(max_element(abs(gs - dyss.solve(sigs))), 1e-12 * max_element(abs(gs)));
+}
+
+int main(int argc, char **argv) {
+
+  MPI_Init(&argc, &argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+  MPI_Finalize();
+
+  return result;
+}
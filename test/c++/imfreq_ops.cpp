@@ -400,6 +400,89 @@ TEST(imfreq_ops, interp_matrix_sym_bos) {
   std::cout << fmt::format("Imag time: L^2 err = {:e}, L^inf err = {:e}\n", errl2, errlinf);
 }
 
+/**
+* @brief Test evaluation of DLR expansion on a large range of imaginary
+* frequencies, which uses the multipole expansion away from the DLR real
+* frequency support, against pointwise evaluation
+*/
+TEST(imfreq_ops, coefs2eval_grid) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000;  // Inverse temperature
+  int nmax    = 20000; // Evaluate on -nmax <= n < nmax
+  int norb    = 2;     // Orbital dimensions
+
+  auto n = nda::vector<int>(2 * nmax);
+  for (int i = 0; i < 2 * nmax; ++i) { n(i) = i - nmax; }
+
+  for (auto statistic : {Fermion, Boson}) {
+
+    auto dlr_rf = build_dlr_rf(lambda, eps);
+    auto ifops  = imfreq_ops(lambda, dlr_rf, statistic);
+
+    auto const &dlr_if = ifops.get_ifnodes();
+    auto g             = nda::array<dcomplex, 3>(ifops.rank(), norb, norb);
+    for (int i = 0; i < ifops.rank(); ++i) { g(i, _, _) = gfun(norb, beta, dlr_if(i), statistic); }
+    auto gc = ifops.vals2coefs(beta, g);
+
+    auto gn     = ifops.coefs2eval(beta, gc, n);
+    double err  = 0;
+    double gmax = 0;
+    for (int i = 0; i < 2 * nmax; ++i) {
+      err  = std::max(err, max_element(abs(gn(i, _, _) - ifops.coefs2eval(beta, gc, n(i)))));
+      gmax = std::max(gmax, max_element(abs(gn(i, _, _))));
+    }
+    EXPECT_LT(err, 1e-13 * gmax);
+
+    // Scalar-valued, real coefficients
+    auto gcs = nda::vector<double>(real(gc(_, 0, 0)));
+    auto gns = ifops.coefs2eval(gcs, n);
+    err      = 0;
+    for (int i = 0; i < 2 * nmax; ++i) { err = std::max(err, std::abs(gns(i) - ifops.coefs2eval(gcs, n(i)))); }
+    EXPECT_LT(err, 1e-13 * max_element(abs(gcs)));
+  }
+}
+
+/**
+* @brief Test that "into" variants with a workspace agree with the allocating
+* methods, including the symmetrized bosonic case (least squares fit)
+*/
+TEST(imfreq_ops, into) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000; // Inverse temperature
+  int norb    = 2;    // Orbital dimensions
+
+  auto ws = imfreq_workspace();
+
+  for (auto [statistic, symmetrize] : {std::pair{Fermion, NONSYM}, std::pair{Boson, SYM}}) {
+
+    auto dlr_rf = build_dlr_rf(lambda, eps, symmetrize);
+    auto ifops  = imfreq_ops(lambda, dlr_rf, statistic, symmetrize);
+
+    int r              = ifops.rank();
+    auto const &dlr_if = ifops.get_ifnodes();
+    int niom           = dlr_if.size();
+    auto g             = nda::array<dcomplex, 3>(niom, norb, norb);
+    for (int i = 0; i < niom; ++i) { g(i, _, _) = gfun(norb, beta, dlr_if(i), statistic); }
+
+    auto gc  = nda::array<dcomplex, 3>(r, norb, norb);
+    auto gv  = nda::array<dcomplex, 3>(niom, norb, norb);
+    auto gvr = nda::array<dcomplex, 3>(niom, norb, norb);
+    ifops.vals2coefs_into(g, gc, ws);
+    ifops.coefs2vals_into(gc, gv, ws);
+    ifops.coefs2vals_into(nda::array<double, 3>(real(gc)), gvr, ws); // Real coefficients
+
+    EXPECT_LT(max_element(abs(gc - ifops.vals2coefs(g))), 1e-12);
+    EXPECT_LT(max_element(abs(gv - ifops.coefs2vals(gc))), 1e-12);
+    EXPECT_LT(max_element(abs(gvr - ifops.coefs2vals(nda::array<double, 3>(real(gc))))), 1e-12);
+  }
+}
+
 TEST(dlr_imfreq, h5_rw) {
 
   double lambda  = 1000;    // DLR cutoff
@@ -435,3 +518,15 @@ TEST(dlr_imfreq, h5_rw) {
   EXPECT_EQ_ARRAY(ifops.get_if2cf_lu(), ifops_ref.get_if2cf_lu());
   EXPECT_EQ_ARRAY(ifops.get_if2cf_piv(), ifops_ref.get_if2cf_piv());
 }
+
+/**
+* @brief Test that a default-constructed imfreq_ops object has empty basis data
+*/
+TEST(imfreq_ops, default_constructed) {
+
+  auto ifops = imfreq_ops();
+  EXPECT_EQ(ifops.get_ifnodes().size(), 0);
+  EXPECT_EQ(ifops.get_rfnodes().size(), 0);
+  EXPECT_EQ(ifops.get_cf2if().size(), 0);
+  EXPECT_EQ(ifops.get_if2cf_piv().size(), 0);
+}
@@ -27,6 +27,9 @@
 #include <nda/gtest_tools.hpp>
 #include <fmt/format.h>
 
+#include <thread>
+#include <vector>
+
 using namespace cppdlr;
 using namespace nda;
 
@@ -295,6 +298,56 @@ TEST(imtime_ops, interp_scalar) {
   EXPECT_LT((abs(blas::dot(gc, kvec) - gtst)), 1e-14);
 }
 
+/**
+* @brief Test evaluation of DLR expansion on a grid of imaginary time points,
+* for equispaced grid (exponential recurrence) and scattered grid
+*/
+TEST(imtime_ops, eval_grid) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000;  // Inverse temperature
+  int ntst    = 10000; // # imag time test points
+  int norb    = 2;     // Orbital dimensions
+
+  // Get DLR frequencies and DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  // DLR coefficients of matrix-valued G
+  int r              = itops.rank();
+  auto const &dlr_it = itops.get_itnodes();
+  auto g             = nda::array<double, 3>(r, norb, norb);
+  for (int i = 0; i < r; ++i) { g(i, _, _) = gfun(norb, beta, dlr_it(i)); }
+  auto gc = itops.vals2coefs(g);
+
+  // Equispaced grid: evaluation matrix agrees with direct kernel evaluation
+  auto ttst = eqptsrel(ntst);
+  EXPECT_TRUE(is_eqptsrel(ttst));
+  EXPECT_LT(max_element(abs(itops.build_evalmat(ttst) - build_k_it(ttst, dlr_rf))), 1e-14);
+
+  // Scattered grid
+  auto tscat = nda::vector<double>(ntst);
+  for (int i = 0; i < ntst; ++i) { tscat(i) = sin(1000.0 * (i + 1)); } // Quick and dirty rand # gen on [-1,1]
+  EXPECT_FALSE(is_eqptsrel(tscat));
+
+  // Grid evaluation agrees with pointwise evaluation, for matrix- and
+  // scalar-valued G
+  for (auto const &t : {ttst, tscat}) {
+    auto gtst  = itops.coefs2eval(gc, t);
+    auto gtst0 = itops.coefs2eval(nda::vector<double>(gc(_, 0, 0)), t);
+    EXPECT_EQ(gtst.shape(), (std::array<long, 3>{ntst, norb, norb}));
+
+    double err = 0;
+    for (int i = 0; i < ntst; ++i) {
+      err = std::max(err, max_element(abs(gtst(i, _, _) - itops.coefs2eval(gc, t(i)))));
+      err = std::max(err, abs(gtst0(i) - gtst(i, 0, 0)));
+    }
+    EXPECT_LT(err, 1e-13);
+  }
+}
+
 /**
 * @brief Test DLR fitting for real matrix-valued Green's function
 */
@@ -536,6 +589,75 @@ TEST(imtime_ops, convolve_scalar_real) {
   std::cout << fmt::format("Time-ordered convolution: L^inf err = {:e}, L^2 err = {:e}\n", errtlinf, errtl2);
 }
 
+/**
+* @brief Test convolution of two real-valued bosonic Green's functions
+*
+* We use Green's functions f and g given by a single exponential, extended
+* periodically to t < 0, so that the result of the convolution is easy to
+* compute analytically. One of the exponentials has zero frequency.
+*/
+TEST(imtime_ops, convolve_scalar_real_bos) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-12; // DLR tolerance
+
+  double beta = 1000;  // Inverse temperature
+  int ntst    = 10000; // # imag time test points
+
+  std::cout << fmt::format("eps = {:e}, Lambda = {:e}\n", eps, lambda);
+
+  // Get DLR frequencies
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+
+  // Get DLR imaginary time object
+  auto itops = imtime_ops(lambda, dlr_rf);
+
+  // Sample Green's functions at DLR imaginary time nodes, for two choices of
+  // frequencies of f and g
+  int r              = itops.rank();
+  auto const &dlr_it = itops.get_itnodes();
+  auto ttst          = eqptsrel(ntst);
+
+  for (auto [omf, omg] : {std::pair{0.1234, -0.5678}, std::pair{0.0, 0.3456}}) {
+
+    auto f = nda::array<double, 1>(r);
+    auto g = nda::array<double, 1>(r);
+    for (int i = 0; i < r; ++i) { f(i) = k_it(dlr_it(i), omf, beta); };
+    for (int i = 0; i < r; ++i) { g(i) = k_it(dlr_it(i), omg, beta); };
+
+    // Get DLR coefficients of f and g
+    auto fc = itops.vals2coefs(f);
+    auto gc = itops.vals2coefs(g);
+
+    // Get convolution of f and g directly, and by first forming matrix of
+    // convolution by f and then applying it to g
+    auto h  = itops.convolve(beta, Boson, fc, gc);
+    auto h2 = itops.convolve(itops.convmat(beta, Boson, fc), g);
+    EXPECT_LT(max_element(abs(h - h2)), 1e-14);
+
+    // Time-ordered convolution does not depend on statistic
+    auto ht = itops.convolve(beta, Boson, fc, gc, TIME_ORDERED);
+    EXPECT_LT(max_element(abs(ht - itops.convolve(beta, Fermion, fc, gc, TIME_ORDERED))), 1e-14);
+
+    // Check error of convolution
+    auto hc = itops.vals2coefs(h); // DLR coefficients of h
+
+    double tauf = std::tanh(beta * omf / 2), taug = std::tanh(beta * omg / 2);
+    double gtru = 0, gtst = 0, errlinf = 0, errl2 = 0;
+    for (int i = 0; i < ntst; ++i) {
+      gtru    = (taug * k_it(ttst(i), omf, beta) - tauf * k_it(ttst(i), omg, beta)) / (omf - omg); // Exact result
+      gtst    = itops.coefs2eval(hc, ttst(i));
+      errlinf = std::max(errlinf, abs(gtru - gtst));
+      errl2 += pow(gtru - gtst, 2);
+    }
+    errl2 = sqrt(errl2 / ntst);
+
+    EXPECT_LT(errlinf, 25 * eps);
+    EXPECT_LT(errl2, 4 * eps);
+    std::cout << fmt::format("Bosonic convolution: L^inf err = {:e}, L^2 err = {:e}\n", errlinf, errl2);
+  }
+}
+
 /**
 * @brief Test convolution and time-ordered convolution of two complex-valued
 * Green's functions
@@ -1106,6 +1228,53 @@ TEST(imtime_ops, innerprod) {
   EXPECT_LT(err, eps);
 }
 
+/**
+* @brief Test Gram matrix of a list of DLR expansions against pairwise inner
+* products
+*/
+TEST(imtime_ops, innerprod_matrix) {
+
+  double lambda = 200;   // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 100; // Inverse temperature
+  int norb    = 2;   // Orbital dimensions
+  int n       = 4;   // Number of Green's functions
+
+  // Get DLR frequencies
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  int r       = dlr_rf.size();
+
+  // Get DLR imaginary time object
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  auto dlr_it = itops.get_itnodes();
+
+  // Matrix-valued Green's functions c_a * exp(-tau * om_a)/(1+exp(-beta * om_a))
+  auto fc  = std::vector<nda::array<dcomplex, 3>>();
+  auto fcs = std::vector<nda::vector<dcomplex>>(); // (0,0) components
+  for (int a = 0; a < n; ++a) {
+    auto f = nda::array<dcomplex, 3>(r, norb, norb);
+    for (int i = 0; i < r; ++i) {
+      for (int k = 0; k < norb; ++k) {
+        for (int l = 0; l < norb; ++l) { f(i, k, l) = k_it(dlr_it(i), 0.1 * (a + 1) - 0.2, beta) * (0.1 * (a + k + 1) + 0.3i * (l - a)); }
+      }
+    }
+    fc.push_back(itops.vals2coefs(f));
+    fcs.push_back(fc.back()(_, 0, 0));
+  }
+
+  // Compare with pairwise inner products
+  auto ipmat  = itops.innerprod_matrix(fc);
+  auto ipmats = itops.innerprod_matrix(fcs);
+  EXPECT_EQ(ipmat.shape(), (std::array<long, 2>{n, n}));
+  for (int a = 0; a < n; ++a) {
+    for (int b = 0; b < n; ++b) {
+      EXPECT_LT(std::abs(ipmat(a, b) - itops.innerprod(fc[a], fc[b])), 1e-13);
+      EXPECT_LT(std::abs(ipmats(a, b) - itops.innerprod(fcs[a], fcs[b])), 1e-13);
+    }
+  }
+}
+
 /**
 * @brief Test transpose of DLR values -> coefficients transformation
 */
@@ -1188,3 +1357,394 @@ TEST(dlr_imtime, h5_rw) {
   EXPECT_EQ_ARRAY(itops.get_it2cf_zlu(), itops_ref.get_it2cf_zlu());
   EXPECT_EQ_ARRAY(itops.get_it2cf_piv(), itops_ref.get_it2cf_piv());
 }
+
+/**
+* @brief Test reading imtime_ops from a file in the format of earlier versions,
+* which also contains a complex copy of the LU factors
+*/
+TEST(dlr_imtime, h5_read_legacy) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  auto filename = "data_imtime_ops_h5_read_legacy.h5";
+  auto name     = "itops";
+
+  {
+    h5::file file(filename, 'w');
+    h5::group gr = h5::group(file).create_group(name);
+    write_hdf5_format_as_string(gr, "cppdlr::imtime_ops");
+    h5::write(gr, "lambda", itops.lambda());
+    h5::write(gr, "rf", itops.get_rfnodes());
+    h5::write(gr, "it", itops.get_itnodes());
+    h5::write(gr, "cf2it", itops.get_cf2it());
+    h5::write(gr, "it2cf_lu", itops.get_it2cf_lu());
+    h5::write(gr, "it2cf_zlu", itops.get_it2cf_zlu());
+    h5::write(gr, "it2cf_piv", itops.get_it2cf_piv());
+  }
+
+  imtime_ops itops_ref;
+  {
+    h5::file file(filename, 'r');
+    h5::read(file, name, itops_ref);
+  }
+
+  EXPECT_EQ_ARRAY(itops.get_cf2it(), itops_ref.get_cf2it());
+  EXPECT_EQ_ARRAY(itops.get_it2cf_lu(), itops_ref.get_it2cf_lu());
+  EXPECT_EQ_ARRAY(itops.get_it2cf_piv(), itops_ref.get_it2cf_piv());
+}
+
+/**
+* @brief Test that complex values -> coefficients transformations, which use the
+* real LU factors on real and imaginary parts, agree with real transformations
+*/
+TEST(imtime_ops, complex_rhs) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000; // Inverse temperature
+  int norb    = 2;    // Orbital dimensions
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  auto gr = nda::array<double, 3>(r, norb, norb);
+  auto gi = nda::array<double, 3>(r, norb, norb);
+  for (int i = 0; i < r; ++i) {
+    gr(i, _, _) = gfun(norb, beta, itops.get_itnodes(i));
+    gi(i, _, _) = gfun(norb, 2 * beta, itops.get_itnodes(i));
+  }
+  auto g = nda::array<dcomplex, 3>(gr + 1i * gi);
+
+  for (bool transpose : {false, true}) {
+    auto gc     = itops.vals2coefs(g, transpose);
+    auto gc_ref = nda::array<dcomplex, 3>(itops.vals2coefs(gr, transpose) + 1i * itops.vals2coefs(gi, transpose));
+    EXPECT_LT(max_element(abs(gc - gc_ref)), 1e-14 * max_element(abs(gc)));
+  }
+
+  // Convolution matrix, which right-multiplies by values -> coefficients matrix
+  auto gc     = itops.vals2coefs(g);
+  auto cm     = itops.convmat(beta, Fermion, gc);
+  auto cm_ref = nda::matrix<dcomplex>(itops.convmat(beta, Fermion, itops.vals2coefs(gr)) + 1i * itops.convmat(beta, Fermion, itops.vals2coefs(gi)));
+  EXPECT_LT(max_element(abs(cm - cm_ref)), 1e-12 * max_element(abs(cm)));
+}
+
+/**
+* @brief Test that batched operations agree with looping over the
+* corresponding single Green's function operations
+*/
+TEST(imtime_ops, batch) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000; // Inverse temperature
+  int norb    = 2;    // Orbital dimensions
+  int nb      = 5;    // Batch size
+
+  // Get DLR frequencies and DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  int r              = itops.rank();
+  auto const &dlr_it = itops.get_itnodes();
+
+  // Batches of matrix-valued f and g (real), and of scalar-valued g (complex)
+  auto f  = nda::array<double, 4>(nb, r, norb, norb);
+  auto g  = nda::array<double, 4>(nb, r, norb, norb);
+  auto gz = nda::array<dcomplex, 2>(nb, r);
+  for (int b = 0; b < nb; ++b) {
+    for (int i = 0; i < r; ++i) {
+      f(b, i, _, _) = gfun(norb, (b + 1) * beta, dlr_it(i));
+      g(b, i, _, _) = gfun(norb, (b + 2) * beta, dlr_it(i));
+      gz(b, i)      = gfun(1, (b + 1) * beta, dlr_it(i))(0, 0) * (1.0 + (b + 1) * 1i);
+    }
+  }
+
+  auto fc  = itops.vals2coefs_batch(f);
+  auto gc  = itops.vals2coefs_batch(g);
+  auto gzc = itops.vals2coefs_batch(gz);
+  auto h   = itops.convolve_batch(beta, Fermion, fc, gc);
+  auto ht  = itops.convolve_batch(beta, Fermion, fc, gc, TIME_ORDERED);
+  auto hs  = itops.convolve_batch(beta, Fermion, nda::array<double, 2>(fc(_, _, 0, 0)), nda::array<double, 2>(gc(_, _, 0, 0)));
+  auto fv  = itops.coefs2vals_batch(fc);
+  auto fr  = itops.reflect_batch(f);
+
+  for (int b = 0; b < nb; ++b) {
+    auto fcb = nda::array<double, 3>(fc(b, _, _, _));
+    auto gcb = nda::array<double, 3>(gc(b, _, _, _));
+    EXPECT_LT(max_element(abs(fcb - itops.vals2coefs(nda::array<double, 3>(f(b, _, _, _))))), 1e-12);
+    EXPECT_LT(max_element(abs(gzc(b, _) - itops.vals2coefs(nda::vector<dcomplex>(gz(b, _))))), 1e-12);
+    EXPECT_LT(max_element(abs(fv(b, _, _, _) - f(b, _, _, _))), 1e-12);
+    EXPECT_LT(max_element(abs(fr(b, _, _, _) - itops.reflect(nda::array<double, 3>(f(b, _, _, _))))), 1e-12);
+    EXPECT_LT(max_element(abs(h(b, _, _, _) - itops.convolve(beta, Fermion, fcb, gcb))), 1e-12);
+    EXPECT_LT(max_element(abs(ht(b, _, _, _) - itops.convolve(beta, Fermion, fcb, gcb, TIME_ORDERED))), 1e-12);
+    EXPECT_LT(max_element(abs(hs(b, _) - itops.convolve(beta, Fermion, nda::vector<double>(fcb(_, 0, 0)), nda::vector<double>(gcb(_, 0, 0))))),
+              1e-12);
+  }
+}
+
+/**
+* @brief Test that "into" variants with a workspace agree with the allocating
+* methods, for real and complex Green's functions
+*/
+TEST(imtime_ops, into) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta = 1000; // Inverse temperature
+  int norb    = 2;    // Orbital dimensions
+
+  // Get DLR frequencies and DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  int r              = itops.rank();
+  auto const &dlr_it = itops.get_itnodes();
+
+  // Matrix-valued f and g, real and complex
+  auto f = nda::array<double, 3>(r, norb, norb);
+  auto g = nda::array<double, 3>(r, norb, norb);
+  for (int i = 0; i < r; ++i) {
+    f(i, _, _) = gfun(norb, beta, dlr_it(i));
+    g(i, _, _) = gfun(norb, 2 * beta, dlr_it(i));
+  }
+  auto fz = nda::array<dcomplex, 3>((1.0 + 1i) * f);
+  auto gz = nda::array<dcomplex, 3>((2.0 - 1i) * g);
+
+  auto ws = imtime_workspace();
+
+  // Run twice, so that second pass uses already allocated workspace
+  for (int pass = 0; pass < 2; ++pass) {
+
+    auto fc = nda::array<double, 3>(r, norb, norb);
+    auto gc = nda::array<double, 3>(r, norb, norb);
+    auto h  = nda::array<double, 3>(r, norb, norb);
+    itops.vals2coefs_into(f, fc, ws);
+    itops.vals2coefs_into(g, gc, ws);
+    itops.convolve_into(beta, Fermion, fc, gc, h, ws);
+    EXPECT_LT(max_element(abs(fc - itops.vals2coefs(f))), 1e-14);
+    EXPECT_LT(max_element(abs(h - itops.convolve(beta, Fermion, fc, gc))), 1e-12);
+
+    auto fzc = nda::array<dcomplex, 3>(r, norb, norb);
+    auto gzc = nda::array<dcomplex, 3>(r, norb, norb);
+    auto hz  = nda::array<dcomplex, 3>(r, norb, norb);
+    auto fzv = nda::array<dcomplex, 3>(r, norb, norb);
+    itops.vals2coefs_into(fz, fzc, ws);
+    itops.vals2coefs_into(gz, gzc, ws);
+    itops.convolve_into(beta, Fermion, fzc, gzc, hz, ws, TIME_ORDERED);
+    itops.coefs2vals_into(fzc, fzv);
+    EXPECT_LT(max_element(abs(fzc - itops.vals2coefs(fz))), 1e-14);
+    EXPECT_LT(max_element(abs(fzv - fz)), 1e-14);
+    EXPECT_LT(max_element(abs(hz - itops.convolve(beta, Fermion, fzc, gzc, TIME_ORDERED))), 1e-12);
+
+    // Scalar-valued
+    auto fs = nda::vector<double>(fc(_, 0, 0));
+    auto gs = nda::vector<double>(gc(_, 0, 0));
+    auto hs = nda::vector<double>(r);
+    itops.convolve_into(beta, Fermion, fs, gs, hs, ws);
+    EXPECT_LT(max_element(abs(hs - itops.convolve(beta, Fermion, fs, gs))), 1e-12);
+  }
+}
+
+/**
+* @brief Test that lazy initialization is thread-safe: several threads call
+* methods requiring initialization on the same const imtime_ops object
+*/
+TEST(imtime_ops, threadsafe_init) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  double beta  = 1000; // Inverse temperature
+  int nthreads = 8;    // # threads
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  int r              = itops.rank();
+  auto const &dlr_it = itops.get_itnodes();
+  auto g             = nda::vector<double>(r);
+  for (int i = 0; i < r; ++i) { g(i) = gfun(1, beta, dlr_it(i))(0, 0); }
+  auto gc = itops.vals2coefs(g);
+
+  // Reference results from a separate object, initialized eagerly
+  auto itops_ref = imtime_ops(lambda, dlr_rf);
+  itops_ref.precompute();
+  auto h_ref  = itops_ref.convolve(beta, Fermion, gc, gc);
+  auto ht_ref = itops_ref.convolve(beta, Fermion, gc, gc, TIME_ORDERED);
+  auto gr_ref = itops_ref.reflect(g);
+  auto ip_ref = itops_ref.innerprod(gc, gc);
+
+  // Concurrent first calls on shared object
+  auto const &itops_c = itops;
+  auto err            = std::vector<double>(nthreads, 0.0);
+  auto threads        = std::vector<std::thread>();
+  for (int k = 0; k < nthreads; ++k) {
+    threads.emplace_back([&, k] {
+      err[k] = std::max(err[k], max_element(abs(itops_c.convolve(beta, Fermion, gc, gc) - h_ref)));
+      err[k] = std::max(err[k], max_element(abs(itops_c.convolve(beta, Fermion, gc, gc, TIME_ORDERED) - ht_ref)));
+      err[k] = std::max(err[k], max_element(abs(itops_c.reflect(g) - gr_ref)));
+      err[k] = std::max(err[k], std::abs(itops_c.innerprod(gc, gc) - ip_ref));
+    });
+  }
+  for (auto &t : threads) { t.join(); }
+
+  for (int k = 0; k < nthreads; ++k) { EXPECT_EQ(err[k], 0.0); }
+}
+
+/**
+* @brief Test that copies of imtime_ops and imfreq_ops share their basis data,
+* including lazily initialized matrices
+*/
+TEST(imtime_ops, shared_basis) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  auto ifops  = imfreq_ops(lambda, dlr_rf, Fermion);
+
+  auto itops_copy = itops;
+  auto ifops_copy = ifops;
+  EXPECT_EQ(itops_copy.get_cf2it().data(), itops.get_cf2it().data());
+  EXPECT_EQ(itops_copy.get_it2cf_lu().data(), itops.get_it2cf_lu().data());
+  EXPECT_EQ(ifops_copy.get_cf2if().data(), ifops.get_cf2if().data());
+
+  // Lazily initialized matrix built through one copy is seen by the other
+  EXPECT_EQ(itops_copy.get_ipmat().data(), itops.get_ipmat().data());
+
+  // Copy outlives original
+  auto itops_tmp = imtime_ops(lambda, dlr_rf);
+  auto cf2it     = nda::matrix<double>(itops_tmp.get_cf2it());
+  itops_copy     = itops_tmp;
+  itops_tmp      = itops;
+  EXPECT_EQ(max_element(abs(itops_copy.get_cf2it() - cf2it)), 0);
+}
+
+/**
+* @brief Test that blocks of rows of convolution matrices, built independently,
+* agree with the corresponding rows of the full matrices
+*/
+TEST(imtime_ops, convmat_rows) {
+
+  double lambda = 1000;  // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+  double beta   = 1000;  // Inverse temperature
+  int norb1     = 2;     // Orbital dimensions
+  int norb2     = 3;
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  // Random complex matrix-valued and real scalar-valued coefficients
+  auto fc = nda::array<dcomplex, 3>(r, norb1, norb2);
+  for (int k = 0; k < r; ++k) { fc(k, _, _) = nda::rand(norb1, norb2) - 0.5 + 1i * (nda::rand(norb1, norb2) - 0.5); }
+  auto fcs = nda::vector<double>(nda::rand(r) - 0.5);
+
+  int k0 = r / 3, k1 = r / 2; // Row block
+
+  for (bool time_order : {false, true}) {
+    for (auto statistic : {Fermion, Boson}) {
+      auto fconv  = itops.convmat(beta, statistic, fc, time_order);
+      auto fconvr = itops.convmat_rows(beta, statistic, fc, nda::range(k0, k1), time_order);
+      EXPECT_EQ(fconvr.shape(), (std::array<long, 2>{(k1 - k0) * norb1, r * norb2}));
+      EXPECT_LT(max_element(abs(fconvr - fconv(nda::range(k0 * norb1, k1 * norb1), _))), 1e-12 * max_element(abs(fconv)));
+
+      auto fconvs  = itops.convmat(beta, statistic, fcs, time_order);
+      auto fconvsr = itops.convmat_rows(beta, statistic, fcs, nda::range(k0, k1), time_order);
+      EXPECT_LT(max_element(abs(fconvsr - fconvs(nda::range(k0, k1), _))), 1e-12 * max_element(abs(fconvs)));
+    }
+  }
+
+  EXPECT_THROW(itops.convmat_rows(beta, Fermion, fcs, nda::range(0, r + 1)), std::runtime_error);
+}
+
+/**
+* @brief Test that a default-constructed imtime_ops object has empty basis data
+*/
+TEST(imtime_ops, default_constructed) {
+
+  auto itops = imtime_ops();
+  EXPECT_EQ(itops.get_itnodes().size(), 0);
+  EXPECT_EQ(itops.get_rfnodes().size(), 0);
+  EXPECT_EQ(itops.get_cf2it().size(), 0);
+  EXPECT_EQ(itops.get_it2cf_piv().size(), 0);
+
+  // Copies share the (empty) basis data
+  auto itops2 = itops;
+  EXPECT_EQ(itops2.get_itnodes().size(), 0);
+}
+
+/**
+* @brief Test single precision transformations and convolutions against
+* double precision, for a DLR tolerance accessible in single precision
+*/
+TEST(imtime_ops, single_precision) {
+
+  double lambda = 100;  // DLR cutoff
+  double eps    = 1e-6; // DLR tolerance
+
+  double beta = 100; // Inverse temperature
+  int norb    = 2;   // Orbital dimensions
+
+  // Get DLR frequencies and DLR imaginary time object
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+
+  int r              = itops.rank();
+  auto const &dlr_it = itops.get_itnodes();
+
+  // Matrix-valued f and g, real and complex, and single precision copies
+  auto f = nda::array<double, 3>(r, norb, norb);
+  auto g = nda::array<double, 3>(r, norb, norb);
+  for (int i = 0; i < r; ++i) {
+    f(i, _, _) = gfun(norb, beta, dlr_it(i));
+    g(i, _, _) = gfun(norb, 2 * beta, dlr_it(i));
+  }
+  auto fz = nda::array<dcomplex, 3>((1.0 + 1i) * f);
+  auto gz = nda::array<dcomplex, 3>((2.0 - 1i) * g);
+
+  auto fs  = nda::array<float, 3>(f);
+  auto gs  = nda::array<float, 3>(g);
+  auto fzs = nda::array<std::complex<float>, 3>(fz);
+  auto gzs = nda::array<std::complex<float>, 3>(gz);
+
+  double tol = 1e-5; // Relative tolerance of single precision results
+
+  // Transformations
+  auto fc  = itops.vals2coefs(f);
+  auto fzc = itops.vals2coefs(fz);
+  auto fcs = itops.vals2coefs(fs);
+  EXPECT_LT(max_element(abs(nda::array<double, 3>(fcs) - fc)), tol * max_element(abs(fc)));
+  EXPECT_LT(max_element(abs(nda::array<dcomplex, 3>(itops.vals2coefs(fzs)) - fzc)), tol * max_element(abs(fzc)));
+  EXPECT_LT(max_element(abs(nda::array<double, 3>(itops.vals2coefs(fs, true)) - itops.vals2coefs(f, true))),
+            tol * max_element(abs(itops.vals2coefs(f, true))));
+  EXPECT_LT(max_element(abs(nda::array<double, 3>(itops.coefs2vals(fcs)) - f)), tol * max_element(abs(f)));
+  EXPECT_LT(max_element(abs(nda::array<dcomplex, 3>(itops.coefs2vals(itops.vals2coefs(fzs))) - fz)), tol * max_element(abs(fz)));
+
+  // Matrix-valued convolutions
+  auto gc  = itops.vals2coefs(g);
+  auto gzc = itops.vals2coefs(gz);
+  auto h   = itops.convolve(beta, Fermion, fc, gc);
+  auto hz  = itops.convolve(beta, Fermion, fzc, gzc, TIME_ORDERED);
+  auto hs  = itops.convolve(beta, Fermion, fcs, itops.vals2coefs(gs));
+  auto hzs = itops.convolve(beta, Fermion, itops.vals2coefs(fzs), itops.vals2coefs(gzs), TIME_ORDERED);
+  EXPECT_LT(max_element(abs(nda::array<double, 3>(hs) - h)), tol * max_element(abs(h)));
+  EXPECT_LT(max_element(abs(nda::array<dcomplex, 3>(hzs) - hz)), tol * max_element(abs(hz)));
+
+  // Scalar-valued bosonic convolution
+  auto fc0 = nda::vector<double>(fc(_, 0, 0));
+  auto gc0 = nda::vector<double>(gc(_, 0, 0));
+  auto h0  = itops.convolve(beta, Boson, fc0, gc0);
+  auto h0s = itops.convolve(beta, Boson, nda::vector<float>(fc0), nda::vector<float>(gc0));
+  EXPECT_LT(max_element(abs(nda::vector<double>(h0s) - h0)), tol * max_element(abs(h0)));
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 Simons Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Authors: Jason Kaye
+
+/**
+* @file instrument.cpp
+*
+* @brief Tests for instrumentation of DLR operations
+*/
+
+#include <gtest/gtest.h>
+#include <nda/nda.hpp>
+#include <cppdlr/cppdlr.hpp>
+
+#include <sstream>
+
+using namespace cppdlr;
+using namespace nda;
+
+/**
+* @brief Check that instrumented operations are recorded if and only if
+* instrumentation is enabled, and that statistics can be written out
+*/
+TEST(instrument, registry) {
+
+  double lambda = 100;   // DLR cutoff
+  double eps    = 1e-10; // DLR tolerance
+
+  auto &reg = instrument::registry::instance();
+  reg.reset();
+
+  auto dlr_rf = build_dlr_rf(lambda, eps);
+  auto itops  = imtime_ops(lambda, dlr_rf);
+  int r       = itops.rank();
+
+  auto g = nda::vector<double>(r);
+  g      = 1;
+  for (int i = 0; i < 3; ++i) { itops.vals2coefs(g); }
+  itops.convolve(1.0, Fermion, g, g);
+
+  auto stats = reg.snapshot();
+  if constexpr (instrument::enabled) {
+    EXPECT_EQ(stats.at("build_dlr_rf").calls, 1);
+    EXPECT_EQ(stats.at("imtime_ops::vals2coefs").calls, 3);
+    EXPECT_EQ(stats.at("imtime_ops::convolve").calls, 1);
+    EXPECT_EQ(stats.at("imtime_ops::convolve_init").calls, 1);
+    EXPECT_GT(stats.at("imtime_ops::vals2coefs").flops, 0);
+    EXPECT_GE(stats.at("imtime_ops::vals2coefs").seconds, 0);
+  } else {
+    EXPECT_TRUE(stats.empty());
+  }
+
+  // JSON output contains one member per recorded operation
+  std::ostringstream os;
+  reg.write_json(os);
+  EXPECT_EQ(os.str().find("imtime_ops::vals2coefs") != std::string::npos, instrument::enabled);
+
+  // HDF5 output
+  auto file = h5::file("instrument.h5", 'w');
+  h5_write(file, "stats", reg);
+
+  reg.reset();
+  EXPECT_TRUE(reg.snapshot().empty());
+}
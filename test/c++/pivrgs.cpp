@@ -179,3 +179,116 @@ TEST(pivrgs, pivrgs_cplx) {
   EXPECT_EQ(pivthin, arange(r));
   EXPECT_LE(frobenius_norm(q - qthin), 1e-14);
 }
+
+/**
+ * Test blocked pivoted reorthogonalized Gram-Schmidt functions against their
+ * unblocked counterparts, using a small block size so that several block
+ * updates occur
+ */
+TEST(pivrgs, pivrgs_blocked) {
+
+  auto _ = nda::range::all;
+
+  // Matrix size, rank cutoff tolerance, and block size
+  int m      = 50;
+  int n      = 40;
+  double eps = 1e-6;
+  int nb     = 4;
+
+  // Generate random numerically low rank mxn matrix with singular values
+  // 2^{-k}, as above
+  auto [u, norms1, piv1] = pivrgs(nda::matrix<double>::rand(m, m), 1e-100);
+  auto [v, norms2, piv2] = pivrgs(nda::matrix<double>::rand(n, n), 1e-100);
+  for (int i = 0; i < n; ++i) { v(i, _) *= pow(2.0, -i); }
+  auto a = nda::matrix<double>(u(_, range(n)) * v);
+
+  // Standard version: identical pivots, and identical basis to near double
+  // precision
+  auto [q, norms, piv]    = pivrgs(a, eps);
+  auto [qb, normsb, pivb] = pivrgs_blocked(a, eps, nb);
+  int r                   = norms.size();
+
+  EXPECT_EQ(normsb.size(), r);
+  EXPECT_EQ(pivb, piv);
+  EXPECT_LE(frobenius_norm(eye<double>(r) - qb * transpose(qb)), 1e-14);
+  EXPECT_LE(frobenius_norm(q - qb), 1e-12);
+
+  // Full rank matrix
+  auto [qf, normsf, pivf] = pivrgs_blocked(u, 1e-100, nb);
+  EXPECT_EQ(qf.shape(), (std::array<long, 2>{m, m}));
+  EXPECT_LE(frobenius_norm(eye<double>(m) - transpose(qf) * qf), 1e-14);
+
+  // Symmetrized version with tolerance
+  auto [qs, normss, pivs]    = pivrgs_sym(a, eps);
+  auto [qsb, normssb, pivsb] = pivrgs_sym_blocked(a, eps, nb);
+  int rs                     = normss.size();
+
+  EXPECT_EQ(normssb.size(), rs);
+  EXPECT_EQ(pivsb, pivs);
+  EXPECT_LE(frobenius_norm(qs - qsb), 1e-12);
+
+  // Symmetrized version with specified rank, for even and odd row dimension
+  for (int mm : {m, m - 1}) {
+    int rr  = (mm % 2 == 0 ? 20 : 21);
+    auto aa = nda::matrix<double>(a(range(mm), _));
+
+    auto [qr, normsr, pivr]    = pivrgs_sym(aa, rr);
+    auto [qrb, normsrb, pivrb] = pivrgs_sym_blocked(aa, rr, nb);
+
+    EXPECT_EQ(pivrb.size(), rr);
+    EXPECT_EQ(pivrb, pivr);
+    EXPECT_LE(frobenius_norm(qr - qrb), 1e-12);
+  }
+
+  // Block size smaller than symmetrized pivot group
+  auto [qs1, normss1, pivs1] = pivrgs_sym_blocked(a, eps, 1);
+  EXPECT_EQ(pivs1, pivs);
+  EXPECT_LE(frobenius_norm(qs - qs1), 1e-12);
+
+  // Invalid block size
+  EXPECT_THROW(pivrgs_blocked(a, eps, 0), std::runtime_error);
+}
+
+/**
+* @brief Test blocked pivoted Gram-Schmidt with seed rows selected first
+*/
+TEST(pivrgs, pivrgs_blocked_seeded) {
+
+  auto _ = nda::range::all;
+
+  // Matrix size, rank cutoff tolerance, block size, and # seed rows
+  int m      = 50;
+  int n      = 40;
+  double eps = 1e-6;
+  int nb     = 4;
+  int nseed  = 5;
+
+  // Random numerically low rank mxn matrix, as above
+  auto [u, norms1, piv1] = pivrgs(nda::matrix<double>::rand(m, m), 1e-100);
+  auto [v, norms2, piv2] = pivrgs(nda::matrix<double>::rand(n, n), 1e-100);
+  for (int i = 0; i < n; ++i) { v(i, _) *= pow(2.0, -i); }
+  auto a = nda::matrix<double>(u(_, range(n)) * v);
+
+  // No seed rows: same as unseeded version
+  auto [qb, normsb, pivb] = pivrgs_blocked(a, eps, nb);
+  auto [q0, norms0, piv0] = pivrgs_blocked_seeded(a, eps, 0, nb);
+  EXPECT_EQ(piv0, pivb);
+  EXPECT_LE(frobenius_norm(q0 - qb), 1e-12);
+
+  // Seed rows are selected first, and basis remains orthonormal
+  auto [q, norms, piv] = pivrgs_blocked_seeded(a, eps, nseed, nb);
+  int r                = norms.size();
+  for (int i = 0; i < nseed; ++i) { EXPECT_EQ(piv(i), i); }
+  EXPECT_LE(frobenius_norm(eye<double>(r) - q * transpose(q)), 1e-14);
+  EXPECT_GE(r, normsb.size());
+  EXPECT_LE(r, normsb.size() + nseed);
+
+  // Seed rows lie in span of basis
+  auto s = nda::matrix<double>(a(range(nseed), _));
+  EXPECT_LE(frobenius_norm(s - s * transpose(q) * q), 1e-14 * frobenius_norm(s));
+
+  // Linearly dependent seed rows
+  auto ad  = nda::matrix<double>(a);
+  ad(1, _) = ad(0, _);
+  EXPECT_THROW(pivrgs_blocked_seeded(ad, eps, 2, nb), std::runtime_error);
+}